@@ -0,0 +1,301 @@
+/*
+ * CPU/NUMA thread placement from sysfs topology. See MT25190_Affinity.h.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <dirent.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+
+#include "MT25190_Affinity.h"
+
+#define MAX_CPUS 1024
+
+typedef struct {
+    int cpu;
+    int node;
+    int package;
+    int core;
+    int sibling;    // 0 for the first hardware thread of its core
+} CpuInfo;
+
+static CpuInfo topology[MAX_CPUS];
+static int num_cpus;
+static int process_role = AFFINITY_SERVER;
+static char policy_name[32] = "none";
+static int sequence[2 * MAX_CPUS];  // CPU order; pair i = entries 2i, 2i+1
+static int sequence_len;            // 0: placement disabled
+static int next_index;
+
+static int read_int(const char *path, int fallback) {
+    FILE *f = fopen(path, "r");
+    if (!f) return fallback;
+    int value;
+    if (fscanf(f, "%d", &value) != 1) value = fallback;
+    fclose(f);
+    return value;
+}
+
+/*
+ * parse_cpu_list: Parses "0-3,8,10-11" (sysfs and --affinity format)
+ * Returns the number of CPUs stored, or -1 on a malformed list.
+ */
+static int parse_cpu_list(const char *s, int *out, int max) {
+    int n = 0;
+    while (*s && *s != '\n') {
+        char *end;
+        long lo = strtol(s, &end, 10);
+        if (end == s || lo < 0) return -1;
+        long hi = lo;
+        s = end;
+        if (*s == '-') {
+            hi = strtol(s + 1, &end, 10);
+            if (end == s + 1 || hi < lo) return -1;
+            s = end;
+        }
+        for (long c = lo; c <= hi && n < max; c++) out[n++] = (int)c;
+        if (*s == ',') s++;
+        else if (*s && *s != '\n') return -1;
+    }
+    return n;
+}
+
+static int read_cpu_list(const char *path, int *out, int max) {
+    char buf[4096];
+    FILE *f = fopen(path, "r");
+    if (!f) return -1;
+    int n = fgets(buf, sizeof(buf), f) ? parse_cpu_list(buf, out, max) : -1;
+    fclose(f);
+    return n;
+}
+
+/* cpu_node: NUMA node from the cpuN/nodeM sysfs link (0 without NUMA) */
+static int cpu_node(int cpu) {
+    char path[128];
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d", cpu);
+    DIR *dir = opendir(path);
+    if (!dir) return 0;
+    int node = 0;
+    struct dirent *de;
+    while ((de = readdir(dir)) != NULL) {
+        if (strncmp(de->d_name, "node", 4) == 0 && isdigit((unsigned char)de->d_name[4])) {
+            node = atoi(de->d_name + 4);
+            break;
+        }
+    }
+    closedir(dir);
+    return node;
+}
+
+static int compare_cpus(const void *a, const void *b) {
+    const CpuInfo *x = a, *y = b;
+    if (x->node != y->node) return x->node - y->node;
+    if (x->sibling != y->sibling) return x->sibling - y->sibling;   // Cores before SMT siblings
+    if (x->package != y->package) return x->package - y->package;
+    if (x->core != y->core) return x->core - y->core;
+    return x->cpu - y->cpu;
+}
+
+/*
+ * load_topology: Online CPUs with node/package/core/sibling, sorted so
+ * that each node lists one thread per physical core before any sibling
+ */
+static int load_topology(void) {
+    int online[MAX_CPUS];
+    int n = read_cpu_list("/sys/devices/system/cpu/online", online, MAX_CPUS);
+    if (n <= 0) {
+        long count = sysconf(_SC_NPROCESSORS_ONLN);
+        n = count > 0 ? (int)(count < MAX_CPUS ? count : MAX_CPUS) : 1;
+        for (int i = 0; i < n; i++) online[i] = i;
+    }
+
+    char path[160];
+    for (int i = 0; i < n; i++) {
+        CpuInfo *c = &topology[i];
+        c->cpu = online[i];
+        c->node = cpu_node(c->cpu);
+        snprintf(path, sizeof(path),
+                 "/sys/devices/system/cpu/cpu%d/topology/physical_package_id", c->cpu);
+        c->package = read_int(path, 0);
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/core_id", c->cpu);
+        c->core = read_int(path, c->cpu);
+
+        // Position among the core's hardware threads
+        int siblings[MAX_CPUS];
+        snprintf(path, sizeof(path),
+                 "/sys/devices/system/cpu/cpu%d/topology/thread_siblings_list", c->cpu);
+        int ns = read_cpu_list(path, siblings, MAX_CPUS);
+        c->sibling = 0;
+        for (int s = 0; s < ns; s++) {
+            if (siblings[s] == c->cpu) {
+                c->sibling = s;
+                break;
+            }
+        }
+    }
+    qsort(topology, n, sizeof(CpuInfo), compare_cpus);
+    num_cpus = n;
+    return n;
+}
+
+static const CpuInfo* find_cpu(int cpu) {
+    for (int i = 0; i < num_cpus; i++) {
+        if (topology[i].cpu == cpu) return &topology[i];
+    }
+    return NULL;
+}
+
+/* Per-node CPU queues in compact order, consumed round-robin */
+typedef struct {
+    int node;
+    int cpus[MAX_CPUS];
+    int count;
+    int cursor;
+} NodeQueue;
+
+static int build_node_queues(NodeQueue *queues) {
+    int nodes = 0;
+    for (int i = 0; i < num_cpus; i++) {
+        if (nodes == 0 || queues[nodes - 1].node != topology[i].node) {
+            queues[nodes].node = topology[i].node;
+            queues[nodes].count = 0;
+            queues[nodes].cursor = 0;
+            nodes++;
+        }
+        NodeQueue *q = &queues[nodes - 1];
+        q->cpus[q->count++] = topology[i].cpu;
+    }
+    return nodes;
+}
+
+static int queue_take(NodeQueue *q) {
+    int cpu = q->cpus[q->cursor];
+    q->cursor = (q->cursor + 1) % q->count;
+    return cpu;
+}
+
+/* same_core_sequence: [core thread 0, core thread 1] for every core */
+static int same_core_sequence(void) {
+    int len = 0;
+    for (int i = 0; i < num_cpus; i++) {
+        const CpuInfo *c = &topology[i];
+        if (c->sibling != 0) continue;
+        int partner = c->cpu;   // No SMT: both threads share the CPU
+        for (int j = 0; j < num_cpus; j++) {
+            const CpuInfo *s = &topology[j];
+            if (s->sibling == 1 && s->node == c->node && s->package == c->package &&
+                s->core == c->core) {
+                partner = s->cpu;
+                break;
+            }
+        }
+        sequence[len++] = c->cpu;
+        sequence[len++] = partner;
+    }
+    return len;
+}
+
+/*
+ * node_pair_sequence: One pair per CPU pair; pair p takes its server CPU
+ * from node p % nodes and its client CPU from node (p + client_offset) % nodes
+ */
+static int node_pair_sequence(int client_offset) {
+    static NodeQueue queues[MAX_CPUS];
+    int nodes = build_node_queues(queues);
+    int pairs = (num_cpus + 1) / 2;
+    int len = 0;
+    for (int p = 0; p < pairs; p++) {
+        sequence[len++] = queue_take(&queues[p % nodes]);
+        sequence[len++] = queue_take(&queues[(p + client_offset) % nodes]);
+    }
+    return len;
+}
+
+int affinity_configure(const char *policy, int role) {
+    process_role = role;
+    sequence_len = 0;
+    if (!policy || strcmp(policy, "none") == 0) return 0;
+
+    load_topology();
+    if (strcmp(policy, "compact") == 0) {
+        for (int i = 0; i < num_cpus; i++) sequence[i] = topology[i].cpu;
+        sequence_len = num_cpus;
+    } else if (strcmp(policy, "scatter") == 0) {
+        sequence_len = node_pair_sequence(0);
+    } else if (strcmp(policy, "same-core-pairs") == 0) {
+        sequence_len = same_core_sequence();
+    } else if (strcmp(policy, "cross-numa") == 0) {
+        sequence_len = node_pair_sequence(1);
+        if (num_cpus > 0 && topology[0].node == topology[num_cpus - 1].node) {
+            fprintf(stderr, "cross-numa: only one NUMA node, pairs stay node-local\n");
+        }
+    } else {
+        sequence_len = parse_cpu_list(policy, sequence, 2 * MAX_CPUS);
+        if (sequence_len <= 0) {
+            fprintf(stderr, "Unknown affinity '%s' (expected none|compact|scatter|"
+                            "same-core-pairs|cross-numa|CPU list)\n", policy);
+            sequence_len = 0;
+            return -1;
+        }
+        snprintf(policy_name, sizeof(policy_name), "list");
+        return 0;
+    }
+    snprintf(policy_name, sizeof(policy_name), "%s", policy);
+    return 0;
+}
+
+int affinity_cpu_for(int role, int index) {
+    if (sequence_len == 0) return -1;
+    return sequence[(2 * index + role) % sequence_len];
+}
+
+/*
+ * prefer_node: New pages of this thread come from 'node' when possible
+ * (MPOL_PREFERRED falls back to other nodes instead of failing)
+ */
+static void prefer_node(int node) {
+    unsigned long mask[16] = {0};
+    if (node < 0 || node >= (int)(sizeof(mask) * 8)) return;
+    mask[node / (8 * sizeof(unsigned long))] |= 1UL << (node % (8 * sizeof(unsigned long)));
+    syscall(SYS_set_mempolicy, MPOL_PREFERRED, mask, sizeof(mask) * 8);
+}
+
+int affinity_pin_next(void) {
+    if (sequence_len == 0) return -1;
+    return affinity_pin(__atomic_fetch_add(&next_index, 1, __ATOMIC_RELAXED));
+}
+
+int affinity_pin(int index) {
+    if (sequence_len == 0) return -1;
+    int cpu = affinity_cpu_for(process_role, index);
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (sched_setaffinity(0, sizeof(set), &set) < 0) {
+        perror("sched_setaffinity failed");
+        return -1;
+    }
+    const CpuInfo *info = find_cpu(cpu);
+    prefer_node(info ? info->node : cpu_node(cpu));
+    return cpu;
+}
+
+void affinity_format_metrics(int pairs, char *buf, size_t len) {
+    if (sequence_len == 0) {
+        snprintf(buf, len, "placement=none cpus=-");
+        return;
+    }
+    size_t used = (size_t)snprintf(buf, len, "placement=%s cpus=", policy_name);
+    for (int i = 0; i < pairs && used < len; i++) {
+        used += (size_t)snprintf(buf + used, len - used, "%s%d:%d", i ? "+" : "",
+                                 affinity_cpu_for(AFFINITY_SERVER, i),
+                                 affinity_cpu_for(AFFINITY_CLIENT, i));
+    }
+}
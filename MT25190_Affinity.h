@@ -0,0 +1,64 @@
+/*
+ * CPU/NUMA placement of server and client threads (--affinity=POLICY).
+ *
+ * Server thread i and client thread i form pair i (the i-th accepted
+ * connection talks to the i-th connecting client thread). Every policy is
+ * an ordered CPU sequence read from sysfs topology; pair i takes the
+ * entries 2i (server) and 2i+1 (client), wrapping around when there are
+ * more pairs than CPUs. Both processes derive the same sequence, so each
+ * side only needs its own role:
+ *
+ *   compact          pairs fill physical cores of node 0 first; the two
+ *                    threads of a pair sit on neighbouring cores (shared LLC)
+ *   scatter          pair i lives on node i % nodes, pairs spread out
+ *   same-core-pairs  server and client on the SMT siblings of one core
+ *                    (shared L1/L2; the same CPU when there is no SMT)
+ *   cross-numa       server on node k, client on node k+1 (remote memory)
+ *   0,2,4-7          explicit CPU sequence, consumed two per pair
+ *
+ * A pinned thread also prefers its CPU's NUMA node for new memory
+ * (set_mempolicy(MPOL_PREFERRED)), so buffers it allocates and touches
+ * afterwards are node-local.
+ */
+
+#ifndef MT25190_AFFINITY_H
+#define MT25190_AFFINITY_H
+
+#include <stddef.h>
+
+#define AFFINITY_SERVER 0
+#define AFFINITY_CLIENT 1
+
+/*
+ * affinity_configure: Selects the policy for this process's threads
+ * "none" (or NULL) leaves placement to the scheduler.
+ * Returns 0, or -1 after printing why the policy is invalid.
+ */
+int affinity_configure(const char *policy, int role);
+
+/*
+ * affinity_pin_next: Pins the calling thread to the next slot of this
+ * process's role (threads are numbered in call order, which follows the
+ * accept/connect order) and sets its preferred NUMA node.
+ * Call before allocating the thread's buffers. Returns the CPU, or -1 when
+ * placement is disabled or failed.
+ */
+int affinity_pin_next(void);
+
+/*
+ * affinity_pin: Pins the calling thread to the CPU of pair 'index' for this
+ * process's role (for threads whose pair number is known up front, such as
+ * epoll workers). Returns the CPU, or -1 when disabled or failed.
+ */
+int affinity_pin(int index);
+
+/* affinity_cpu_for: CPU of 'role' in pair 'index', -1 when disabled */
+int affinity_cpu_for(int role, int index);
+
+/*
+ * affinity_format_metrics: "placement=POLICY cpus=S0:C0+S1:C1+..." for the
+ * first 'pairs' pairs (server:client CPU), or "placement=none cpus=-"
+ */
+void affinity_format_metrics(int pairs, char *buf, size_t len);
+
+#endif /* MT25190_AFFINITY_H */
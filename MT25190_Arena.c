@@ -0,0 +1,57 @@
+/*
+ * Per-thread slab arena for fixed-size blocks. See MT25190_Arena.h.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "MT25190_Arena.h"
+
+/* Slab header, padded so block 0 starts on a cache line */
+struct ArenaSlab {
+    ArenaSlab *next;
+    char pad[ARENA_CACHELINE - sizeof(ArenaSlab*)];
+};
+
+void arena_init(MsgArena *a, size_t block_size) {
+    memset(a, 0, sizeof(*a));
+    // Every block must at least hold the free-list link
+    a->block_size = ARENA_ALIGN(block_size < sizeof(void*) ? sizeof(void*) : block_size);
+    a->slab_used = ARENA_SLAB_BLOCKS;   // No slab yet: the first alloc gets one
+}
+
+void* arena_alloc(MsgArena *a) {
+    a->allocs++;
+    if (a->free_list) {
+        void *block = a->free_list;
+        a->free_list = *(void**)block;
+        return block;
+    }
+    if (a->slab_used == ARENA_SLAB_BLOCKS) {
+        ArenaSlab *slab = aligned_alloc(ARENA_CACHELINE,
+                                        sizeof(ArenaSlab) + ARENA_SLAB_BLOCKS * a->block_size);
+        if (!slab) return NULL;
+        slab->next = a->slabs;
+        a->slabs = slab;
+        a->slab_used = 0;
+        a->slab_count++;
+    }
+    char *blocks = (char*)(a->slabs + 1);
+    return blocks + a->block_size * a->slab_used++;
+}
+
+void arena_free(MsgArena *a, void *block) {
+    if (!block) return;
+    *(void**)block = a->free_list;
+    a->free_list = block;
+}
+
+void arena_destroy(MsgArena *a) {
+    while (a->slabs) {
+        ArenaSlab *next = a->slabs->next;
+        free(a->slabs);
+        a->slabs = next;
+    }
+    a->free_list = NULL;
+    a->slab_used = ARENA_SLAB_BLOCKS;
+}
@@ -0,0 +1,58 @@
+/*
+ * Per-thread slab arena for fixed-size blocks (A1 --alloc=arena).
+ *
+ * The A1 Message is a header plus eight field buffers. With malloc() each
+ * of the nine pieces lands wherever the heap has room, so building and
+ * sending one message touches nine unrelated allocations (and their
+ * malloc chunk headers). The arena hands out one block per message
+ * instead, laid out contiguously and cache-line aligned:
+ *
+ *   block: [ Message | field1 | field2 | ... | field8 ]   (64 B boundaries)
+ *
+ *   slab:  [ block 0 ][ block 1 ] ... [ block N-1 ]        aligned_alloc(64)
+ *   free list: released blocks, reused LIFO (still warm in cache)
+ *
+ * Blocks are carved from slabs of ARENA_SLAB_BLOCKS blocks, released
+ * blocks go onto an intrusive free list and slabs are only returned to the
+ * heap by arena_destroy(). An arena is owned by one thread: no locking.
+ */
+
+#ifndef MT25190_ARENA_H
+#define MT25190_ARENA_H
+
+#include <stddef.h>
+
+#define ARENA_CACHELINE 64
+#define ARENA_SLAB_BLOCKS 16
+
+/* Round 'n' up to a whole number of cache lines */
+#define ARENA_ALIGN(n) (((n) + ARENA_CACHELINE - 1) & ~(size_t)(ARENA_CACHELINE - 1))
+
+typedef struct ArenaSlab ArenaSlab;
+
+typedef struct {
+    size_t block_size;      // Cache-line multiple
+    ArenaSlab *slabs;       // Every slab, for arena_destroy()
+    size_t slab_used;       // Blocks carved from the newest slab
+    void *free_list;        // Released blocks (first word links them)
+    long allocs;            // arena_alloc() calls
+    long slab_count;        // Slabs obtained from the heap
+} MsgArena;
+
+/* arena_init: Empty arena of 'block_size'-byte blocks (rounded to 64 B) */
+void arena_init(MsgArena *a, size_t block_size);
+
+/*
+ * arena_alloc: One cache-line-aligned block, from the free list if any,
+ * else carved from the newest slab (allocating a slab when full).
+ * Returns NULL with errno set on failure.
+ */
+void* arena_alloc(MsgArena *a);
+
+/* arena_free: Returns a block to the arena's free list */
+void arena_free(MsgArena *a, void *block);
+
+/* arena_destroy: Frees every slab; outstanding blocks become invalid */
+void arena_destroy(MsgArena *a);
+
+#endif /* MT25190_ARENA_H */
@@ -0,0 +1,168 @@
+/*
+ * Hugepage-backed buffer pool. See MT25190_BufferPool.h.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#include "MT25190_BufferPool.h"
+
+#define POOL_MAX_NODES 64
+
+/* Bump allocator over the current chunk of one NUMA node */
+typedef struct {
+    char *base;
+    size_t used;
+    size_t size;
+} PoolArena;
+
+/* Freed buffer waiting for an allocation of the same shape */
+typedef struct PoolBlock {
+    void *ptr;
+    size_t size;
+    size_t align;
+    int node;
+    struct PoolBlock *next;
+} PoolBlock;
+
+static int pool_mode = POOL_OFF;
+static PoolArena arenas[POOL_MAX_NODES];
+static PoolBlock *free_blocks;
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static int reported_hugetlb, reported_thp, warned_hugetlb;   // Print once each
+
+int buffer_pool_configure(const char *mode) {
+    if (!mode || strcmp(mode, "huge") == 0) pool_mode = POOL_HUGETLB;
+    else if (strcmp(mode, "thp") == 0) pool_mode = POOL_THP;
+    else if (strcmp(mode, "off") == 0) pool_mode = POOL_OFF;
+    else {
+        fprintf(stderr, "Unknown hugepage mode '%s' (expected huge|thp|off)\n", mode);
+        return -1;
+    }
+    return 0;
+}
+
+int buffer_pool_enabled(void) {
+    return pool_mode != POOL_OFF;
+}
+
+const char* buffer_pool_name(void) {
+    static const char *names[] = { "off", "huge", "thp" };
+    return names[pool_mode];
+}
+
+/* current_node: NUMA node of the CPU the caller runs on (0 if unknown) */
+static int current_node(void) {
+    unsigned cpu = 0, node = 0;
+    if (syscall(SYS_getcpu, &cpu, &node, NULL) < 0 || node >= POOL_MAX_NODES) return 0;
+    return (int)node;
+}
+
+/*
+ * map_thp: 2 MB-aligned anonymous mapping marked MADV_HUGEPAGE
+ * Over-maps by one hugepage and trims both ends to reach the alignment.
+ */
+static char* map_thp(size_t bytes) {
+    size_t span = bytes + POOL_HUGE_PAGE;
+    char *raw = mmap(NULL, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) return NULL;
+    char *aligned = (char*)(((uintptr_t)raw + POOL_HUGE_PAGE - 1) & ~(POOL_HUGE_PAGE - 1));
+    if (aligned > raw) munmap(raw, aligned - raw);
+    size_t tail = (raw + span) - (aligned + bytes);
+    if (tail) munmap(aligned + bytes, tail);
+
+    if (madvise(aligned, bytes, MADV_HUGEPAGE) != 0) {
+        perror("madvise(MADV_HUGEPAGE) failed - buffers stay on 4 KB pages");
+    } else if (!reported_thp) {
+        reported_thp = 1;
+        printf("Buffer pool: transparent hugepages (madvise, %zu MB chunks)\n", bytes >> 20);
+    }
+    return aligned;
+}
+
+/*
+ * map_chunk: 'bytes' (a multiple of 2 MB) backed by hugepages if possible
+ * Returns NULL with errno set on failure.
+ */
+static char* map_chunk(size_t bytes) {
+    if (pool_mode == POOL_HUGETLB) {
+        char *p = mmap(NULL, bytes, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED) {
+            if (!reported_hugetlb) {
+                reported_hugetlb = 1;
+                printf("Buffer pool: 2 MB hugetlb pages (%zu MB chunks)\n", bytes >> 20);
+            }
+            return p;
+        }
+        if (!warned_hugetlb) {
+            warned_hugetlb = 1;
+            perror("MAP_HUGETLB failed (vm.nr_hugepages reserved?) - falling back to THP");
+        }
+    }
+    return map_thp(bytes);
+}
+
+void* pool_alloc(size_t size, size_t align) {
+    if (pool_mode == POOL_OFF) return aligned_alloc(align, (size + align - 1) & ~(align - 1));
+
+    int node = current_node();
+    pthread_mutex_lock(&pool_lock);
+
+    // Exact-shape reuse keeps a reconnecting client on its old buffers
+    for (PoolBlock **link = &free_blocks; *link; link = &(*link)->next) {
+        PoolBlock *b = *link;
+        if (b->size == size && b->align == align && b->node == node) {
+            void *ptr = b->ptr;
+            *link = b->next;
+            pthread_mutex_unlock(&pool_lock);
+            free(b);
+            return ptr;
+        }
+    }
+
+    PoolArena *a = &arenas[node];
+    size_t offset = (a->used + align - 1) & ~(align - 1);
+    if (!a->base || offset + size > a->size) {
+        // The rest of the old chunk is abandoned; large buffers get a chunk of their own
+        size_t bytes = (size + align + POOL_HUGE_PAGE - 1) & ~(POOL_HUGE_PAGE - 1);
+        char *chunk = map_chunk(bytes);
+        if (!chunk) {
+            pthread_mutex_unlock(&pool_lock);
+            return NULL;
+        }
+        a->base = chunk;
+        a->size = bytes;
+        offset = 0;
+    }
+    a->used = offset + size;
+    void *ptr = a->base + offset;
+    pthread_mutex_unlock(&pool_lock);
+    return ptr;
+}
+
+void pool_free(void *ptr, size_t size, size_t align) {
+    if (!ptr) return;
+    if (pool_mode == POOL_OFF) {
+        free(ptr);
+        return;
+    }
+    PoolBlock *b = malloc(sizeof(PoolBlock));
+    if (!b) return;     // Leaks one buffer rather than failing the caller
+    b->ptr = ptr;
+    b->size = size;
+    b->align = align;
+    b->node = current_node();
+    pthread_mutex_lock(&pool_lock);
+    b->next = free_blocks;
+    free_blocks = b;
+    pthread_mutex_unlock(&pool_lock);
+}
@@ -0,0 +1,65 @@
+/*
+ * Hugepage-backed buffer pool for the A2/A3 server payloads.
+ *
+ * By default every connection aligned_alloc()s its own 4 KB-aligned field
+ * buffers, so a large message spans many 4 KB pages: each one costs a dTLB
+ * entry on every pass over the payload, and A3 pins each one with mlock().
+ * With --hugepages the buffers are instead carved out of 2 MB chunks:
+ *
+ *   huge: mmap(MAP_HUGETLB) from the reserved pool (vm.nr_hugepages); when
+ *         none are reserved the chunk falls back to 'thp'
+ *   thp:  a 2 MB-aligned anonymous mapping with madvise(MADV_HUGEPAGE), so
+ *         transparent hugepages can back it (needs THP 'madvise' or 'always')
+ *
+ *   chunk (2 MB, node 0)                         chunk (2 MB, node 1)
+ *   +--------+--------+--------+----------+      +--------+-------
+ *   | conn 1 | conn 1 | conn 2 |   ...    |      | conn 3 | ...
+ *   +--------+--------+--------+----------+      +--------+-------
+ *    ^ bump pointer carves buffers for every connection
+ *
+ * There is one arena per NUMA node (the caller's current node), so buffers
+ * stay node-local under --affinity. Chunks are never unmapped: a freed
+ * buffer goes onto a free list and is handed to the next allocation of the
+ * same size and alignment (the next connection).
+ */
+
+#ifndef MT25190_BUFFERPOOL_H
+#define MT25190_BUFFERPOOL_H
+
+#include <stddef.h>
+
+#define POOL_HUGE_PAGE (2UL * 1024 * 1024)
+
+typedef enum {
+    POOL_OFF     = 0,   // Plain aligned_alloc()/free() (default)
+    POOL_HUGETLB = 1,   // MAP_HUGETLB, THP fallback
+    POOL_THP     = 2    // madvise(MADV_HUGEPAGE) only
+} PoolMode;
+
+/*
+ * buffer_pool_configure: "--hugepages" (NULL argument: huge) or
+ * "--hugepages=huge|thp|off". Call before any pool_alloc().
+ * Returns 0 on success, -1 on an unknown mode.
+ */
+int buffer_pool_configure(const char *mode);
+
+/* buffer_pool_enabled: Whether pool_alloc() carves from hugepage chunks */
+int buffer_pool_enabled(void);
+
+/* buffer_pool_name: "off", "huge" or "thp" for banners */
+const char* buffer_pool_name(void);
+
+/*
+ * pool_alloc: 'size' bytes aligned to 'align' (a power of two, at most
+ * 2 MB). Falls through to aligned_alloc() when the pool is off.
+ * Returns NULL with errno set on failure.
+ */
+void* pool_alloc(size_t size, size_t align);
+
+/*
+ * pool_free: Releases a pool_alloc() buffer ('size' and 'align' as passed
+ * to pool_alloc). Pooled buffers are kept for reuse, not unmapped.
+ */
+void pool_free(void *ptr, size_t size, size_t align);
+
+#endif /* MT25190_BUFFERPOOL_H */
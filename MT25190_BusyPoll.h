@@ -0,0 +1,96 @@
+/*
+ * Busy-poll receive mode shared by the A1/A2/A3/A5 clients and servers.
+ *
+ * A blocking recv() on an empty socket puts the thread to sleep; the next
+ * packet then pays for the wakeup (softirq -> scheduler -> context switch)
+ * before the copy even starts. With --busy-poll[=USEC] on either side:
+ *
+ *   - SO_BUSY_POLL=USEC: the kernel polls the device queue for up to USEC
+ *     inside recv() before sleeping (needs CAP_NET_ADMIN above the
+ *     net.core.busy_read sysctl; only sockets fed by a NAPI device poll)
+ *   - SO_PREFER_BUSY_POLL: keeps the device's softirq processing out of
+ *     the way while the application is polling
+ *   - every receive is issued with MSG_DONTWAIT and retried on EAGAIN, so
+ *     the thread never sleeps: it owns its core and trades CPU time for
+ *     wakeup latency
+ *
+ * The user-space spin is what applies on loopback, where there is no NAPI
+ * queue to poll. Clients report thread CPU time per message
+ * (thread_cpu_ns(), MT25190_Histogram.h) next to the latency percentiles
+ * so the trade can be measured per copy strategy.
+ */
+
+#ifndef MT25190_BUSYPOLL_H
+#define MT25190_BUSYPOLL_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+
+#ifndef SO_PREFER_BUSY_POLL
+#define SO_PREFER_BUSY_POLL 69
+#endif
+
+#define BUSY_POLL_DEFAULT_USEC 50
+
+/*
+ * parse_busy_poll: "--busy-poll" (NULL argument) or "--busy-poll=USEC"
+ * Returns the SO_BUSY_POLL budget in microseconds, or -1 if invalid.
+ */
+static inline int parse_busy_poll(const char *arg) {
+    if (!arg) return BUSY_POLL_DEFAULT_USEC;
+    char *end;
+    long usec = strtol(arg, &end, 10);
+    if (end == arg || *end != '\0' || usec < 0 || usec > 1000000) return -1;
+    return (int)usec;
+}
+
+/*
+ * busy_poll_setup: Enables kernel busy polling on a socket. A refused
+ * option only costs the kernel-side poll (the user-space spin still runs),
+ * so failures are reported once per process and otherwise ignored.
+ */
+static inline void busy_poll_setup(int sockfd, int usec) {
+    static int warned;
+    int one = 1;
+    if (setsockopt(sockfd, SOL_SOCKET, SO_BUSY_POLL, &usec, sizeof(usec)) < 0 ||
+        setsockopt(sockfd, SOL_SOCKET, SO_PREFER_BUSY_POLL, &one, sizeof(one)) < 0) {
+        if (!__atomic_exchange_n(&warned, 1, __ATOMIC_RELAXED)) {
+            perror("SO_BUSY_POLL/SO_PREFER_BUSY_POLL refused - spinning in user space only");
+        }
+    }
+}
+
+/* cpu_relax: Eases the spinning hyperthread's pressure on its sibling */
+static inline void cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+/*
+ * recv_spin / recvmsg_spin: recv()/recvmsg() that never sleep when 'spin'
+ * is set (non-blocking calls retried on EAGAIN); plain blocking calls
+ * otherwise. Same return values as the wrapped syscalls.
+ */
+static inline ssize_t recv_spin(int sockfd, void *buf, size_t len, int flags, int spin) {
+    if (!spin) return recv(sockfd, buf, len, flags);
+    for (;;) {
+        ssize_t n = recv(sockfd, buf, len, flags | MSG_DONTWAIT);
+        if (n >= 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) return n;
+        cpu_relax();
+    }
+}
+
+static inline ssize_t recvmsg_spin(int sockfd, struct msghdr *msg, int flags, int spin) {
+    if (!spin) return recvmsg(sockfd, msg, flags);
+    for (;;) {
+        ssize_t n = recvmsg(sockfd, msg, flags | MSG_DONTWAIT);
+        if (n >= 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) return n;
+        cpu_relax();
+    }
+}
+
+#endif /* MT25190_BUSYPOLL_H */
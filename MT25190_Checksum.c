@@ -0,0 +1,334 @@
+/*
+ * CRC32C kernels and runtime dispatch. See MT25190_Checksum.h.
+ *
+ * All kernels work on the raw (non-inverted) CRC register; crc32c() adds
+ * the inversions. Bit order is the reflected one used by the crc32
+ * instruction: bit 0 of a byte is the highest-order coefficient.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "MT25190_Checksum.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define CRC32C_X86 1
+#endif
+
+#define CRC32C_POLY_REFLECTED 0x82F63B78u
+#define CRC32C_POLY_NORMAL    0x1EDC6F41u   // x^32 term implied
+
+typedef uint32_t (*crc_kernel_fn)(uint32_t crc, const unsigned char *p, size_t len);
+
+static uint32_t crc_table[8][256];          // Slicing-by-8 tables (scalar kernel)
+static uint64_t fold_k[17][2];              // [D/16]: {x^(8D+63), x^(8D-1)} mod P
+static pthread_once_t tables_once = PTHREAD_ONCE_INIT;
+
+static crc_kernel_fn active_kernel;
+static const char *active_name;
+
+/*
+ * xpow_mod: x^n mod P in normal bit order (bit i = coefficient of x^i)
+ */
+static uint32_t xpow_mod(unsigned n) {
+    uint32_t r = 1;
+    while (n--) r = (r & 0x80000000u) ? (r << 1) ^ CRC32C_POLY_NORMAL : r << 1;
+    return r;
+}
+
+/*
+ * fold_constant: x^n mod P as a reflected 64-bit PCLMULQDQ operand
+ * (coefficient of x^e at bit 63 - e). A reflected carry-less product
+ * comes out one bit low, which the "-1" in the exponents absorbs.
+ */
+static uint64_t fold_constant(unsigned n) {
+    uint32_t r = xpow_mod(n);
+    uint64_t k = 0;
+    for (int e = 0; e < 32; e++) {
+        if (r >> e & 1) k |= 1ull << (63 - e);
+    }
+    return k;
+}
+
+static void init_tables(void) {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (int b = 0; b < 8; b++) c = (c >> 1) ^ (CRC32C_POLY_REFLECTED & (0u - (c & 1)));
+        crc_table[0][i] = c;
+    }
+    for (int i = 0; i < 256; i++) {
+        for (int t = 1; t < 8; t++) {
+            crc_table[t][i] = (crc_table[t - 1][i] >> 8) ^ crc_table[0][crc_table[t - 1][i] & 0xFF];
+        }
+    }
+    // Folding a 16-byte block H:L forward by D bytes multiplies it by x^(8D):
+    // H * (x^(8D+64) mod P) + L * (x^(8D) mod P)
+    for (unsigned d = 1; d <= 16; d++) {
+        fold_k[d][0] = fold_constant(128 * d + 63);
+        fold_k[d][1] = fold_constant(128 * d - 1);
+    }
+}
+
+/* Scalar: slicing-by-8, one table lookup per byte but 8 independent chains */
+static uint32_t crc_scalar(uint32_t crc, const unsigned char *p, size_t len) {
+    while (len && ((uintptr_t)p & 7)) {
+        crc = crc_table[0][(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+        len--;
+    }
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    while (len >= 8) {
+        uint64_t w;
+        memcpy(&w, p, 8);
+        w ^= crc;
+        crc = crc_table[7][w & 0xFF] ^ crc_table[6][(w >> 8) & 0xFF] ^
+              crc_table[5][(w >> 16) & 0xFF] ^ crc_table[4][(w >> 24) & 0xFF] ^
+              crc_table[3][(w >> 32) & 0xFF] ^ crc_table[2][(w >> 40) & 0xFF] ^
+              crc_table[1][(w >> 48) & 0xFF] ^ crc_table[0][w >> 56];
+        p += 8;
+        len -= 8;
+    }
+#endif
+    while (len--) crc = crc_table[0][(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+    return crc;
+}
+
+#ifdef CRC32C_X86
+
+/* SSE4.2: crc32 instruction, 8 bytes per instruction (latency bound) */
+__attribute__((target("sse4.2")))
+static uint32_t crc_sse42(uint32_t crc, const unsigned char *p, size_t len) {
+    while (len && ((uintptr_t)p & 7)) {
+        crc = _mm_crc32_u8(crc, *p++);
+        len--;
+    }
+    uint64_t c = crc;
+    while (len >= 8) {
+        uint64_t w;
+        memcpy(&w, p, 8);
+        c = _mm_crc32_u64(c, w);
+        p += 8;
+        len -= 8;
+    }
+    crc = (uint32_t)c;
+    while (len--) crc = _mm_crc32_u8(crc, *p++);
+    return crc;
+}
+
+/* fold_pair: {H constant, L constant} for a fold distance of 'dist' bytes */
+__attribute__((target("sse4.2,pclmul")))
+static inline __m128i fold_pair(unsigned dist) {
+    return _mm_set_epi64x((long long)fold_k[dist / 16][1], (long long)fold_k[dist / 16][0]);
+}
+
+/* fold128: Moves block x forward by the distance in k and adds it to 'next' */
+__attribute__((target("sse4.2,pclmul")))
+static inline __m128i fold128(__m128i x, __m128i k, __m128i next) {
+    return _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x, k, 0x00),
+                                       _mm_clmulepi64_si128(x, k, 0x11)), next);
+}
+
+/*
+ * finish_folded: The stream is now equivalent to the one block 'x'
+ * followed by the remaining 'len' bytes: fold 16-byte blocks, then run
+ * the crc32 instruction over x (from a zero register) and the tail.
+ */
+__attribute__((target("sse4.2,pclmul")))
+static uint32_t finish_folded(__m128i x, const unsigned char *p, size_t len) {
+    __m128i k16 = fold_pair(16);
+    while (len >= 16) {
+        x = fold128(x, k16, _mm_loadu_si128((const __m128i*)p));
+        p += 16;
+        len -= 16;
+    }
+    uint64_t c = _mm_crc32_u64(0, (uint64_t)_mm_cvtsi128_si64(x));
+    c = _mm_crc32_u64(c, (uint64_t)_mm_extract_epi64(x, 1));
+    return crc_sse42((uint32_t)c, p, len);
+}
+
+/* AVX2: four 256-bit accumulators (two blocks each) folded 128 bytes at a time */
+__attribute__((target("avx2,sse4.2,pclmul,vpclmulqdq")))
+static inline __m256i fold256(__m256i x, __m256i k, __m256i next) {
+    return _mm256_xor_si256(_mm256_xor_si256(_mm256_clmulepi64_epi128(x, k, 0x00),
+                                             _mm256_clmulepi64_epi128(x, k, 0x11)), next);
+}
+
+__attribute__((target("avx2,sse4.2,pclmul,vpclmulqdq")))
+static uint32_t crc_avx2(uint32_t crc, const unsigned char *p, size_t len) {
+    if (len < 256) return crc_sse42(crc, p, len);
+
+    const __m256i *v = (const __m256i*)p;
+    __m256i x0 = _mm256_xor_si256(_mm256_loadu_si256(v),
+                                  _mm256_set_epi32(0, 0, 0, 0, 0, 0, 0, (int)crc));
+    __m256i x1 = _mm256_loadu_si256(v + 1);
+    __m256i x2 = _mm256_loadu_si256(v + 2);
+    __m256i x3 = _mm256_loadu_si256(v + 3);
+    p += 128;
+    len -= 128;
+
+    __m256i k128 = _mm256_broadcastsi128_si256(fold_pair(128));
+    while (len >= 128) {
+        v = (const __m256i*)p;
+        x0 = fold256(x0, k128, _mm256_loadu_si256(v));
+        x1 = fold256(x1, k128, _mm256_loadu_si256(v + 1));
+        x2 = fold256(x2, k128, _mm256_loadu_si256(v + 2));
+        x3 = fold256(x3, k128, _mm256_loadu_si256(v + 3));
+        p += 128;
+        len -= 128;
+    }
+
+    // Four accumulators -> one, then 32-byte steps, then one 16-byte block
+    x3 = fold256(x2, _mm256_broadcastsi128_si256(fold_pair(32)), x3);
+    x3 = fold256(x1, _mm256_broadcastsi128_si256(fold_pair(64)), x3);
+    x3 = fold256(x0, _mm256_broadcastsi128_si256(fold_pair(96)), x3);
+    __m256i k32 = _mm256_broadcastsi128_si256(fold_pair(32));
+    while (len >= 32) {
+        x3 = fold256(x3, k32, _mm256_loadu_si256((const __m256i*)p));
+        p += 32;
+        len -= 32;
+    }
+    __m128i x = fold128(_mm256_castsi256_si128(x3), fold_pair(16),
+                        _mm256_extracti128_si256(x3, 1));
+    return finish_folded(x, p, len);
+}
+
+/* AVX-512: four 512-bit accumulators (four blocks each) folded 256 bytes at a time */
+__attribute__((target("avx512f,avx2,sse4.2,pclmul,vpclmulqdq")))
+static inline __m512i fold512(__m512i x, __m512i k, __m512i next) {
+    return _mm512_ternarylogic_epi64(_mm512_clmulepi64_epi128(x, k, 0x00),
+                                     _mm512_clmulepi64_epi128(x, k, 0x11), next, 0x96);
+}
+
+__attribute__((target("avx512f,avx2,sse4.2,pclmul,vpclmulqdq")))
+static uint32_t crc_avx512(uint32_t crc, const unsigned char *p, size_t len) {
+    if (len < 512) return crc_avx2(crc, p, len);
+
+    const __m512i *v = (const __m512i*)p;
+    __m512i x0 = _mm512_xor_si512(_mm512_loadu_si512(v),
+                                  _mm512_castsi128_si512(_mm_cvtsi32_si128((int)crc)));
+    __m512i x1 = _mm512_loadu_si512(v + 1);
+    __m512i x2 = _mm512_loadu_si512(v + 2);
+    __m512i x3 = _mm512_loadu_si512(v + 3);
+    p += 256;
+    len -= 256;
+
+    __m512i k256 = _mm512_broadcast_i32x4(fold_pair(256));
+    while (len >= 256) {
+        v = (const __m512i*)p;
+        x0 = fold512(x0, k256, _mm512_loadu_si512(v));
+        x1 = fold512(x1, k256, _mm512_loadu_si512(v + 1));
+        x2 = fold512(x2, k256, _mm512_loadu_si512(v + 2));
+        x3 = fold512(x3, k256, _mm512_loadu_si512(v + 3));
+        p += 256;
+        len -= 256;
+    }
+
+    // Four accumulators -> one, then 64-byte steps, then one 16-byte block
+    x3 = fold512(x2, _mm512_broadcast_i32x4(fold_pair(64)), x3);
+    x3 = fold512(x1, _mm512_broadcast_i32x4(fold_pair(128)), x3);
+    x3 = fold512(x0, _mm512_broadcast_i32x4(fold_pair(192)), x3);
+    __m512i k64 = _mm512_broadcast_i32x4(fold_pair(64));
+    while (len >= 64) {
+        x3 = fold512(x3, k64, _mm512_loadu_si512((const void*)p));
+        p += 64;
+        len -= 64;
+    }
+    __m128i x = _mm512_extracti32x4_epi32(x3, 3);
+    x = fold128(_mm512_extracti32x4_epi32(x3, 2), fold_pair(16), x);
+    x = fold128(_mm512_extracti32x4_epi32(x3, 1), fold_pair(32), x);
+    x = fold128(_mm512_castsi512_si128(x3), fold_pair(48), x);
+    return finish_folded(x, p, len);
+}
+
+#endif /* CRC32C_X86 */
+
+/* Kernels from fastest to slowest; 'supported' is checked at selection */
+static int always(void) { return 1; }
+
+#ifdef CRC32C_X86
+static int has_sse42(void) { return __builtin_cpu_supports("sse4.2"); }
+static int has_avx2_clmul(void) {
+    return has_sse42() && __builtin_cpu_supports("pclmul") &&
+           __builtin_cpu_supports("avx2") && __builtin_cpu_supports("vpclmulqdq");
+}
+static int has_avx512_clmul(void) {
+    return has_avx2_clmul() && __builtin_cpu_supports("avx512f");
+}
+#endif
+
+static const struct {
+    const char *name;
+    crc_kernel_fn fn;
+    int (*supported)(void);
+} kernels[] = {
+#ifdef CRC32C_X86
+    { "avx512", crc_avx512, has_avx512_clmul },
+    { "avx2",   crc_avx2,   has_avx2_clmul },
+    { "sse4.2", crc_sse42,  has_sse42 },
+#endif
+    { "scalar", crc_scalar, always },
+};
+
+#define NUM_KERNELS (sizeof(kernels) / sizeof(kernels[0]))
+
+/*
+ * kernel_matches_scalar: Cross-checks a kernel against the table version
+ * on lengths that exercise every folding stage and tail
+ */
+static int kernel_matches_scalar(crc_kernel_fn fn) {
+    static unsigned char buf[2048 + 64];
+    for (size_t i = 0; i < sizeof(buf); i++) buf[i] = (unsigned char)(i * 131 + 7);
+    static const size_t lengths[] = { 0, 1, 15, 255, 256, 383, 511, 512, 1000, 2051 };
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+        if (fn(0xFFFFFFFFu, buf + 5, lengths[i]) != crc_scalar(0xFFFFFFFFu, buf + 5, lengths[i])) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int crc32c_select(const char *name) {
+    pthread_once(&tables_once, init_tables);
+    int automatic = !name || strcmp(name, "auto") == 0;
+    for (size_t i = 0; i < NUM_KERNELS; i++) {
+        if (!automatic && strcmp(kernels[i].name, name) != 0) continue;
+        if (!kernels[i].supported()) {
+            if (automatic) continue;
+            fprintf(stderr, "CRC32C kernel '%s' not supported by this CPU\n", name);
+            return -1;
+        }
+        if (!kernel_matches_scalar(kernels[i].fn)) {
+            fprintf(stderr, "CRC32C kernel '%s' failed its self-check\n", kernels[i].name);
+            if (automatic) continue;
+            return -1;
+        }
+        active_kernel = kernels[i].fn;
+        active_name = kernels[i].name;
+        return 0;
+    }
+    fprintf(stderr, "Unknown CRC32C kernel '%s' (expected auto|%s)\n", name, crc32c_kernel_list());
+    return -1;
+}
+
+uint32_t crc32c(uint32_t crc, const void *data, size_t len) {
+    if (!active_kernel) crc32c_select(NULL);
+    return ~active_kernel(~crc, (const unsigned char*)data, len);
+}
+
+const char* crc32c_kernel(void) {
+    if (!active_kernel) crc32c_select(NULL);
+    return active_name;
+}
+
+const char* crc32c_kernel_list(void) {
+    static char list[64];
+    if (!list[0]) {
+        size_t used = 0;
+        for (size_t i = 0; i < NUM_KERNELS && used < sizeof(list); i++) {
+            used += (size_t)snprintf(list + used, sizeof(list) - used, "%s%s",
+                                     i ? "|" : "", kernels[i].name);
+        }
+    }
+    return list;
+}
@@ -0,0 +1,48 @@
+/*
+ * CRC32C (Castagnoli) payload checksums for the --checksum / --verify
+ * integrity mode.
+ *
+ * The server seals every frame with the CRC32C of its payload (all bytes
+ * after the FrameHeader, see frame_seal() in MT25190_Framing.h); the client
+ * recomputes it over the bytes it actually received. Receivers otherwise
+ * never touch the payload, so this is also the cheapest realistic
+ * "consume the data" step: its cost is reported in cycles per byte next
+ * to the transport's own cycles per byte.
+ *
+ * Kernels, picked once at startup by CPUID (or forced with --verify=NAME):
+ *
+ *   avx512   VPCLMULQDQ folding, 4 x 512-bit accumulators (256 B / step)
+ *   avx2     VPCLMULQDQ folding, 4 x 256-bit accumulators (128 B / step)
+ *   sse4.2   crc32 instruction, 8 bytes at a time
+ *   scalar   slicing-by-8 tables (any CPU)
+ *
+ * The folding kernels multiply 16-byte blocks forward by x^(8*D) mod P
+ * with carry-less multiplies until one block is left, then finish with
+ * the crc32 instruction, so they need SSE4.2 and PCLMULQDQ as well.
+ */
+
+#ifndef MT25190_CHECKSUM_H
+#define MT25190_CHECKSUM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * crc32c: Standard CRC32C (pre- and post-inverted) of 'len' bytes, chained
+ * from 'crc' (0 to start): crc32c(crc32c(0, a, n), b, m) == CRC of a||b.
+ * crc32c(0, "123456789", 9) == 0xE3069283.
+ */
+uint32_t crc32c(uint32_t crc, const void *data, size_t len);
+
+/*
+ * crc32c_select: Picks the kernel: "auto" (or NULL) for the fastest one
+ * this CPU supports, otherwise one of crc32c_kernel_list(). Returns -1 if
+ * the name is unknown or the CPU lacks the instructions.
+ */
+int crc32c_select(const char *name);
+
+/* crc32c_kernel: Name of the kernel in use; crc32c_kernel_list: for usage */
+const char* crc32c_kernel(void);
+const char* crc32c_kernel_list(void);
+
+#endif /* MT25190_CHECKSUM_H */
@@ -0,0 +1,533 @@
+/*
+ * Unified TCP client: one binary for every copy strategy (--mode)
+ *
+ * Connection setup, ping-pong, busy polling, placement, per-message
+ * latency, statistics aggregation and the METRICS line live here; how
+ * the bytes of one frame reach user space comes from the selected
+ * ClientTransport (MT25190_Transport.h), e.g. for two-copy:
+ * Copy 1: NIC → Kernel space (DMA)
+ * Copy 2: Kernel space → User space (via recv())
+ *
+ * The MT25190_Part_A{1,2,3,5}_Client binaries are this program built with
+ * a different DEFAULT_MODE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <getopt.h>
+#include <errno.h>
+
+#include "MT25190_Transport.h"
+#include "MT25190_PingPong.h"
+#include "MT25190_BusyPoll.h"
+#include "MT25190_Histogram.h"
+#include "MT25190_Framing.h"
+#include "MT25190_Affinity.h"
+#include "MT25190_Checksum.h"
+#include "MT25190_Consumer.h"
+#include "MT25190_TimeSeries.h"
+#include "MT25190_HwCounters.h"
+
+#ifndef DEFAULT_MODE
+#define DEFAULT_MODE "two-copy"
+#endif
+
+#define DEFAULT_SERVER "127.0.0.1"
+#define RUN_DURATION 30  // Run for 30 seconds
+
+/* Statistics structure for each thread */
+typedef struct {
+    long bytes_received;
+    long messages_received;
+    double elapsed_time;
+    long messages_lost;     // Gaps in the frame sequence numbers
+    uint64_t cpu_ns;        // Thread CPU time (user + system) while receiving
+    long rx_mapped_bytes;   // Received without a copy (zero-copy --zc-recv page mapping)
+    long rx_copied_bytes;   // Copied into user space (the whole stream for most modes)
+    uint64_t verify_cycles; // --verify: cycles spent recomputing payload CRC32Cs
+    uint64_t consume_cycles;    // --consume: cycles spent in the consumer profile
+    long payload_bytes;     // Payload bytes verified / consumed
+    long crc_errors;        // Frames whose payload did not match the sealed CRC
+    // Per-message latency: RTT in ping-pong mode, one-way delay from the
+    // frame's send timestamp in streaming mode
+    LatencyHistogram latency;
+} ThreadStats;
+
+/* Global configuration */
+char server_ip[32] = DEFAULT_SERVER;
+int server_port;
+int message_size = 1024;
+int num_threads = 4;
+int run_duration = RUN_DURATION;
+int pingpong = 0;   // 1: send a stamped request before each response (--pingpong)
+int busy_poll_usec = -1;    // >= 0: spin-receive, SO_BUSY_POLL budget (--busy-poll)
+int frame_checksum = 0;     // 1: verify every frame's payload CRC32C (--verify[=KERNEL])
+int consume_profile = CONSUME_NONE;     // What the application does with a payload (--consume)
+const char *timeseries_path = NULL;     // Per-interval samples as CSV (--timeseries=FILE)
+int ts_interval_ms = TS_DEFAULT_INTERVAL_MS;    // Sampling period (--ts-interval=MS)
+int hw_counters = 0;                    // Per-thread perf_event_open counters (--hw-counters)
+volatile sig_atomic_t running = 1;
+
+static const ClientTransport *transport;    // Selected receive strategy (--mode)
+
+/* Per-thread payload work after each frame (--verify, --consume) */
+typedef struct {
+    uint32_t crc;           // Running CRC32C of the current payload
+    Consumer consumer;
+    ThreadStats *stats;
+} PayloadWork;
+
+/*
+ * payload_sink: Verifies and consumes one piece of a payload, timing each
+ * step separately (called after the frame completes, or during
+ * receive_frame for in-place receivers)
+ */
+static void payload_sink(void *ctx, size_t offset, const void *data, size_t len) {
+    PayloadWork *work = (PayloadWork*)ctx;
+    if (frame_checksum) {
+        uint64_t start = cycles_now();
+        if (offset == 0) work->crc = 0;
+        work->crc = crc32c(work->crc, data, len);
+        work->stats->verify_cycles += cycles_now() - start;
+    }
+    if (consume_profile != CONSUME_NONE) {
+        uint64_t start = cycles_now();
+        consume(&work->consumer, offset, data, len);
+        work->stats->consume_cycles += cycles_now() - start;
+    }
+}
+
+/*
+ * client_thread: Each thread establishes connection and receives data
+ */
+void* client_thread(void *arg) {
+    int thread_id = *(int*)arg;
+    free(arg);
+    affinity_pin_next();    // Before allocating: buffers land on this CPU's node
+    hwc_thread_begin();     // Counted until the thread exits (--hw-counters)
+
+    int sock;
+    struct sockaddr_in server_addr;
+    ThreadStats stats = {0};
+    struct timespec start_time, end_time;
+    FrameAssembler fa;
+    size_t frame_bytes = (size_t)message_size * NUM_FIELDS;
+
+    // Create socket
+    sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (sock < 0) {
+        perror("Socket creation failed");
+        return NULL;
+    }
+
+    // Configure server address
+    memset(&server_addr, 0, sizeof(server_addr));
+    server_addr.sin_family = AF_INET;
+    server_addr.sin_port = htons(server_port);
+
+    if (inet_pton(AF_INET, server_ip, &server_addr.sin_addr) <= 0) {
+        perror("Invalid address");
+        close(sock);
+        return NULL;
+    }
+
+    // Connect to server
+    printf("[Thread %d] Connecting to server...\n", thread_id);
+    if (connect(sock, (struct sockaddr*)&server_addr, sizeof(server_addr)) < 0) {
+        perror("Connection failed");
+        close(sock);
+        return NULL;
+    }
+
+    printf("[Thread %d] Connected to server\n", thread_id);
+    if (pingpong) pingpong_socket_setup(sock);
+    if (busy_poll_usec >= 0) busy_poll_setup(sock, busy_poll_usec);
+
+    // Receive buffers (one whole frame) in user space
+    void *rx = transport->conn_open(sock, frame_bytes);
+    if (!rx) {
+        close(sock);
+        return NULL;
+    }
+
+    // Start timing
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+    uint64_t start_ns = monotonic_ns();
+    uint64_t cpu_start = thread_cpu_ns();
+    frame_assembler_init(&fa, frame_bytes);
+    TsCounter *ts = timeseries_counter(thread_id - 1);
+    PayloadWork work = { .stats = &stats };
+    if (consumer_init(&work.consumer, consume_profile, frame_bytes - sizeof(FrameHeader)) < 0) {
+        goto cleanup;
+    }
+    if (frame_checksum || consume_profile != CONSUME_NONE) {
+        frame_assembler_set_sink(&fa, payload_sink, &work);
+    }
+
+    // Receive data continuously
+    uint64_t seq = 0;
+    while (running) {
+        // Ping-pong: stamp and send one request, then wait for its response
+        if (pingpong) {
+            PingRequest req = { .seq = seq, .send_ns = monotonic_ns() };
+            if (send_ping_request(sock, &req) < 0) {
+                perror("Request send error");
+                goto cleanup;
+            }
+        }
+
+        // Receive one whole message (8 fields, reassembled as one frame)
+        ssize_t received = transport->receive_frame(sock, rx, &fa);
+        if (received < 0) {
+            perror("Receive error");
+            goto cleanup;
+        }
+        if (received == 0) {
+            printf("[Thread %d] Server closed connection\n", thread_id);
+            goto cleanup;
+        }
+
+        const FrameHeader *hdr = frame_header(&fa);
+        uint64_t now_ns = monotonic_ns();
+        stats.bytes_received += hdr->length;
+        stats.messages_received++;
+        ts_record(ts, hdr->length);
+
+        // Ping-pong: the header echoes our request's seq and send time
+        if (pingpong) {
+            if (hdr->seq != seq) {
+                fprintf(stderr, "[Thread %d] Response out of sequence\n", thread_id);
+                goto cleanup;
+            }
+            seq++;
+        }
+        hist_record(&stats.latency, frame_age_ns(hdr, now_ns));
+
+        // --verify / --consume: read the payload where this transport
+        // received it; --verify compares with the CRC32C the server sealed
+        if (fa.sink) {
+            if (frame_checksum && !(hdr->flags & FRAME_F_CRC32C)) {
+                fprintf(stderr, "[Thread %d] Frame carries no CRC32C "
+                                "(start the server with --checksum)\n", thread_id);
+                goto cleanup;
+            }
+            transport->visit_payload(rx, &fa, payload_sink, &work);
+            stats.payload_bytes += hdr->length - sizeof(FrameHeader);
+            if (frame_checksum && work.crc != hdr->crc) stats.crc_errors++;
+        }
+
+        // Check if run duration exceeded
+        double elapsed = (now_ns - start_ns) / 1e9;
+        if (elapsed >= run_duration) {
+            running = 0;
+        }
+    }
+
+cleanup:
+    // Calculate final statistics
+    stats.messages_lost = fa.lost;
+    stats.cpu_ns = thread_cpu_ns() - cpu_start;
+    if (!transport->rx_counters ||
+        !transport->rx_counters(rx, &stats.rx_mapped_bytes, &stats.rx_copied_bytes)) {
+        stats.rx_copied_bytes = stats.bytes_received;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+    stats.elapsed_time = (end_time.tv_sec - start_time.tv_sec) +
+                        (end_time.tv_nsec - start_time.tv_nsec) / 1e9;
+
+    // Print thread statistics
+    printf("\n[Thread %d] Statistics:\n", thread_id);
+    printf("  Messages received: %ld\n", stats.messages_received);
+    printf("  Bytes received: %ld\n", stats.bytes_received);
+    printf("  Messages lost: %ld\n", stats.messages_lost);
+    if (frame_checksum) printf("  CRC errors: %ld\n", stats.crc_errors);
+    printf("  Duration: %.2f seconds\n", stats.elapsed_time);
+    printf("  Throughput: %.2f MB/s\n",
+           (stats.bytes_received / (1024.0 * 1024.0)) / stats.elapsed_time);
+
+    consumer_destroy(&work.consumer);
+    transport->conn_close(rx);
+    close(sock);
+
+    // Return statistics
+    ThreadStats *result = (ThreadStats*)malloc(sizeof(ThreadStats));
+    *result = stats;
+    return result;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s <server_ip> <port> <message_size> <num_threads> <duration>\n"
+                    "       [--mode=%s] [--pingpong]\n"
+                    "       [--busy-poll[=USEC]] [--affinity=POLICY] [--verify[=KERNEL]]\n"
+                    "       [--consume=none|sum|random|copy] [--timeseries=FILE] [--ts-interval=MS]\n"
+                    "       [--hw-counters]\n"
+                    "       %s\n",
+            prog, transport_mode_list(), transport->usage ? transport->usage : "");
+}
+
+int main(int argc, char *argv[]) {
+    pthread_t *threads;
+    ThreadStats aggregate = {0};
+
+    // The strategy decides which extra flags exist, so find it first
+    const char *mode = scan_mode_option(argc, argv);
+    if (!mode) mode = DEFAULT_MODE;
+    transport = find_client_transport(mode);
+    if (!transport) {
+        fprintf(stderr, "Unknown mode '%s' (expected %s)\n", mode, transport_mode_list());
+        exit(EXIT_FAILURE);
+    }
+    server_port = transport->default_port;
+
+    // Optional flags (may appear anywhere): --mode=STRATEGY (see MT25190_Transport.h)
+    // --pingpong (one request per response, RTT per message)
+    // --busy-poll[=USEC] (spin in non-blocking receives instead of sleeping)
+    // --affinity=POLICY (pin threads to CPUs, see MT25190_Affinity.h)
+    // --verify[=KERNEL] (check the payload CRC32C of every frame, see MT25190_Checksum.h)
+    // --consume=PROFILE (read every payload like an application, see MT25190_Consumer.h)
+    // --timeseries=FILE --ts-interval=MS (per-interval samples, see MT25190_TimeSeries.h)
+    // --hw-counters (per-thread perf_event_open counters, see MT25190_HwCounters.h)
+    // plus the strategy's own flags (ClientTransport.options)
+    static const struct option common_options[] = {
+        {"mode", required_argument, 0, 'm'},
+        {"pingpong", no_argument, 0, 'p'},
+        {"busy-poll", optional_argument, 0, 'B'},
+        {"affinity", required_argument, 0, 'a'},
+        {"verify", optional_argument, 0, 'v'},
+        {"consume", required_argument, 0, 'C'},
+        {"timeseries", required_argument, 0, 'T'},
+        {"ts-interval", required_argument, 0, 'I'},
+        {"hw-counters", no_argument, 0, 'K'},
+        {0, 0, 0, 0}
+    };
+    const struct option *long_options = merge_options(common_options, transport->options);
+    int opt_char;
+    while ((opt_char = getopt_long(argc, argv, "", long_options, NULL)) != -1) {
+        switch (opt_char) {
+        case 'm':
+            break;  // Resolved above
+        case 'p':
+            pingpong = 1;
+            break;
+        case 'B':
+            busy_poll_usec = parse_busy_poll(optarg);
+            if (busy_poll_usec < 0) {
+                fprintf(stderr, "Invalid --busy-poll budget '%s' (microseconds)\n", optarg);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'a':
+            if (affinity_configure(optarg, AFFINITY_CLIENT) < 0) exit(EXIT_FAILURE);
+            break;
+        case 'v':
+            if (crc32c_select(optarg) < 0) exit(EXIT_FAILURE);
+            frame_checksum = 1;
+            break;
+        case 'C':
+            consume_profile = consume_parse(optarg);
+            if (consume_profile < 0) exit(EXIT_FAILURE);
+            break;
+        case 'T':
+            timeseries_path = optarg;
+            break;
+        case 'K':
+            hw_counters = 1;
+            break;
+        case 'I':
+            ts_interval_ms = atoi(optarg);
+            if (ts_interval_ms <= 0) {
+                fprintf(stderr, "Invalid --ts-interval '%s' (milliseconds)\n", optarg);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case '?':
+            usage(argv[0]);
+            exit(EXIT_FAILURE);
+        default:
+            if (!transport->parse_option || transport->parse_option(opt_char, optarg) < 0) {
+                usage(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        }
+    }
+
+    // Parse positional arguments: <server_ip> <port> <message_size> <num_threads> <duration>
+    // PA02 requirement: All parameters must be passed explicitly for automation
+    if (argc > optind) {
+        strncpy(server_ip, argv[optind], sizeof(server_ip) - 1);
+    }
+    if (argc > optind + 1) {
+        server_port = atoi(argv[optind + 1]);
+    }
+    if (argc > optind + 2) {
+        message_size = atoi(argv[optind + 2]);
+    }
+    if (argc > optind + 3) {
+        num_threads = atoi(argv[optind + 3]);
+    }
+    if (argc > optind + 4) {
+        run_duration = atoi(argv[optind + 4]);
+    }
+    if (message_size < (int)sizeof(FrameHeader)) {
+        fprintf(stderr, "message_size must be >= %zu (frame header)\n", sizeof(FrameHeader));
+        exit(EXIT_FAILURE);
+    }
+
+    printf("=== PA02 Part %s: %s Client ===\n", transport->part, transport->title);
+    printf("Roll Number: MT25190\n");
+    printf("Server: %s:%d\n", server_ip, server_port);
+    printf("Transport: %s\n", transport->name);
+    printf("Message size: %d bytes per field\n", message_size);
+    printf("Number of threads: %d\n", num_threads);
+    printf("Run duration: %d seconds\n", run_duration);
+    printf("Mode: %s\n", pingpong ? "ping-pong (request/response)" : "streaming");
+    if (frame_checksum) printf("Verify: payload CRC32C per frame (%s kernel)\n", crc32c_kernel());
+    printf("Consumer: %s\n", consume_name(consume_profile));
+    printf("Sampling: every %d ms%s%s\n", ts_interval_ms,
+           timeseries_path ? " -> " : "", timeseries_path ? timeseries_path : "");
+    if (hw_counters && hwc_enable() < 0) hw_counters = 0;
+    if (transport->describe) transport->describe();
+    printf("\n");
+
+    // Allocate thread array
+    threads = (pthread_t*)malloc(num_threads * sizeof(pthread_t));
+    if (!threads) {
+        perror("Thread array allocation failed");
+        exit(EXIT_FAILURE);
+    }
+
+    // Per-interval sampler: steady-state rates without the warm-up
+    if (timeseries_start(timeseries_path, ts_interval_ms, num_threads) < 0) exit(EXIT_FAILURE);
+
+    // Time-stamp counter rate over the run, to express CPU time in cycles
+    uint64_t run_cycles = cycles_now();
+    uint64_t run_ns = monotonic_ns();
+
+    // Create client threads
+    for (int i = 0; i < num_threads; i++) {
+        int *thread_id = (int*)malloc(sizeof(int));
+        *thread_id = i + 1;
+
+        if (pthread_create(&threads[i], NULL, client_thread, thread_id) != 0) {
+            perror("Thread creation failed");
+            free(thread_id);
+            threads[i] = 0;
+            continue;
+        }
+
+        // Small delay between thread creation
+        usleep(10000);  // 10ms
+    }
+
+    // Wait for all threads to complete
+    for (int i = 0; i < num_threads; i++) {
+        ThreadStats *stats = NULL;
+        if (threads[i]) pthread_join(threads[i], (void**)&stats);
+
+        if (stats) {
+            aggregate.bytes_received += stats->bytes_received;
+            aggregate.messages_received += stats->messages_received;
+            aggregate.messages_lost += stats->messages_lost;
+            aggregate.cpu_ns += stats->cpu_ns;
+            aggregate.rx_mapped_bytes += stats->rx_mapped_bytes;
+            aggregate.rx_copied_bytes += stats->rx_copied_bytes;
+            aggregate.verify_cycles += stats->verify_cycles;
+            aggregate.consume_cycles += stats->consume_cycles;
+            aggregate.payload_bytes += stats->payload_bytes;
+            aggregate.crc_errors += stats->crc_errors;
+            hist_merge(&aggregate.latency, &stats->latency);
+            if (stats->elapsed_time > aggregate.elapsed_time) {
+                aggregate.elapsed_time = stats->elapsed_time;
+            }
+            free(stats);
+        }
+    }
+
+    run_ns = monotonic_ns() - run_ns;
+    TsSummary steady;
+    timeseries_stop(&steady);
+    double cycles_per_ns = run_ns ? (double)(cycles_now() - run_cycles) / run_ns : 1.0;
+
+    // Print aggregate statistics
+    printf("\n=== Aggregate Statistics ===\n");
+    printf("Total messages received: %ld\n", aggregate.messages_received);
+    printf("Total bytes received: %ld (%.2f MB)\n",
+           aggregate.bytes_received,
+           aggregate.bytes_received / (1024.0 * 1024.0));
+    printf("Aggregate throughput: %.2f MB/s\n",
+           (aggregate.bytes_received / (1024.0 * 1024.0)) / aggregate.elapsed_time);
+    printf("Received: %.2f MB mapped, %.2f MB copied\n",
+           aggregate.rx_mapped_bytes / (1024.0 * 1024.0),
+           aggregate.rx_copied_bytes / (1024.0 * 1024.0));
+    printf("Steady state: %.2f MB/s after %.2f s warm-up (%d of %d intervals, CV %.3f)\n",
+           steady.steady_gbps * 1e9 / 8 / (1024.0 * 1024.0), steady.warmup_s,
+           steady.steady_samples, steady.samples, steady.steady_cv);
+
+    // PA02 requirement: Output parseable metrics for script collection
+    double throughput_gbps = (aggregate.bytes_received * 8.0) / (aggregate.elapsed_time * 1e9);
+    // Tail latency from the merged per-thread histograms
+    char percentiles[160];
+    hist_format_metrics(&aggregate.latency, percentiles, sizeof(percentiles));
+    // Receive-side CPU cost: all client threads' CPU time per message
+    double cpu_us_per_msg = aggregate.messages_received
+                          ? aggregate.cpu_ns / 1e3 / aggregate.messages_received : 0.0;
+    // Cycles per byte: CRC32C verification and the consumer profile vs
+    // everything else the receive threads spent CPU on (syscalls, copies,
+    // framing) - the transport cost
+    double verify_cpb = aggregate.payload_bytes && frame_checksum
+                      ? (double)aggregate.verify_cycles / aggregate.payload_bytes : 0.0;
+    double consume_cpb = aggregate.payload_bytes && consume_profile != CONSUME_NONE
+                       ? (double)aggregate.consume_cycles / aggregate.payload_bytes : 0.0;
+    double transport_cycles = aggregate.cpu_ns * cycles_per_ns
+                            - (double)(aggregate.verify_cycles + aggregate.consume_cycles);
+    double transport_cpb = aggregate.bytes_received && transport_cycles > 0
+                         ? transport_cycles / aggregate.bytes_received : 0.0;
+    if (frame_checksum) {
+        printf("Verify (CRC32C %s): %.3f cycles/byte, %ld CRC errors\n",
+               crc32c_kernel(), verify_cpb, aggregate.crc_errors);
+    }
+    if (consume_profile != CONSUME_NONE) {
+        printf("Consume (%s): %.3f cycles/byte\n", consume_name(consume_profile), consume_cpb);
+    }
+    printf("Transport cost: %.3f cycles/byte\n", transport_cpb);
+    char verify[192];
+    snprintf(verify, sizeof(verify), "verify=%s verify_cpb=%.3f transport_cpb=%.3f crc_errors=%ld "
+             "consume=%s consume_cpb=%.3f",
+             frame_checksum ? crc32c_kernel() : "off", verify_cpb, transport_cpb,
+             aggregate.crc_errors, consume_name(consume_profile), consume_cpb);
+    char steady_rates[128];
+    timeseries_format_metrics(&steady, steady_rates, sizeof(steady_rates));
+    // Which threads paid for the run, in user and kernel mode
+    char hw[1024];
+    hwc_report("client", NULL);
+    hwc_format_metrics(hw, sizeof(hw));
+    // CPU placement of each server:client pair, to tie cache misses to topology
+    char placement[256];
+    affinity_format_metrics(num_threads, placement, sizeof(placement));
+    if (pingpong) {
+        // Ping-pong: latency is the measured mean round-trip time
+        printf("METRICS throughput_gbps=%.6f latency_us=%.2f bytes=%ld lost=%ld "
+               "rx_mapped=%ld rx_copied=%ld %s cpu_us_per_msg=%.3f %s %s %s %s mode=pingpong\n",
+               throughput_gbps, hist_mean_ns(&aggregate.latency) / 1e3,
+               aggregate.bytes_received, aggregate.messages_lost,
+               aggregate.rx_mapped_bytes, aggregate.rx_copied_bytes, percentiles,
+               cpu_us_per_msg, verify, steady_rates, hw, placement);
+    } else {
+        double latency_us = (aggregate.elapsed_time * 1e6) / aggregate.messages_received;
+        printf("METRICS throughput_gbps=%.6f latency_us=%.2f bytes=%ld lost=%ld "
+               "rx_mapped=%ld rx_copied=%ld %s cpu_us_per_msg=%.3f %s %s %s %s\n",
+               throughput_gbps, latency_us, aggregate.bytes_received, aggregate.messages_lost,
+               aggregate.rx_mapped_bytes, aggregate.rx_copied_bytes, percentiles,
+               cpu_us_per_msg, verify, steady_rates, hw, placement);
+    }
+
+    free(threads);
+    return 0;
+}
@@ -0,0 +1,138 @@
+/*
+ * Receiver workloads. See MT25190_Consumer.h.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "MT25190_Consumer.h"
+
+#define CACHE_LINE 64
+
+static const char *const profile_names[] = { "none", "sum", "random", "copy" };
+
+int consume_parse(const char *name) {
+    for (int i = 0; i < (int)(sizeof(profile_names) / sizeof(profile_names[0])); i++) {
+        if (strcmp(name, profile_names[i]) == 0) return i;
+    }
+    fprintf(stderr, "Unknown consumer '%s' (expected none|sum|random|copy)\n", name);
+    return -1;
+}
+
+const char* consume_name(int profile) {
+    return profile_names[profile];
+}
+
+int consumer_init(Consumer *c, int profile, size_t payload_bytes) {
+    memset(c, 0, sizeof(*c));
+    c->profile = profile;
+    c->rng = 0x9E3779B97F4A7C15ull ^ (uintptr_t)c;
+    if (profile == CONSUME_COPY) {
+        c->app_size = (payload_bytes + CACHE_LINE - 1) & ~(size_t)(CACHE_LINE - 1);
+        c->app = aligned_alloc(CACHE_LINE, c->app_size ? c->app_size : CACHE_LINE);
+        if (!c->app) {
+            perror("Application buffer allocation failed");
+            return -1;
+        }
+    }
+    return 0;
+}
+
+void consumer_destroy(Consumer *c) {
+    free(c->app);
+    c->app = NULL;
+}
+
+/*
+ * sum_words: Wrapping sum of the piece as 64-bit words (tail bytes added
+ * singly). Written with 512-bit GCC vectors and cloned per ISA, so the
+ * loader picks AVX-512, AVX2 or SSE2 code for this CPU.
+ */
+__attribute__((target_clones("avx512f", "avx2", "default")))
+static uint64_t sum_words(const unsigned char *p, size_t len) {
+    typedef uint64_t u64x8 __attribute__((vector_size(64)));
+    u64x8 acc0 = {0}, acc1 = {0};
+    size_t i = 0;
+    for (; i + 128 <= len; i += 128) {
+        u64x8 a, b;
+        memcpy(&a, p + i, sizeof(a));
+        memcpy(&b, p + i + 64, sizeof(b));
+        acc0 += a;
+        acc1 += b;
+    }
+    acc0 += acc1;
+    uint64_t sum = 0;
+    for (int k = 0; k < 8; k++) sum += acc0[k];
+    for (; i + 8 <= len; i += 8) {
+        uint64_t w;
+        memcpy(&w, p + i, sizeof(w));
+        sum += w;
+    }
+    for (; i < len; i++) sum += p[i];
+    return sum;
+}
+
+static uint64_t xorshift64(uint64_t *state) {
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return *state = x;
+}
+
+static size_t gcd(size_t a, size_t b) {
+    while (b) {
+        size_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+/*
+ * touch_random: Reads the first 8 bytes of every cache line of the piece
+ * once, visiting the lines in a random order (random start, stride
+ * coprime to the line count), as an application picking fields out of a
+ * message would. Every line is still pulled in, but not sequentially.
+ */
+static uint64_t touch_random(Consumer *c, const unsigned char *p, size_t len) {
+    size_t lines = len / CACHE_LINE;
+    uint64_t acc = 0;
+    if (lines > 0) {
+        uint64_t r = xorshift64(&c->rng);
+        size_t idx = (size_t)(r % lines);
+        size_t step = lines > 2 ? (size_t)((r >> 32) % (lines - 1)) + 1 : 1;
+        while (gcd(step, lines) != 1) step = step + 1 < lines ? step + 1 : 1;
+        for (size_t i = 0; i < lines; i++) {
+            uint64_t w;
+            memcpy(&w, p + idx * CACHE_LINE, sizeof(w));
+            acc = (acc << 1 | acc >> 63) ^ w;
+            idx += step;
+            if (idx >= lines) idx -= lines;
+        }
+    }
+    if (len % CACHE_LINE) acc ^= p[lines * CACHE_LINE];
+    return acc;
+}
+
+void consume(Consumer *c, size_t offset, const void *data, size_t len) {
+    const unsigned char *p = (const unsigned char*)data;
+    switch (c->profile) {
+    case CONSUME_SUM:
+        c->result += sum_words(p, len);
+        break;
+    case CONSUME_RANDOM:
+        c->result ^= touch_random(c, p, len);
+        break;
+    case CONSUME_COPY:
+        if (offset < c->app_size) {
+            if (len > c->app_size - offset) len = c->app_size - offset;
+            memcpy(c->app + offset, p, len);
+            c->result += (unsigned char)c->app[offset];
+        }
+        break;
+    default:
+        break;
+    }
+}
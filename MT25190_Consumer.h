@@ -0,0 +1,56 @@
+/*
+ * Receiver workloads run on every received payload (client --consume).
+ *
+ * Without one the clients never read what they receive, so a copy model
+ * that leaves the payload cold (mapped pages, DMA'd buffers) looks as
+ * cheap as one that just pulled it through the cache with a copy. The
+ * profiles model what an application does next:
+ *
+ *   none     discard (original behaviour)
+ *   sum      streaming read of every byte, vectorised 64-bit adds
+ *   random   one 8-byte field from every cache line, in a random order
+ *            (defeats the hardware prefetcher)
+ *   copy     copy-out into an application-owned message structure
+ *
+ * Payloads arrive as contiguous pieces (see PayloadSink in
+ * MT25190_Framing.h); a profile only ever sees one piece at a time, so it
+ * works the same on in-place mapped pages as on receive buffers.
+ */
+
+#ifndef MT25190_CONSUMER_H
+#define MT25190_CONSUMER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef enum {
+    CONSUME_NONE   = 0,
+    CONSUME_SUM    = 1,
+    CONSUME_RANDOM = 2,
+    CONSUME_COPY   = 3
+} ConsumeProfile;
+
+typedef struct {
+    int profile;
+    char *app;              // copy: application message (payload_bytes, cache-line aligned)
+    size_t app_size;
+    uint64_t rng;           // random: xorshift64 state
+    uint64_t result;        // Folded values read, so the reads cannot be optimised away
+} Consumer;
+
+/* consume_parse: "none|sum|random|copy" -> ConsumeProfile, -1 if unknown */
+int consume_parse(const char *name);
+const char* consume_name(int profile);
+
+/* consumer_init: Per-thread state for frames of 'payload_bytes'. -1 on failure */
+int consumer_init(Consumer *c, int profile, size_t payload_bytes);
+
+/*
+ * consume: Runs the profile over one contiguous piece of a payload
+ * 'offset' is the piece's position in the payload (where copy puts it).
+ */
+void consume(Consumer *c, size_t offset, const void *data, size_t len);
+
+void consumer_destroy(Consumer *c);
+
+#endif /* MT25190_CONSUMER_H */
@@ -0,0 +1,575 @@
+/*
+ * Event-loop server engine: N epoll workers with non-blocking sockets.
+ * See MT25190_EventLoop.h for the interface.
+ *
+ * WHY AN EVENT LOOP:
+ * - Thread-per-connection means one kernel-scheduled thread per socket;
+ *   at high connection counts the scheduler and context switches dominate
+ * - Here each worker multiplexes many sockets with epoll_wait(), so the
+ *   number of runnable threads stays at N (= cores) regardless of load
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <linux/filter.h>
+#include <time.h>
+#include <poll.h>
+#include <errno.h>
+
+#include "MT25190_EventLoop.h"
+#include "MT25190_Affinity.h"
+#include "MT25190_ServerStats.h"
+#include "MT25190_HwCounters.h"
+
+#define MAX_EVENTS 64
+#define EPOLL_TIMEOUT_MS 100    // Wake periodically to observe shutdown
+#define SEND_BUDGET 64          // Max messages per socket per wakeup (fairness)
+
+/* Per-connection state owned by exactly one worker */
+typedef struct {
+    int sockfd;
+    void *state;            // Strategy-specific message buffers
+    size_t offset;          // Bytes of the current message already sent
+    int begun;              // begin_message() ran for the current message
+    long messages_sent;
+    int open;
+    int parked;             // Waiting on the error queue, not on EPOLLOUT
+} Connection;
+
+/* Accept progress shared by reuseport workers (each accepts on its own) */
+typedef struct {
+    int connected;          // Updated atomically by all workers
+    int expected;
+    struct timespec start;  // Listeners opened; accept-phase timing starts
+} AcceptShare;
+
+/* One epoll worker thread */
+typedef struct {
+    int id;
+    int epfd;
+    pthread_t thread;
+    pthread_mutex_t lock;   // conns table: main() adds while the worker runs
+    Connection **conns;     // Connections assigned to this worker
+    int num_conns;
+    int cap_conns;
+    const EventLoopOps *ops;
+    volatile sig_atomic_t *running;
+    int listen_fd;          // Own SO_REUSEPORT listener, -1 if main() accepts
+    int accepted;           // Connections taken from listen_fd
+    AcceptShare *share;
+} Worker;
+
+int parse_engine(const char *name) {
+    if (strcmp(name, "thread") == 0) return ENGINE_THREAD;
+    if (strcmp(name, "epoll") == 0) return ENGINE_EPOLL;
+    if (strcmp(name, "reuseport") == 0) return ENGINE_REUSEPORT;
+    return -1;
+}
+
+const char* engine_name(int engine) {
+    switch (engine) {
+    case ENGINE_EPOLL:     return "epoll";
+    case ENGINE_REUSEPORT: return "reuseport (epoll, one listener per worker)";
+    default:               return "thread-per-connection";
+    }
+}
+
+int default_worker_count(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+}
+
+/*
+ * close_connection: Removes a socket from the worker's epoll set and frees it
+ */
+static void close_connection(Worker *w, Connection *c) {
+    if (!c->open) return;
+    epoll_ctl(w->epfd, EPOLL_CTL_DEL, c->sockfd, NULL);
+    printf("[Worker %d] fd %d total messages sent: %ld\n",
+           w->id, c->sockfd, c->messages_sent);
+    w->ops->conn_close(c->sockfd, c->state);
+    close(c->sockfd);
+    c->open = 0;
+}
+
+/*
+ * service_connection: Sends as much as the socket accepts (bounded by
+ * SEND_BUDGET complete messages) and keeps the partial-message offset
+ * so the next EPOLLOUT resumes exactly where the kernel stopped.
+ */
+static void service_connection(Worker *w, Connection *c) {
+    const EventLoopOps *ops = w->ops;
+    int completed = 0;
+
+    while (completed < SEND_BUDGET && *w->running) {
+        // Once per message: a retry after EAGAIN/ENOBUFS also starts at
+        // offset 0 but must resend the same message
+        if (!c->begun && ops->begin_message) {
+            ops->begin_message(c->state, (uint64_t)c->messages_sent);
+        }
+        c->begun = 1;
+        ssize_t n = ops->send_from(c->sockfd, c->state, c->offset);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return;  // Wait for EPOLLOUT
+            if (errno == EINTR) continue;
+            if (errno == ENOBUFS && ops->drain_errqueue) {
+                // Out of in-flight send buffers: stop polling for EPOLLOUT
+                // (it would spin) and wait for EPOLLERR from the error queue
+                struct epoll_event ev;
+                memset(&ev, 0, sizeof(ev));
+                ev.data.ptr = c;
+                epoll_ctl(w->epfd, EPOLL_CTL_MOD, c->sockfd, &ev);
+                c->parked = 1;
+                return;
+            }
+            if (errno != EPIPE && errno != ECONNRESET) perror("event loop send error");
+            close_connection(w, c);
+            return;
+        }
+
+        c->offset += (size_t)n;
+        if (c->offset >= (ops->message_length ? ops->message_length(c->state) : ops->message_bytes)) {
+            c->offset = 0;
+            c->begun = 0;
+            c->messages_sent++;
+            stats_message();
+            completed++;
+        }
+    }
+}
+
+static void accept_pending(Worker *w);
+
+static void* worker_main(void *arg) {
+    Worker *w = (Worker*)arg;
+    struct epoll_event events[MAX_EVENTS];
+    affinity_pin(w->id - 1);    // Worker i takes the server CPU of pair i
+    hwc_thread_begin();         // Counted until the worker exits (--hw-counters)
+
+    // Reuseport: the worker's own listener sits in the same epoll set
+    // (data.ptr NULL marks it; connections are never NULL)
+    if (w->listen_fd >= 0) {
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN;
+        ev.data.ptr = NULL;
+        if (epoll_ctl(w->epfd, EPOLL_CTL_ADD, w->listen_fd, &ev) < 0) {
+            perror("epoll_ctl ADD listener failed");
+            return NULL;
+        }
+    }
+
+    while (*w->running) {
+        int n = epoll_wait(w->epfd, events, MAX_EVENTS, EPOLL_TIMEOUT_MS);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            perror("epoll_wait failed");
+            break;
+        }
+
+        for (int i = 0; i < n; i++) {
+            Connection *c = (Connection*)events[i].data.ptr;
+            if (!c) {
+                accept_pending(w);
+                continue;
+            }
+            if (!c->open) continue;
+            if (events[i].events & EPOLLHUP) {
+                close_connection(w, c);
+                continue;
+            }
+            if (events[i].events & EPOLLERR) {
+                // EPOLLERR also signals a non-empty error queue (zerocopy
+                // completions); only a real socket error closes the connection
+                int err = 0;
+                socklen_t len = sizeof(err);
+                getsockopt(c->sockfd, SOL_SOCKET, SO_ERROR, &err, &len);
+                if (err != 0 || !w->ops->drain_errqueue) {
+                    close_connection(w, c);
+                    continue;
+                }
+                w->ops->drain_errqueue(c->sockfd, c->state);
+                if (c->parked) {
+                    // Completions freed buffers: resume write readiness
+                    struct epoll_event ev;
+                    memset(&ev, 0, sizeof(ev));
+                    ev.events = EPOLLOUT;
+                    ev.data.ptr = c;
+                    epoll_ctl(w->epfd, EPOLL_CTL_MOD, c->sockfd, &ev);
+                    c->parked = 0;
+                    service_connection(w, c);
+                    continue;
+                }
+            }
+            if (events[i].events & EPOLLOUT) {
+                service_connection(w, c);
+            }
+        }
+    }
+
+    pthread_mutex_lock(&w->lock);
+    for (int i = 0; i < w->num_conns; i++) {
+        close_connection(w, w->conns[i]);
+    }
+    pthread_mutex_unlock(&w->lock);
+    return NULL;
+}
+
+/*
+ * add_connection: Hands a freshly accepted socket to a worker.
+ * epoll_ctl() is thread-safe, so the accepting thread registers the
+ * socket directly in the worker's (possibly running) epoll set; the
+ * connection is complete before EPOLL_CTL_ADD, since the worker may
+ * service it at once.
+ */
+static int add_connection(Worker *w, int sockfd) {
+    int flags = fcntl(sockfd, F_GETFL, 0);
+    if (flags < 0 || fcntl(sockfd, F_SETFL, flags | O_NONBLOCK) < 0) {
+        perror("fcntl O_NONBLOCK failed");
+        return -1;
+    }
+
+    Connection *c = (Connection*)calloc(1, sizeof(Connection));
+    if (!c) {
+        perror("Failed to allocate connection");
+        return -1;
+    }
+    c->sockfd = sockfd;
+    c->state = w->ops->conn_open(sockfd);
+    if (!c->state) {
+        free(c);
+        return -1;
+    }
+    c->open = 1;
+
+    pthread_mutex_lock(&w->lock);
+    if (w->num_conns == w->cap_conns) {
+        int cap = w->cap_conns ? w->cap_conns * 2 : 16;
+        Connection **grown = (Connection**)realloc(w->conns, cap * sizeof(Connection*));
+        if (!grown) {
+            pthread_mutex_unlock(&w->lock);
+            perror("Failed to grow connection table");
+            w->ops->conn_close(sockfd, c->state);
+            free(c);
+            return -1;
+        }
+        w->conns = grown;
+        w->cap_conns = cap;
+    }
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLOUT;   // Level-triggered: fires while socket buffer has space
+    ev.data.ptr = c;
+    if (epoll_ctl(w->epfd, EPOLL_CTL_ADD, sockfd, &ev) < 0) {
+        pthread_mutex_unlock(&w->lock);
+        perror("epoll_ctl ADD failed");
+        w->ops->conn_close(sockfd, c->state);
+        free(c);
+        return -1;
+    }
+    w->conns[w->num_conns++] = c;
+    pthread_mutex_unlock(&w->lock);
+    return 0;
+}
+
+/*
+ * free_workers: After the workers have been joined: closes connections a
+ * worker never saw (added while it was shutting down), then the epoll
+ * sets, and frees everything
+ */
+static void free_workers(Worker *workers, int num_workers) {
+    for (int i = 0; i < num_workers; i++) {
+        for (int j = 0; j < workers[i].num_conns; j++) {
+            close_connection(&workers[i], workers[i].conns[j]);
+            free(workers[i].conns[j]);
+        }
+        free(workers[i].conns);
+        if (workers[i].epfd > 0) close(workers[i].epfd);
+        pthread_mutex_destroy(&workers[i].lock);
+    }
+    free(workers);
+}
+
+/*
+ * accept_pending: Drains the worker's own (non-blocking) listener; every
+ * connection stays on the worker, and so on the CPU, that accepted it
+ */
+static void accept_pending(Worker *w) {
+    AcceptShare *share = w->share;
+    for (;;) {
+        int client_sock = accept(w->listen_fd, NULL, NULL);
+        if (client_sock < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) perror("Accept failed");
+            return;
+        }
+        if (add_connection(w, client_sock) < 0) {
+            close(client_sock);
+            continue;
+        }
+        w->accepted++;
+
+        int total = __atomic_add_fetch(&share->connected, 1, __ATOMIC_RELAXED);
+        printf("Accepted connection %d on worker %d's listener\n", total, w->id);
+        if (total == share->expected) {
+            struct timespec now;
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            double ms = (now.tv_sec - share->start.tv_sec) * 1e3 +
+                        (now.tv_nsec - share->start.tv_nsec) / 1e6;
+            printf("\nAll %d clients connected in %.2f ms. Press Ctrl+C to stop.\n",
+                   total, ms);
+        }
+    }
+}
+
+int event_loop_run(int server_sock, int expected_clients, int num_workers,
+                   const EventLoopOps *ops, volatile sig_atomic_t *running) {
+    if (num_workers < 1) num_workers = 1;
+
+    // Peers disappearing must surface as EPIPE, not kill the process
+    signal(SIGPIPE, SIG_IGN);
+
+    Worker *workers = (Worker*)calloc(num_workers, sizeof(Worker));
+    if (!workers) {
+        perror("Failed to allocate workers");
+        return -1;
+    }
+
+    for (int i = 0; i < num_workers; i++) {
+        workers[i].id = i + 1;
+        workers[i].ops = ops;
+        workers[i].running = running;
+        workers[i].listen_fd = -1;
+        pthread_mutex_init(&workers[i].lock, NULL);
+        workers[i].epfd = epoll_create1(0);
+        if (workers[i].epfd < 0) {
+            perror("epoll_create1 failed");
+            free_workers(workers, num_workers);
+            return -1;
+        }
+    }
+
+    // Workers run from the start: every connection streams as soon as it
+    // is accepted, like a thread-engine handler, instead of idling until
+    // the last client has connected
+    int started = 0;
+    for (; started < num_workers; started++) {
+        if (pthread_create(&workers[started].thread, NULL, worker_main,
+                           &workers[started]) != 0) {
+            perror("Worker creation failed");
+            *running = 0;
+            break;
+        }
+    }
+
+    printf("Event loop: %d epoll workers, waiting for %d connections...\n\n",
+           num_workers, expected_clients);
+    struct timespec accept_start, accept_end;
+    clock_gettime(CLOCK_MONOTONIC, &accept_start);
+    int connected = 0;
+    while (connected < expected_clients && *running) {
+        // Bounded wait: accept() would restart after the shutdown signal
+        struct pollfd pfd = { .fd = server_sock, .events = POLLIN };
+        if (poll(&pfd, 1, EPOLL_TIMEOUT_MS) <= 0) continue;
+
+        struct sockaddr_in client_addr;
+        socklen_t client_len = sizeof(client_addr);
+        int client_sock = accept(server_sock, (struct sockaddr*)&client_addr, &client_len);
+        if (client_sock < 0) {
+            if (errno != EINTR) perror("Accept failed");
+            continue;
+        }
+
+        Worker *w = &workers[connected % num_workers];
+        if (add_connection(w, client_sock) < 0) {
+            close(client_sock);
+            continue;
+        }
+
+        printf("Accepted connection %d from %s:%d -> worker %d\n",
+               connected + 1,
+               inet_ntoa(client_addr.sin_addr),
+               ntohs(client_addr.sin_port),
+               w->id);
+        connected++;
+    }
+
+    // Serial accept phase, comparable with the reuseport engine's
+    if (connected == expected_clients) {
+        clock_gettime(CLOCK_MONOTONIC, &accept_end);
+        printf("\nAll %d clients connected in %.2f ms. Press Ctrl+C to stop.\n", connected,
+               (accept_end.tv_sec - accept_start.tv_sec) * 1e3 +
+               (accept_end.tv_nsec - accept_start.tv_nsec) / 1e6);
+    }
+
+    for (int i = 0; i < started; i++) pthread_join(workers[i].thread, NULL);
+    free_workers(workers, num_workers);
+    return started == num_workers ? 0 : -1;
+}
+
+/*
+ * open_listener: One more SO_REUSEPORT listener bound to 'addr'
+ * Returns the non-blocking socket, or -1 on failure.
+ */
+static int open_listener(const struct sockaddr_in *addr) {
+    int sock = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    if (sock < 0) {
+        perror("Socket creation failed");
+        return -1;
+    }
+    int opt = 1;
+    if (setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0 ||
+        setsockopt(sock, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) < 0) {
+        perror("setsockopt SO_REUSEPORT failed");
+        close(sock);
+        return -1;
+    }
+    if (bind(sock, (const struct sockaddr*)addr, sizeof(*addr)) < 0) {
+        perror("Bind failed (is SO_REUSEPORT set on the first listener?)");
+        close(sock);
+        return -1;
+    }
+    if (listen(sock, SOMAXCONN) < 0) {
+        perror("Listen failed");
+        close(sock);
+        return -1;
+    }
+    return sock;
+}
+
+/*
+ * attach_cpu_steering: Classic BPF program choosing the listener by the CPU
+ * that processes the incoming SYN. Listener i belongs to worker i, so each
+ * pinned worker's CPU maps to its own index; any other CPU falls back to
+ * cpu % num_workers.
+ *
+ *   ld  #cpu
+ *   jeq #cpu_0, 0, 1 ; ret #0
+ *   jeq #cpu_1, 0, 1 ; ret #1   ...
+ *   mod #num_workers ; ret a
+ */
+static int attach_cpu_steering(int listen_fd, int num_workers) {
+    int max_table = (BPF_MAXINSNS - 3) / 2;
+    int table = num_workers < max_table ? num_workers : max_table;
+    struct sock_filter *code = calloc(2 * table + 3, sizeof(struct sock_filter));
+    if (!code) {
+        perror("Failed to allocate BPF program");
+        return -1;
+    }
+
+    int len = 0;
+    int pinned = 0;
+    code[len++] = (struct sock_filter)BPF_STMT(BPF_LD | BPF_W | BPF_ABS, SKF_AD_OFF + SKF_AD_CPU);
+    for (int i = 0; i < table; i++) {
+        int cpu = affinity_cpu_for(AFFINITY_SERVER, i);
+        if (cpu < 0) break;     // Workers are not pinned: modulo only
+        code[len++] = (struct sock_filter)BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, cpu, 0, 1);
+        code[len++] = (struct sock_filter)BPF_STMT(BPF_RET | BPF_K, i);
+        pinned++;
+    }
+    code[len++] = (struct sock_filter)BPF_STMT(BPF_ALU | BPF_MOD | BPF_K, num_workers);
+    code[len++] = (struct sock_filter)BPF_STMT(BPF_RET | BPF_A, 0);
+
+    struct sock_fprog prog = { .len = (unsigned short)len, .filter = code };
+    int rc = setsockopt(listen_fd, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog, sizeof(prog));
+    free(code);
+    if (rc < 0) {
+        perror("SO_ATTACH_REUSEPORT_CBPF failed");
+        return -1;
+    }
+    if (pinned == 0) {
+        fprintf(stderr, "reuseport-bpf: workers are not pinned (--affinity), "
+                        "steering by cpu %% %d only\n", num_workers);
+    }
+    return 0;
+}
+
+int event_loop_run_reuseport(int server_sock, int expected_clients, int num_workers,
+                             int steer_by_cpu, const EventLoopOps *ops,
+                             volatile sig_atomic_t *running) {
+    if (num_workers < 1) num_workers = 1;
+    signal(SIGPIPE, SIG_IGN);
+
+    // Every other listener joins the group of the already-listening one
+    struct sockaddr_in addr;
+    socklen_t addr_len = sizeof(addr);
+    if (getsockname(server_sock, (struct sockaddr*)&addr, &addr_len) < 0) {
+        perror("getsockname failed");
+        return -1;
+    }
+    int flags = fcntl(server_sock, F_GETFL, 0);
+    if (flags < 0 || fcntl(server_sock, F_SETFL, flags | O_NONBLOCK) < 0) {
+        perror("fcntl O_NONBLOCK failed");
+        return -1;
+    }
+
+    AcceptShare share = { .connected = 0, .expected = expected_clients };
+    Worker *workers = (Worker*)calloc(num_workers, sizeof(Worker));
+    if (!workers) {
+        perror("Failed to allocate workers");
+        return -1;
+    }
+
+    // Listener i is index i of the reuseport group (listen() order), which
+    // is what the steering program returns for worker i's CPU
+    int ready = 0;
+    for (int i = 0; i < num_workers; i++) {
+        workers[i].id = i + 1;
+        workers[i].ops = ops;
+        workers[i].running = running;
+        workers[i].share = &share;
+        pthread_mutex_init(&workers[i].lock, NULL);
+        workers[i].listen_fd = i == 0 ? server_sock : open_listener(&addr);
+        if (workers[i].listen_fd < 0) break;
+        workers[i].epfd = epoll_create1(0);
+        if (workers[i].epfd < 0) {
+            perror("epoll_create1 failed");
+            if (i > 0) close(workers[i].listen_fd);
+            workers[i].listen_fd = -1;
+            break;
+        }
+        ready++;
+    }
+    if (ready == num_workers && steer_by_cpu &&
+        attach_cpu_steering(server_sock, num_workers) < 0) {
+        ready = -1;
+    }
+    if (ready != num_workers) {
+        for (int j = 0; j < num_workers && workers[j].id; j++) {
+            if (j > 0 && workers[j].listen_fd >= 0) close(workers[j].listen_fd);
+        }
+        free_workers(workers, num_workers);
+        return -1;
+    }
+
+    printf("Reuseport: %d workers with their own listeners%s, waiting for %d connections...\n\n",
+           num_workers, steer_by_cpu ? " (CPU-steered)" : " (hash-steered)", expected_clients);
+    clock_gettime(CLOCK_MONOTONIC, &share.start);
+
+    int started = 0;
+    for (; started < num_workers; started++) {
+        if (pthread_create(&workers[started].thread, NULL, worker_main,
+                           &workers[started]) != 0) {
+            perror("Worker creation failed");
+            *running = 0;
+            break;
+        }
+    }
+
+    for (int i = 0; i < started; i++) pthread_join(workers[i].thread, NULL);
+    for (int i = 0; i < num_workers; i++) {
+        printf("[Worker %d] accepted %d connections on its listener\n",
+               workers[i].id, workers[i].accepted);
+        if (i > 0) close(workers[i].listen_fd);
+    }
+    free_workers(workers, num_workers);
+    return started == num_workers ? 0 : -1;
+}
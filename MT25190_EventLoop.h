@@ -0,0 +1,114 @@
+/*
+ * Event-loop server engine shared by the A1/A2/A3/A5 servers.
+ *
+ * The default servers spawn one blocking pthread per accepted socket.
+ * This engine instead runs N worker threads (default: one per online CPU),
+ * each owning its own epoll set. Accepted sockets are switched to
+ * non-blocking mode and distributed round-robin across the workers, which
+ * push messages whenever their sockets become writable.
+ *
+ * --engine=reuseport shards accept() as well: every worker owns an
+ * SO_REUSEPORT listener on the same port and accepts its own connections.
+ *
+ * The copy strategy being measured plugs in through EventLoopOps, so the
+ * send primitive (send / sendmsg+iovec / MSG_ZEROCOPY) is unchanged - only
+ * the threading model around it differs.
+ */
+
+#ifndef MT25190_EVENTLOOP_H
+#define MT25190_EVENTLOOP_H
+
+#include <signal.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+typedef struct {
+    /* Allocate per-connection send state (message buffers). NULL on failure */
+    void *(*conn_open)(int sockfd);
+
+    /*
+     * Send the unsent part of the current message, starting 'offset' bytes
+     * into it. Returns the number of bytes the kernel accepted, or -1 with
+     * errno set (EAGAIN/EWOULDBLOCK when the socket buffer is full,
+     * ENOBUFS when every send buffer is still referenced by the kernel and
+     * the socket should wait for error-queue completions instead).
+     */
+    ssize_t (*send_from)(int sockfd, void *state, size_t offset);
+
+    /*
+     * Optional: called once per message, before its first send_from(), with
+     * the connection's message number, so the strategy can stamp the frame
+     * header (seq, send timestamp) before any byte of it leaves. Retries of
+     * the same message (EAGAIN, ENOBUFS) do not call it again.
+     */
+    void (*begin_message)(void *state, uint64_t seq);
+
+    /*
+     * Optional: called when EPOLLERR fires without a pending socket error,
+     * i.e. the error queue holds notifications (MSG_ZEROCOPY completions).
+     * Must drain the error queue, otherwise EPOLLERR stays level-triggered.
+     */
+    void (*drain_errqueue)(int sockfd, void *state);
+
+    /* Release per-connection send state */
+    void (*conn_close)(int sockfd, void *state);
+
+    /* Bytes in one complete message (8 fields) */
+    size_t message_bytes;
+
+    /*
+     * Optional: bytes in the current message when they vary per message
+     * (chosen in begin_message); message_bytes is used otherwise.
+     */
+    size_t (*message_length)(void *state);
+} EventLoopOps;
+
+/* Engine selection shared by all servers (--engine=thread|epoll|reuseport) */
+typedef enum {
+    ENGINE_THREAD    = 0,   // One blocking pthread per connection (original model)
+    ENGINE_EPOLL     = 1,   // N epoll workers with non-blocking sockets
+    ENGINE_REUSEPORT = 2    // epoll workers, each accepting on its own SO_REUSEPORT listener
+} ServerEngine;
+
+/*
+ * parse_engine: Maps "thread"/"epoll"/"reuseport" to a ServerEngine.
+ * Returns -1 for an unknown name.
+ */
+int parse_engine(const char *name);
+
+/* engine_name: Human-readable engine name for the startup banner */
+const char* engine_name(int engine);
+
+/*
+ * default_worker_count: Number of online CPUs (at least 1)
+ */
+int default_worker_count(void);
+
+/*
+ * event_loop_run: Accepts 'expected_clients' connections on 'server_sock'
+ * and serves them from 'num_workers' epoll threads until *running becomes 0.
+ * The workers start first, so each connection streams from its accept()
+ * on rather than after the last client has connected.
+ * Returns 0 on success, -1 if the engine could not be started.
+ */
+int event_loop_run(int server_sock, int expected_clients, int num_workers,
+                   const EventLoopOps *ops, volatile sig_atomic_t *running);
+
+/*
+ * event_loop_run_reuseport: Accept sharding. 'server_sock' must have been
+ * bound with SO_REUSEPORT and be listening; it becomes worker 1's listener
+ * and num_workers - 1 more listeners join its reuseport group. Each worker
+ * accepts on its own listener from its own epoll set, so there is no
+ * serial accept loop and a connection is served by the worker (and CPU,
+ * with --affinity) that accepted it.
+ * steer_by_cpu attaches a classic BPF program that picks the listener of
+ * the worker pinned to the CPU handling the SYN (the RX-queue CPU; on
+ * loopback, the connecting thread's CPU); otherwise the kernel hashes the
+ * 4-tuple. Returns 0 on success, -1 if the engine could not be started.
+ */
+int event_loop_run_reuseport(int server_sock, int expected_clients, int num_workers,
+                             int steer_by_cpu, const EventLoopOps *ops,
+                             volatile sig_atomic_t *running);
+
+#endif /* MT25190_EVENTLOOP_H */
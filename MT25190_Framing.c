@@ -0,0 +1,105 @@
+/*
+ * Frame reassembly and loss accounting. See MT25190_Framing.h.
+ */
+
+#include <string.h>
+
+#include "MT25190_Framing.h"
+
+void frame_assembler_init(FrameAssembler *fa, size_t capacity) {
+    memset(fa, 0, sizeof(*fa));
+    fa->capacity = capacity;
+}
+
+/*
+ * parse_header: Validates fa->header once all of its bytes are in place
+ * The frame must fit the receive buffer and must not be shorter than what
+ * was already read into it (that would mean we consumed the next frame).
+ */
+static int parse_header(FrameAssembler *fa) {
+    size_t length = fa->header.length;
+    if (fa->header.magic != FRAME_MAGIC || length < sizeof(FrameHeader) ||
+        length > fa->capacity || length < fa->filled) {
+        return FRAME_INVALID;
+    }
+    fa->length = length;
+    return FRAME_PARTIAL;
+}
+
+/*
+ * complete_frame: Sequence accounting for a frame whose bytes all arrived
+ */
+static int complete_frame(FrameAssembler *fa) {
+    uint64_t seq = fa->header.seq;
+    if (seq >= fa->next_seq) {
+        fa->lost += (long)(seq - fa->next_seq);
+        fa->next_seq = seq + 1;
+    } else {
+        fa->reordered++;
+    }
+    fa->frames++;
+    fa->filled = 0;
+    fa->length = 0;
+    return FRAME_COMPLETE;
+}
+
+int frame_received(FrameAssembler *fa, const void *frame, size_t n) {
+    fa->filled += n;
+
+    if (fa->length == 0) {
+        if (fa->filled < sizeof(FrameHeader)) return FRAME_PARTIAL;
+        memcpy(&fa->header, frame, sizeof(fa->header));
+        if (parse_header(fa) == FRAME_INVALID) return FRAME_INVALID;
+    }
+    if (fa->filled < fa->length) return FRAME_PARTIAL;
+
+    // Whole frame in place: check its position in the sequence
+    return complete_frame(fa);
+}
+
+size_t frame_consume(FrameAssembler *fa, const void *data, size_t n, int *status) {
+    const char *p = (const char*)data;
+    size_t used = 0;
+
+    if (fa->length == 0) {
+        // Stage the header bytes; the rest of the frame is never copied
+        size_t take = sizeof(FrameHeader) - fa->filled;
+        if (take > n) take = n;
+        memcpy((char*)&fa->header + fa->filled, p, take);
+        fa->filled += take;
+        used = take;
+        if (fa->filled < sizeof(FrameHeader)) {
+            *status = FRAME_PARTIAL;
+            return used;
+        }
+        if (parse_header(fa) == FRAME_INVALID) {
+            *status = FRAME_INVALID;
+            return used;
+        }
+    }
+
+    size_t take = fa->length - fa->filled;
+    if (take > n - used) take = n - used;
+    if (fa->sink && take > 0) fa->sink(fa->sink_ctx, fa->filled - sizeof(FrameHeader), p + used, take);
+    fa->filled += take;
+    used += take;
+
+    *status = fa->filled < fa->length ? FRAME_PARTIAL : complete_frame(fa);
+    return used;
+}
+
+int frame_datagram(FrameAssembler *fa, const void *data, size_t n) {
+    if (n < sizeof(FrameHeader)) return FRAME_INVALID;
+    memcpy(&fa->header, data, sizeof(fa->header));
+    fa->filled = n;
+    if (parse_header(fa) == FRAME_INVALID || fa->length != n) {
+        fa->filled = 0;
+        fa->length = 0;
+        return FRAME_INVALID;
+    }
+
+    long reordered = fa->reordered;
+    complete_frame(fa);
+    if (fa->reordered != reordered && fa->lost > 0) fa->lost--;
+    return FRAME_COMPLETE;
+}
@@ -0,0 +1,162 @@
+/*
+ * Length-prefixed framing shared by all servers and clients.
+ *
+ * TCP is a byte stream: one recv() may return half a message or several.
+ * Every message the servers send is therefore one frame whose first bytes
+ * are a FrameHeader, written in place into the start of field 1 / slot:
+ *
+ *   +-------+--------+-----+---------+-----+-------+-------------------+
+ *   | magic | length | seq | send_ns | crc | flags | rest of 8 fields  |
+ *   +-------+--------+-----+---------+-----+-------+-------------------+
+ *   |<------------- FrameHeader (32B) ------------>|<---- payload ---->|
+ *   |<------------------------ length bytes -------------------------->|
+ *
+ * Receivers run a FrameAssembler over the stream: they read straight into
+ * the frame's final location (no staging buffer, no copy) and the
+ * assembler tells them how many bytes the current frame still needs.
+ * Stream bytes that are already in memory (an mmap()ed receive window)
+ * are parsed in place with frame_consume() instead.
+ * A frame counts as one message only once all 'length' bytes arrived, and
+ * gaps in 'seq' are reported as lost messages.
+ * Datagram transports (A7) carry exactly one frame per datagram and account
+ * each one with frame_datagram() instead.
+ */
+
+#ifndef MT25190_FRAMING_H
+#define MT25190_FRAMING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define FRAME_MAGIC 0x4D543235u     // "MT25"
+#define FRAME_F_CRC32C 0x1u         // 'crc' holds the payload CRC32C (server --checksum)
+
+typedef struct {
+    uint32_t magic;     // FRAME_MAGIC: detects a desynchronised stream
+    uint32_t length;    // Whole frame, header included
+    uint64_t seq;       // Message number on this connection (0, 1, 2, ...)
+    uint64_t send_ns;   // Sender CLOCK_MONOTONIC timestamp (or echoed request time)
+    uint32_t crc;       // CRC32C of the payload (bytes after the header) if sealed
+    uint32_t flags;     // FRAME_F_*
+} FrameHeader;
+
+/*
+ * frame_stamp: Writes the header into the first bytes of a frame
+ * The caller's buffer must hold at least sizeof(FrameHeader) contiguous bytes.
+ */
+static inline void frame_stamp(void *frame, uint32_t length, uint64_t seq, uint64_t send_ns) {
+    FrameHeader hdr = { FRAME_MAGIC, length, seq, send_ns, 0, 0 };
+    memcpy(frame, &hdr, sizeof(hdr));
+}
+
+/*
+ * frame_seal: Records the payload CRC32C in a stamped header
+ * The header itself is not covered (seq and send_ns change per message
+ * while the payload usually does not), so senders compute the CRC once
+ * per payload buffer and seal every frame sent from it.
+ */
+static inline void frame_seal(void *frame, uint32_t payload_crc) {
+    FrameHeader *hdr = (FrameHeader*)frame;
+    uint32_t flags = FRAME_F_CRC32C;
+    memcpy(&hdr->crc, &payload_crc, sizeof(payload_crc));
+    memcpy(&hdr->flags, &flags, sizeof(flags));
+}
+
+/*
+ * frame_age_ns: now - header timestamp, clamped at 0
+ * Streaming: one-way delay from the sender's stamp (valid when both ends
+ * share CLOCK_MONOTONIC, i.e. the same host). Ping-pong: the header echoes
+ * the client's request time, so this is the round-trip time.
+ */
+static inline uint64_t frame_age_ns(const FrameHeader *hdr, uint64_t now_ns) {
+    return now_ns > hdr->send_ns ? now_ns - hdr->send_ns : 0;
+}
+
+/*
+ * PayloadSink: Consumer of payload bytes (everything after the header),
+ * called once per contiguous piece in stream order; 'offset' is relative
+ * to the start of the payload, so offset 0 begins a new frame.
+ */
+typedef void (*PayloadSink)(void *ctx, size_t offset, const void *data, size_t len);
+
+/* Result of frame_received() */
+enum {
+    FRAME_INVALID  = -1,    // Bad magic/length: sender and receiver disagree
+    FRAME_PARTIAL  = 0,     // More bytes of the current frame are needed
+    FRAME_COMPLETE = 1      // A whole frame arrived; its header is in frame_header()
+};
+
+typedef struct {
+    size_t capacity;        // Largest acceptable frame (receive buffer size)
+    size_t filled;          // Bytes of the current frame received so far
+    size_t length;          // Current frame length (0 until its header arrived)
+    uint64_t next_seq;      // Sequence number expected next
+    FrameHeader header;     // Header of the last completed frame
+    long frames;            // Complete frames received
+    long lost;              // Frames skipped by a forward gap in seq
+    long reordered;         // Frames that arrived with seq below next_seq
+    PayloadSink sink;       // Optional: sees payload bytes frame_consume() parses in place
+    void *sink_ctx;
+} FrameAssembler;
+
+/*
+ * frame_assembler_init: 'capacity' is the receive buffer size, normally
+ * exactly one expected frame (8 * message_size).
+ */
+void frame_assembler_init(FrameAssembler *fa, size_t capacity);
+
+/*
+ * frame_want: Bytes to read next into the frame at offset fa->filled
+ * Before the header has arrived this is the rest of 'capacity', so a
+ * stream of equally sized frames needs one read per frame; afterwards it
+ * never crosses into the following frame.
+ */
+static inline size_t frame_want(const FrameAssembler *fa) {
+    return (fa->length ? fa->length : fa->capacity) - fa->filled;
+}
+
+/*
+ * frame_received: Accounts for 'n' bytes that were read into the frame
+ * 'frame' points at the frame's first byte (where the header lands).
+ * Returns FRAME_COMPLETE, FRAME_PARTIAL or FRAME_INVALID.
+ */
+int frame_received(FrameAssembler *fa, const void *frame, size_t n);
+
+/*
+ * frame_consume: Parses 'n' stream bytes at 'data' in place
+ * Only the header bytes are copied (into fa->header; a header may straddle
+ * two calls), the payload is just counted and handed to fa->sink if set:
+ * in-place bytes may be gone once the caller fetches more, so this is the
+ * only chance to read them. Stops at the end of the current frame and
+ * stores FRAME_COMPLETE, FRAME_PARTIAL or FRAME_INVALID in *status.
+ * Returns the number of bytes consumed.
+ */
+size_t frame_consume(FrameAssembler *fa, const void *data, size_t n, int *status);
+
+/*
+ * frame_datagram: Accounts one datagram that must carry exactly one frame
+ * Datagram boundaries are frame boundaries, so no state carries over: a
+ * short, truncated or corrupt datagram is FRAME_INVALID and the next one
+ * starts afresh. A late frame (seq below next_seq) counts as reordered and
+ * fills the gap it was counted as lost in (datagrams are never duplicated
+ * on the paths measured here).
+ * Returns FRAME_COMPLETE or FRAME_INVALID.
+ */
+int frame_datagram(FrameAssembler *fa, const void *data, size_t n);
+
+/*
+ * frame_assembler_set_sink: Payload consumer for frame_consume() (NULL: none)
+ * frame_received() callers own the frame buffer and visit it once complete.
+ */
+static inline void frame_assembler_set_sink(FrameAssembler *fa, PayloadSink sink, void *ctx) {
+    fa->sink = sink;
+    fa->sink_ctx = ctx;
+}
+
+/* frame_header: Header of the most recently completed frame */
+static inline const FrameHeader* frame_header(const FrameAssembler *fa) {
+    return &fa->header;
+}
+
+#endif /* MT25190_FRAMING_H */
@@ -0,0 +1,65 @@
+/*
+ * Log-linear latency histogram. See MT25190_Histogram.h.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "MT25190_Histogram.h"
+
+void hist_init(LatencyHistogram *h) {
+    memset(h, 0, sizeof(*h));
+}
+
+void hist_merge(LatencyHistogram *dst, const LatencyHistogram *src) {
+    if (src->total == 0) return;
+    for (int i = 0; i < HIST_BUCKETS; i++) {
+        dst->counts[i] += src->counts[i];
+    }
+    if (dst->total == 0 || src->min_ns < dst->min_ns) dst->min_ns = src->min_ns;
+    if (src->max_ns > dst->max_ns) dst->max_ns = src->max_ns;
+    dst->sum_ns += src->sum_ns;
+    dst->total += src->total;
+}
+
+/*
+ * bucket_upper_ns: Largest value that maps into bucket 'idx'
+ */
+static uint64_t bucket_upper_ns(int idx) {
+    if (idx < HIST_SUB_BUCKETS) return (uint64_t)idx;
+    int shift = idx / HIST_SUB_BUCKETS - 1;
+    uint64_t sub = (uint64_t)(idx % HIST_SUB_BUCKETS) + HIST_SUB_BUCKETS;
+    return ((sub + 1) << shift) - 1;
+}
+
+uint64_t hist_percentile_ns(const LatencyHistogram *h, double p) {
+    if (h->total == 0) return 0;
+
+    // Rank of the sample at percentile p (1-based, rounded up)
+    uint64_t rank = (uint64_t)((p / 100.0) * (double)h->total + 0.999999);
+    if (rank < 1) rank = 1;
+    if (rank > h->total) rank = h->total;
+
+    uint64_t seen = 0;
+    for (int i = 0; i < HIST_BUCKETS; i++) {
+        seen += h->counts[i];
+        if (seen >= rank) {
+            uint64_t v = bucket_upper_ns(i);
+            return v > h->max_ns ? h->max_ns : v;
+        }
+    }
+    return h->max_ns;
+}
+
+double hist_mean_ns(const LatencyHistogram *h) {
+    return h->total ? h->sum_ns / (double)h->total : 0.0;
+}
+
+void hist_format_metrics(const LatencyHistogram *h, char *buf, size_t len) {
+    snprintf(buf, len, "p50_us=%.2f p90_us=%.2f p99_us=%.2f p999_us=%.2f max_us=%.2f",
+             hist_percentile_ns(h, 50.0) / 1e3,
+             hist_percentile_ns(h, 90.0) / 1e3,
+             hist_percentile_ns(h, 99.0) / 1e3,
+             hist_percentile_ns(h, 99.9) / 1e3,
+             h->max_ns / 1e3);
+}
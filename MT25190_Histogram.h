@@ -0,0 +1,102 @@
+/*
+ * HDR-style log-linear latency histogram shared by all clients.
+ *
+ * Values (nanoseconds) are bucketed by power of two, and each power of two
+ * is split into HIST_SUB_BUCKETS linear sub-buckets, giving a fixed relative
+ * precision of ~1/HIST_SUB_BUCKETS (about 3%) from 1ns up to 2^63ns:
+ *
+ *   [0..31] exact | [32..63] step 1 | [64..127] step 2 | [128..255] step 4 ...
+ *
+ * Each client thread owns one histogram (a fixed array, no allocation and
+ * no locks on the hot path); main() merges them after pthread_join().
+ */
+
+#ifndef MT25190_HISTOGRAM_H
+#define MT25190_HISTOGRAM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+#define HIST_SUB_BUCKET_BITS 5
+#define HIST_SUB_BUCKETS (1 << HIST_SUB_BUCKET_BITS)
+#define HIST_MAGNITUDES (64 - HIST_SUB_BUCKET_BITS + 1)
+#define HIST_BUCKETS (HIST_MAGNITUDES * HIST_SUB_BUCKETS)
+
+typedef struct {
+    uint64_t counts[HIST_BUCKETS];
+    uint64_t total;         // Number of recorded values
+    uint64_t min_ns;
+    uint64_t max_ns;        // Exact maximum (not bucketed)
+    double sum_ns;          // For the mean
+} LatencyHistogram;
+
+/* monotonic_ns: CLOCK_MONOTONIC in nanoseconds */
+static inline uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/* thread_cpu_ns: CPU time (user + system) consumed by the calling thread */
+static inline uint64_t thread_cpu_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/*
+ * cycles_now: Time-stamp counter (constant rate on current x86), for
+ * cycles-per-byte costs; CLOCK_MONOTONIC nanoseconds elsewhere
+ */
+static inline uint64_t cycles_now(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#else
+    return monotonic_ns();
+#endif
+}
+
+/*
+ * hist_bucket_index: Maps a value to its log-linear bucket
+ */
+static inline int hist_bucket_index(uint64_t value_ns) {
+    if (value_ns < HIST_SUB_BUCKETS) return (int)value_ns;
+    int msb = 63 - __builtin_clzll(value_ns);
+    int shift = msb - HIST_SUB_BUCKET_BITS;
+    int sub = (int)(value_ns >> shift) - HIST_SUB_BUCKETS;   // 0..SUB_BUCKETS-1
+    return (shift + 1) * HIST_SUB_BUCKETS + sub;
+}
+
+/*
+ * hist_record: Records one latency sample (hot path: a few instructions)
+ */
+static inline void hist_record(LatencyHistogram *h, uint64_t value_ns) {
+    h->counts[hist_bucket_index(value_ns)]++;
+    if (h->total == 0 || value_ns < h->min_ns) h->min_ns = value_ns;
+    if (value_ns > h->max_ns) h->max_ns = value_ns;
+    h->sum_ns += (double)value_ns;
+    h->total++;
+}
+
+void hist_init(LatencyHistogram *h);
+
+/* hist_merge: Adds every sample of 'src' into 'dst' */
+void hist_merge(LatencyHistogram *dst, const LatencyHistogram *src);
+
+/*
+ * hist_percentile_ns: Value at percentile 'p' (0-100), reported as the
+ * upper edge of its bucket (clamped to the exact max). 0 if empty.
+ */
+uint64_t hist_percentile_ns(const LatencyHistogram *h, double p);
+
+/* hist_mean_ns: Mean of all samples, 0 if empty */
+double hist_mean_ns(const LatencyHistogram *h);
+
+/*
+ * hist_format_metrics: Writes the METRICS percentile fields:
+ *   "p50_us=.. p90_us=.. p99_us=.. p999_us=.. max_us=.."
+ */
+void hist_format_metrics(const LatencyHistogram *h, char *buf, size_t len);
+
+#endif /* MT25190_HISTOGRAM_H */
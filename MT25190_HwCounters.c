@@ -0,0 +1,378 @@
+/*
+ * Per-thread perf_event_open() counters. See MT25190_HwCounters.h.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+#include "MT25190_HwCounters.h"
+
+#define HWC_MAX_PMUS 2          // cpu_core + cpu_atom on hybrid parts
+#define HWC_USER 0
+#define HWC_KERNEL 1
+#define HWC_PMU_TYPE_SHIFT 32   // Extended hardware type (PERF_PMU_TYPE_SHIFT)
+#define HWC_WAIT_STEP_MS 10
+
+static const char *event_keys[HWC_NUM_EVENTS] = {
+    "cycles", "instructions", "cache_misses", "llc_misses", "dtlb_misses"
+};
+
+#define CACHE_READ_MISS(cache) \
+    ((cache) | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16))
+
+static const struct {
+    uint32_t type;
+    uint64_t config;
+} event_attrs[HWC_NUM_EVENTS] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HW_CACHE, CACHE_READ_MISS(PERF_COUNT_HW_CACHE_LL)},
+    {PERF_TYPE_HW_CACHE, CACHE_READ_MISS(PERF_COUNT_HW_CACHE_DTLB)},
+};
+
+/* Core PMUs: one generic "cpu", or the core types of a hybrid CPU */
+static struct {
+    const char *name;
+    uint64_t ext_type;          // 0: generic PERF_TYPE_HARDWARE
+} pmus[HWC_MAX_PMUS];
+static int num_pmus;
+
+static int enabled;
+static unsigned supported;      // Bit per HwEvent that opened in the probe
+static pthread_key_t thread_key;
+static int next_index;          // Threads numbered in start order
+
+/* One group: the events that opened, in open (= read) order */
+typedef struct {
+    int leader;
+    int fds[HWC_NUM_EVENTS];
+    HwEvent events[HWC_NUM_EVENTS];
+    int count;
+} HwGroup;
+
+/* A running thread's counters */
+typedef struct {
+    HwGroup groups[2][HWC_MAX_PMUS];    // [user/kernel][pmu]
+    int ctx_fd;
+    int index;
+    long tid;
+} HwThread;
+
+/* An exited thread's final counts */
+typedef struct {
+    int index;
+    long tid;
+    HwCounts counts;
+} HwRecord;
+
+static pthread_mutex_t records_lock = PTHREAD_MUTEX_INITIALIZER;
+static HwRecord *records;
+static int num_records, cap_records;
+
+static int open_event(uint32_t type, uint64_t config, int level, int group_fd) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = group_fd < 0;       // The leader starts the whole group
+    attr.exclude_user = level == HWC_KERNEL;
+    attr.exclude_kernel = level == HWC_USER;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                       PERF_FORMAT_TOTAL_TIME_RUNNING;
+    // This thread only (pid 0), on whichever CPU it runs
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, PERF_FLAG_FD_CLOEXEC);
+}
+
+/* open_group: Opens every event the PMU accepts; the first one leads */
+static void open_group(HwGroup *g, int level, int pmu) {
+    g->leader = -1;
+    g->count = 0;
+    for (int e = 0; e < HWC_NUM_EVENTS; e++) {
+        uint64_t config = event_attrs[e].config | (pmus[pmu].ext_type << HWC_PMU_TYPE_SHIFT);
+        int fd = open_event(event_attrs[e].type, config, level, g->leader);
+        if (fd < 0) continue;
+        if (g->leader < 0) g->leader = fd;
+        g->fds[g->count] = fd;
+        g->events[g->count++] = (HwEvent)e;
+    }
+}
+
+static void close_group(HwGroup *g) {
+    for (int i = 0; i < g->count; i++) close(g->fds[i]);
+    g->count = 0;
+    g->leader = -1;
+}
+
+/*
+ * read_group: Adds the group's counts to 'out' and returns its
+ * time_enabled / time_running. Only the generic PMU is scaled for
+ * multiplexing: a hybrid core-type group is enabled for the whole run but
+ * runs only while the thread is on that core type, so scaling would count
+ * every core type as if the thread had spent the whole run on it. Those
+ * raw counts are summed over the core types instead, and the summed
+ * running time says how much of the run they cover (running_pct).
+ */
+static void read_group(const HwGroup *g, uint64_t *out, uint64_t *enabled, uint64_t *running) {
+    *enabled = *running = 0;
+    if (g->leader < 0) return;
+    uint64_t buf[3 + HWC_NUM_EVENTS];   // nr, time_enabled, time_running, values
+    if (read(g->leader, buf, sizeof(buf)) < (ssize_t)(3 * sizeof(uint64_t))) return;
+    uint64_t nr = buf[0], time_enabled = buf[1], time_running = buf[2];
+    *enabled = time_enabled;
+    *running = time_running;
+    if (time_running == 0) return;      // Never got onto the PMU
+    double scale = num_pmus > 1 ? 1.0 : (double)time_enabled / (double)time_running;
+    for (uint64_t i = 0; i < nr && i < (uint64_t)g->count; i++) {
+        out[g->events[i]] += (uint64_t)((double)buf[3 + i] * scale);
+    }
+}
+
+/* thread_exit: pthread key destructor, runs when a counted thread exits */
+static void thread_exit(void *arg) {
+    HwThread *t = (HwThread*)arg;
+    HwRecord rec;
+    memset(&rec, 0, sizeof(rec));
+    rec.index = t->index;
+    rec.tid = t->tid;
+    // Every core-type group of a level is enabled for the same time
+    for (int level = HWC_USER; level <= HWC_KERNEL; level++) {
+        uint64_t *out = level == HWC_USER ? rec.counts.user : rec.counts.kernel;
+        uint64_t level_enabled = 0;
+        for (int p = 0; p < num_pmus; p++) {
+            uint64_t enabled, running;
+            read_group(&t->groups[level][p], out, &enabled, &running);
+            if (enabled > level_enabled) level_enabled = enabled;
+            rec.counts.time_running += running;
+            close_group(&t->groups[level][p]);
+        }
+        rec.counts.time_enabled += level_enabled;
+    }
+    if (t->ctx_fd >= 0) {
+        uint64_t buf[4];
+        if (read(t->ctx_fd, buf, sizeof(buf)) >= (ssize_t)(4 * sizeof(uint64_t))) {
+            rec.counts.ctx_switches = buf[3];
+        }
+        close(t->ctx_fd);
+    }
+    free(t);
+
+    pthread_mutex_lock(&records_lock);
+    if (num_records == cap_records) {
+        int cap = cap_records ? cap_records * 2 : 16;
+        HwRecord *grown = realloc(records, cap * sizeof(HwRecord));
+        if (grown) {
+            records = grown;
+            cap_records = cap;
+        }
+    }
+    if (num_records < cap_records) records[num_records++] = rec;
+    pthread_mutex_unlock(&records_lock);
+}
+
+/* detect_pmus: Hybrid parts expose one core PMU per core type */
+static void detect_pmus(void) {
+    static const char *hybrid[] = {"cpu_core", "cpu_atom"};
+    num_pmus = 0;
+    for (int i = 0; i < HWC_MAX_PMUS; i++) {
+        char path[128];
+        snprintf(path, sizeof(path), "/sys/bus/event_source/devices/%s/type", hybrid[i]);
+        FILE *f = fopen(path, "r");
+        if (!f) continue;
+        unsigned type;
+        if (fscanf(f, "%u", &type) == 1) {
+            pmus[num_pmus].name = hybrid[i];
+            pmus[num_pmus++].ext_type = type;
+        }
+        fclose(f);
+    }
+    if (num_pmus == 0) {
+        pmus[0].name = "cpu";
+        pmus[0].ext_type = 0;
+        num_pmus = 1;
+    }
+}
+
+static int open_ctx_switches(void) {
+    return open_event(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES, -1, -1);
+}
+
+int hwc_enable(void) {
+    detect_pmus();
+
+    // Probe on the calling thread: which events does this machine count?
+    supported = 0;
+    for (int p = 0; p < num_pmus; p++) {
+        HwGroup g;
+        open_group(&g, HWC_USER, p);
+        for (int i = 0; i < g.count; i++) supported |= 1u << g.events[i];
+        close_group(&g);
+    }
+    int ctx_fd = open_ctx_switches();
+    if (ctx_fd < 0 && supported == 0) {
+        perror("perf_event_open failed (kernel.perf_event_paranoid?), hardware counters off");
+        return -1;
+    }
+    if (ctx_fd >= 0) close(ctx_fd);
+
+    if (pthread_key_create(&thread_key, thread_exit) != 0) {
+        perror("pthread_key_create failed, hardware counters off");
+        return -1;
+    }
+    enabled = 1;
+
+    printf("HW counters: per-thread user/kernel groups on %s", pmus[0].name);
+    for (int p = 1; p < num_pmus; p++) printf("+%s", pmus[p].name);
+    if (supported != (1u << HWC_NUM_EVENTS) - 1) {
+        printf(" (unsupported:");
+        for (int e = 0; e < HWC_NUM_EVENTS; e++) {
+            if (!(supported & (1u << e))) printf(" %s", event_keys[e]);
+        }
+        printf(")");
+    }
+    printf("\n");
+    return 0;
+}
+
+void hwc_thread_begin(void) {
+    if (!enabled || pthread_getspecific(thread_key)) return;
+    HwThread *t = calloc(1, sizeof(HwThread));
+    if (!t) return;
+    t->index = __atomic_add_fetch(&next_index, 1, __ATOMIC_RELAXED);
+    t->tid = (long)syscall(SYS_gettid);
+    for (int p = 0; p < num_pmus; p++) {
+        open_group(&t->groups[HWC_USER][p], HWC_USER, p);
+        open_group(&t->groups[HWC_KERNEL][p], HWC_KERNEL, p);
+    }
+    t->ctx_fd = open_ctx_switches();
+
+    for (int p = 0; p < num_pmus; p++) {
+        for (int level = HWC_USER; level <= HWC_KERNEL; level++) {
+            int leader = t->groups[level][p].leader;
+            if (leader >= 0) ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+    }
+    if (t->ctx_fd >= 0) ioctl(t->ctx_fd, PERF_EVENT_IOC_ENABLE, 0);
+    pthread_setspecific(thread_key, t);
+}
+
+int hwc_wait_threads(int timeout_ms) {
+    if (!enabled) return 1;
+    for (int waited = 0;; waited += HWC_WAIT_STEP_MS) {
+        pthread_mutex_lock(&records_lock);
+        int done = num_records >= __atomic_load_n(&next_index, __ATOMIC_RELAXED);
+        pthread_mutex_unlock(&records_lock);
+        if (done) return 1;
+        if (waited >= timeout_ms) return 0;
+        usleep(HWC_WAIT_STEP_MS * 1000);
+    }
+}
+
+static int compare_index(const void *a, const void *b) {
+    return ((const HwRecord*)a)->index - ((const HwRecord*)b)->index;
+}
+
+/* snapshot: The exited threads' records in start order (caller frees) */
+static int snapshot(HwRecord **out) {
+    pthread_mutex_lock(&records_lock);
+    int n = num_records;
+    *out = n ? malloc(n * sizeof(HwRecord)) : NULL;
+    if (*out) memcpy(*out, records, n * sizeof(HwRecord));
+    else n = 0;
+    pthread_mutex_unlock(&records_lock);
+    if (n) qsort(*out, n, sizeof(HwRecord), compare_index);
+    return n;
+}
+
+static void add_counts(HwCounts *total, const HwCounts *c) {
+    for (int e = 0; e < HWC_NUM_EVENTS; e++) {
+        total->user[e] += c->user[e];
+        total->kernel[e] += c->kernel[e];
+    }
+    total->ctx_switches += c->ctx_switches;
+    total->time_enabled += c->time_enabled;
+    total->time_running += c->time_running;
+}
+
+static double ipc(const HwCounts *c) {
+    uint64_t cycles = c->user[HWC_CYCLES] + c->kernel[HWC_CYCLES];
+    uint64_t instructions = c->user[HWC_INSTRUCTIONS] + c->kernel[HWC_INSTRUCTIONS];
+    return cycles ? (double)instructions / cycles : 0.0;
+}
+
+/* running_pct: Share of the enabled time the groups were on a PMU */
+static double running_pct(const HwCounts *c) {
+    return c->time_enabled ? 100.0 * (double)c->time_running / (double)c->time_enabled : 0.0;
+}
+
+/*
+ * format_counts: "<prefix>cycles_u=.. <prefix>cycles_k=.. ... <prefix>ipc=..
+ * <prefix>running_pct=.."
+ */
+static size_t format_counts(char *buf, size_t len, const char *prefix, const HwCounts *c) {
+    size_t used = 0;
+    for (int e = 0; e < HWC_NUM_EVENTS && used < len; e++) {
+        used += (size_t)snprintf(buf + used, len - used, "%s%s_u=%lu %s%s_k=%lu ",
+                                 prefix, event_keys[e], (unsigned long)c->user[e],
+                                 prefix, event_keys[e], (unsigned long)c->kernel[e]);
+    }
+    if (used < len) {
+        used += (size_t)snprintf(buf + used, len - used,
+                                 "%sctx_switches=%lu %sipc=%.3f %srunning_pct=%.1f",
+                                 prefix, (unsigned long)c->ctx_switches, prefix, ipc(c),
+                                 prefix, running_pct(c));
+    }
+    return used;
+}
+
+int hwc_report(const char *side, HwCounts *total) {
+    if (total) memset(total, 0, sizeof(*total));
+    if (!enabled) return 0;
+    HwRecord *recs;
+    int n = snapshot(&recs);
+    for (int i = 0; i < n; i++) {
+        char counts[512];
+        format_counts(counts, sizeof(counts), "", &recs[i].counts);
+        printf("HW_THREAD side=%s thread=%d tid=%ld %s\n", side, recs[i].index,
+               recs[i].tid, counts);
+        if (total) add_counts(total, &recs[i].counts);
+    }
+    free(recs);
+    return n;
+}
+
+void hwc_format_metrics(char *buf, size_t len) {
+    if (!enabled) {
+        snprintf(buf, len, "hw=off");
+        return;
+    }
+    HwRecord *recs;
+    int n = snapshot(&recs);
+    HwCounts total;
+    memset(&total, 0, sizeof(total));
+    for (int i = 0; i < n; i++) add_counts(&total, &recs[i].counts);
+
+    int all = supported == (1u << HWC_NUM_EVENTS) - 1;
+    size_t used = (size_t)snprintf(buf, len, "hw=%s hw_threads=%d ",
+                                   all ? "on" : "partial", n);
+    if (used < len) used += format_counts(buf + used, len - used, "hw_", &total);
+    // How the cycles spread across threads, in start order
+    if (used < len) used += (size_t)snprintf(buf + used, len - used, " hw_thread_cycles=");
+    for (int i = 0; i < n && used < len; i++) {
+        used += (size_t)snprintf(buf + used, len - used, "%s%lu", i ? "/" : "",
+                                 (unsigned long)(recs[i].counts.user[HWC_CYCLES] +
+                                                 recs[i].counts.kernel[HWC_CYCLES]));
+    }
+    if (n == 0 && used < len) snprintf(buf + used, len - used, "-");
+    free(recs);
+}
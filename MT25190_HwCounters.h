@@ -0,0 +1,92 @@
+/*
+ * In-process per-thread hardware counters (--hw-counters).
+ *
+ * Part C wraps only the client in `perf stat`, which sums the whole
+ * process and never looks at the server. With --hw-counters every server
+ * and client thread opens its own perf_event_open() counter groups when
+ * it starts and reads them when it exits:
+ *
+ *   per thread, per privilege level (user / kernel), per core PMU:
+ *     group { cycles (leader), instructions, cache-misses,
+ *             LLC-load-misses, dTLB-load-misses }
+ *   per thread: context-switches (software event, kernel only)
+ *
+ * Counting user and kernel in separate groups shows which side of the
+ * connection pays for each copy: a two-copy send spends its cycles in the
+ * kernel, a user-space serialisation in user mode. Groups are scheduled
+ * onto the PMU as a unit, so the ratios inside one group (IPC, misses per
+ * cycle) are exact even when perf multiplexes; with the generic PMU the
+ * totals are scaled by time_enabled / time_running.
+ *
+ * Hybrid CPUs (cpu_core + cpu_atom PMUs) get one group per core type and
+ * the raw counts are summed, so a thread that migrates is counted on both.
+ * They are not scaled: a core type's group only runs while the thread is
+ * on that core type. running_pct (running time summed over the core types
+ * / enabled time) shows how much of the run the counts cover; below 100
+ * the PMUs were multiplexed and the counts are low.
+ * Events the machine cannot count (no PMU in a VM) are skipped and listed
+ * as unsupported; the rest still report.
+ */
+
+#ifndef MT25190_HWCOUNTERS_H
+#define MT25190_HWCOUNTERS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Hardware events counted per privilege level */
+typedef enum {
+    HWC_CYCLES,
+    HWC_INSTRUCTIONS,
+    HWC_CACHE_MISSES,
+    HWC_LLC_MISSES,
+    HWC_DTLB_MISSES,
+    HWC_NUM_EVENTS
+} HwEvent;
+
+/* One thread's (or the aggregate's) counts */
+typedef struct {
+    uint64_t user[HWC_NUM_EVENTS];
+    uint64_t kernel[HWC_NUM_EVENTS];
+    uint64_t ctx_switches;
+    uint64_t time_enabled;      // ns the groups were enabled (user + kernel)
+    uint64_t time_running;      // ns on a PMU, summed over the core types
+} HwCounts;
+
+/*
+ * hwc_enable: Turns counting on for threads that call hwc_thread_begin
+ * afterwards. Probes which events open on this machine and prints one
+ * banner line. Returns 0, or -1 (counting stays off) when not even the
+ * software event can be opened, e.g. kernel.perf_event_paranoid > 2.
+ */
+int hwc_enable(void);
+
+/*
+ * hwc_thread_begin: Opens and starts the calling thread's counters. They
+ * are read and recorded automatically when the thread exits. No-op
+ * unless hwc_enable() succeeded.
+ */
+void hwc_thread_begin(void);
+
+/*
+ * hwc_wait_threads: Waits up to 'timeout_ms' for every counted thread to
+ * exit (detached sender threads leave once 'running' drops). Returns 1 if
+ * they all did, 0 on timeout.
+ */
+int hwc_wait_threads(int timeout_ms);
+
+/*
+ * hwc_report: Prints one "HW_THREAD side=.. thread=N tid=.." line per
+ * thread that has exited so far and fills 'total' with their sum.
+ * Returns the number of threads.
+ */
+int hwc_report(const char *side, HwCounts *total);
+
+/*
+ * hwc_format_metrics: "hw=on|partial hw_threads=N hw_cycles_u=..
+ * hw_cycles_k=.. ... hw_ipc=.. hw_thread_cycles=A/B/.." summed over the
+ * threads recorded so far, or "hw=off"
+ */
+void hwc_format_metrics(char *buf, size_t len);
+
+#endif /* MT25190_HWCOUNTERS_H */
@@ -0,0 +1,372 @@
+/*
+ * TCP client using io_uring for the receive path (pairs with A4 server)
+ * Receives with one multishot IORING_OP_RECV per socket: the kernel picks
+ * each receive's buffer from a provided buffer ring of K buffers
+ * (--depth=K) and keeps posting completions without a new SQE, and every
+ * io_uring_enter() reaps all completions that are ready. A single request
+ * per socket also keeps the completions in stream order.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <getopt.h>
+#include <errno.h>
+
+#include "MT25190_Uring.h"
+#include "MT25190_Histogram.h"
+#include "MT25190_Framing.h"
+#include "MT25190_Affinity.h"
+#include "MT25190_TimeSeries.h"
+#include "MT25190_HwCounters.h"
+
+#define DEFAULT_PORT 8083
+#define DEFAULT_SERVER "127.0.0.1"
+#define NUM_FIELDS 8
+#define RUN_DURATION 30
+#define DEFAULT_READ_DEPTH 8
+#define MAX_READ_DEPTH 32768    // Buffer ids are 16 bits
+#define RECV_BGID 0             // Buffer group of the receive buffers
+#define RECV_USER_DATA 1
+
+typedef struct {
+    long bytes_received;
+    long messages_received;
+    double elapsed_time;
+    long messages_lost;     // Gaps in the frame sequence numbers
+    uint64_t cpu_ns;        // Thread CPU time (user + system) while receiving
+    // Per-message latency: one-way delay from the frame's send timestamp
+    LatencyHistogram latency;
+} ThreadStats;
+
+char server_ip[32] = DEFAULT_SERVER;
+int server_port = DEFAULT_PORT;
+int message_size = 1024;
+int num_threads = 4;
+int run_duration = RUN_DURATION;
+const char *timeseries_path = NULL;     // Per-interval samples as CSV (--timeseries=FILE)
+int ts_interval_ms = TS_DEFAULT_INTERVAL_MS;    // Sampling period (--ts-interval=MS)
+int hw_counters = 0;                    // Per-thread perf_event_open counters (--hw-counters)
+int read_depth = DEFAULT_READ_DEPTH;    // Receive buffers per connection (--depth=K)
+volatile int running = 1;
+
+/*
+ * arm_recv_multishot: Queues a multishot receive that takes its buffers
+ * from group RECV_BGID (submitted with the next io_uring_enter()). It
+ * stays armed until a CQE arrives without IORING_CQE_F_MORE, e.g. when
+ * the buffer ring ran empty (-ENOBUFS).
+ * Returns 0, or -1 with errno set if the SQ is full.
+ */
+static int arm_recv_multishot(Uring *ring, int sockfd) {
+    struct io_uring_sqe *sqe = uring_get_sqe(ring);
+    if (!sqe) {
+        errno = EBUSY;
+        return -1;
+    }
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = sockfd;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = RECV_BGID;
+    sqe->user_data = RECV_USER_DATA;
+    return 0;
+}
+
+/*
+ * setup_receive_ring: Creates the ring and hands the read_depth buffers of
+ * 'buffer' (msg_bytes each) to the kernel as provided buffer ring RECV_BGID
+ * Returns 0, or -1 with nothing left to clean up.
+ */
+static int setup_receive_ring(Uring *ring, UringBufRing *bufs, char *buffer, size_t msg_bytes) {
+    unsigned entries = 1;
+    while (entries < (unsigned)read_depth) entries <<= 1;
+    // One CQE per filled buffer: a CQ of 2 * entries never overflows
+    if (uring_init(ring, entries) < 0) {
+        perror("io_uring_setup failed");
+        return -1;
+    }
+    if (uring_buf_ring_setup(ring, bufs, entries, RECV_BGID) < 0) {
+        perror("IORING_REGISTER_PBUF_RING failed");
+        uring_exit(ring);
+        return -1;
+    }
+    for (int i = 0; i < read_depth; i++) {
+        uring_buf_ring_add(bufs, buffer + (size_t)i * msg_bytes, (unsigned)msg_bytes,
+                           (unsigned short)i);
+    }
+    uring_buf_ring_publish(bufs);
+    return 0;
+}
+
+void* client_thread(void *arg) {
+    int thread_id = *(int*)arg;
+    free(arg);
+    affinity_pin_next();    // Before allocating: buffers land on this CPU's node
+    hwc_thread_begin();     // Counted until the thread exits (--hw-counters)
+    TsCounter *ts = timeseries_counter(thread_id - 1);
+
+    int sock;
+    struct sockaddr_in server_addr;
+    char *buffer;
+    Uring ring;
+    UringBufRing bufs;
+    ThreadStats stats = {0};
+    struct timespec start_time, end_time;
+    FrameAssembler fa;
+    size_t msg_bytes = (size_t)message_size * NUM_FIELDS;
+    size_t buffer_bytes = msg_bytes * read_depth;
+
+    buffer = aligned_alloc(4096, (buffer_bytes + 4095) & ~(size_t)4095);
+    if (!buffer) {
+        perror("Failed to allocate buffer");
+        return NULL;
+    }
+
+    if (setup_receive_ring(&ring, &bufs, buffer, msg_bytes) < 0) {
+        free(buffer);
+        return NULL;
+    }
+
+    sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (sock < 0) {
+        perror("Socket creation failed");
+        uring_exit(&ring);
+        uring_buf_ring_free(&bufs);
+        free(buffer);
+        return NULL;
+    }
+    memset(&server_addr, 0, sizeof(server_addr));
+    server_addr.sin_family = AF_INET;
+    server_addr.sin_port = htons(server_port);
+    inet_pton(AF_INET, server_ip, &server_addr.sin_addr);
+
+    printf("[Thread %d] Connecting...\n", thread_id);
+    if (connect(sock, (struct sockaddr*)&server_addr, sizeof(server_addr)) < 0) {
+        perror("Connection failed");
+        close(sock);
+        uring_exit(&ring);
+        uring_buf_ring_free(&bufs);
+        free(buffer);
+        return NULL;
+    }
+
+    printf("[Thread %d] Connected\n", thread_id);
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+    uint64_t start_ns = monotonic_ns();
+    uint64_t cpu_start = thread_cpu_ns();
+    frame_assembler_init(&fa, msg_bytes);
+
+    // Frames may straddle buffers, so they are parsed in place with
+    // frame_consume(); a message counts once its whole frame has arrived
+    arm_recv_multishot(&ring, sock);
+
+    while (running) {
+        if (uring_submit_and_wait(&ring, 1) < 0) {
+            if (errno == EINTR) continue;
+            perror("io_uring_enter failed");
+            break;
+        }
+
+        struct io_uring_cqe *cqe;
+        while (running && (cqe = uring_peek_cqe(&ring)) != NULL) {
+            int res = cqe->res;
+            unsigned flags = cqe->flags;
+            uring_cqe_seen(&ring);
+
+            if (res > 0 && (flags & IORING_CQE_F_BUFFER)) {
+                unsigned short bid = (unsigned short)(flags >> IORING_CQE_BUFFER_SHIFT);
+                char *buf = buffer + (size_t)bid * msg_bytes;
+                uint64_t now_ns = monotonic_ns();
+                const char *data = buf;
+                size_t left = (size_t)res;
+                while (left > 0) {
+                    int status;
+                    size_t used = frame_consume(&fa, data, left, &status);
+                    data += used;
+                    left -= used;
+                    if (status == FRAME_INVALID) {
+                        fprintf(stderr, "[Thread %d] Framing error (message_size mismatch?)\n", thread_id);
+                        running = 0;
+                        break;
+                    }
+                    if (status == FRAME_COMPLETE) {
+                        const FrameHeader *hdr = frame_header(&fa);
+                        stats.bytes_received += hdr->length;
+                        stats.messages_received++;
+                        ts_record(ts, hdr->length);
+                        hist_record(&stats.latency, frame_age_ns(hdr, now_ns));
+                    }
+                }
+                // Parsed: hand the buffer back for the next receives
+                uring_buf_ring_add(&bufs, buf, (unsigned)msg_bytes, bid);
+
+                double elapsed = (now_ns - start_ns) / 1e9;
+                if (elapsed >= run_duration) running = 0;
+            } else if (res == 0) {
+                running = 0;    // EOF: the server is gone
+            } else if (res < 0 && res != -ENOBUFS) {
+                fprintf(stderr, "[Thread %d] Multishot recv failed: %s\n", thread_id, strerror(-res));
+                running = 0;
+            }
+
+            // Without F_MORE the receive has ended (-ENOBUFS when every
+            // buffer was in use): re-arm it once the buffers are back
+            if (running && !(flags & IORING_CQE_F_MORE)) arm_recv_multishot(&ring, sock);
+        }
+        uring_buf_ring_publish(&bufs);
+    }
+
+    stats.messages_lost = fa.lost;
+    stats.cpu_ns = thread_cpu_ns() - cpu_start;
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+    stats.elapsed_time = (end_time.tv_sec - start_time.tv_sec) +
+                        (end_time.tv_nsec - start_time.tv_nsec) / 1e9;
+
+    printf("[Thread %d] Msgs: %ld, Throughput: %.2f MB/s\n",
+           thread_id, stats.messages_received,
+           (stats.bytes_received / (1024.0 * 1024.0)) / stats.elapsed_time);
+
+    close(sock);
+    uring_exit(&ring);
+    uring_buf_ring_free(&bufs);
+    free(buffer);
+
+    ThreadStats *result = malloc(sizeof(ThreadStats));
+    *result = stats;
+    return result;
+}
+
+int main(int argc, char *argv[]) {
+    // Optional flags (may appear anywhere):
+    // --affinity=POLICY (pin threads to CPUs, see MT25190_Affinity.h)
+    // --timeseries=FILE --ts-interval=MS (per-interval samples, see MT25190_TimeSeries.h)
+    // --hw-counters (per-thread perf_event_open counters, see MT25190_HwCounters.h)
+    // --depth=K (receive buffers in the provided buffer ring per connection)
+    static const struct option long_options[] = {
+        {"timeseries", required_argument, 0, 'T'},
+        {"ts-interval", required_argument, 0, 'I'},
+        {"hw-counters", no_argument, 0, 'K'},
+        {"affinity", required_argument, 0, 'a'},
+        {"depth", required_argument, 0, 'd'},
+        {0, 0, 0, 0}
+    };
+    int opt_char;
+    while ((opt_char = getopt_long(argc, argv, "", long_options, NULL)) != -1) {
+        switch (opt_char) {
+        case 'T':
+            timeseries_path = optarg;
+            break;
+        case 'K':
+            hw_counters = 1;
+            break;
+        case 'I':
+            ts_interval_ms = atoi(optarg);
+            if (ts_interval_ms <= 0) {
+                fprintf(stderr, "Invalid --ts-interval '%s' (milliseconds)\n", optarg);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'a':
+            if (affinity_configure(optarg, AFFINITY_CLIENT) < 0) exit(EXIT_FAILURE);
+            break;
+        case 'd':
+            read_depth = atoi(optarg);
+            if (read_depth < 1) read_depth = 1;
+            if (read_depth > MAX_READ_DEPTH) read_depth = MAX_READ_DEPTH;
+            break;
+        default:
+            fprintf(stderr, "Usage: %s <server_ip> <port> <message_size> <num_threads> "
+                            "<duration> [--affinity=POLICY]\n"
+                            "       [--timeseries=FILE] [--ts-interval=MS] [--hw-counters] [--depth=K]\n",
+                            argv[0]);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // Parse positional arguments: <server_ip> <port> <message_size> <num_threads> <duration>
+    // PA02 requirement: All parameters must be passed explicitly for automation
+    if (argc > optind) strncpy(server_ip, argv[optind], sizeof(server_ip) - 1);
+    if (argc > optind + 1) server_port = atoi(argv[optind + 1]);
+    if (argc > optind + 2) message_size = atoi(argv[optind + 2]);
+    if (argc > optind + 3) num_threads = atoi(argv[optind + 3]);
+    if (argc > optind + 4) run_duration = atoi(argv[optind + 4]);
+    if (message_size < (int)sizeof(FrameHeader)) {
+        fprintf(stderr, "message_size must be >= %zu (frame header)\n", sizeof(FrameHeader));
+        exit(EXIT_FAILURE);
+    }
+
+    printf("=== PA02 Part A4: io_uring Client ===\n");
+    printf("Roll Number: MT25190\n");
+    printf("Server: %s:%d, Duration: %d sec, Receive buffers: %d\n\n",
+           server_ip, server_port, run_duration, read_depth);
+
+    pthread_t *threads = malloc(num_threads * sizeof(pthread_t));
+    ThreadStats aggregate = {0};
+
+    if (hw_counters && hwc_enable() < 0) hw_counters = 0;
+    // Per-interval sampler: steady-state rates without the warm-up
+    if (timeseries_start(timeseries_path, ts_interval_ms, num_threads) < 0) exit(EXIT_FAILURE);
+
+    for (int i = 0; i < num_threads; i++) {
+        int *id = malloc(sizeof(int));
+        *id = i + 1;
+        pthread_create(&threads[i], NULL, client_thread, id);
+        usleep(10000);  // 10ms
+    }
+
+    for (int i = 0; i < num_threads; i++) {
+        ThreadStats *stats;
+        pthread_join(threads[i], (void**)&stats);
+        if (stats) {
+            aggregate.bytes_received += stats->bytes_received;
+            aggregate.messages_received += stats->messages_received;
+            aggregate.messages_lost += stats->messages_lost;
+            aggregate.cpu_ns += stats->cpu_ns;
+            hist_merge(&aggregate.latency, &stats->latency);
+            if (stats->elapsed_time > aggregate.elapsed_time)
+                aggregate.elapsed_time = stats->elapsed_time;
+            free(stats);
+        }
+    }
+    TsSummary steady;
+    timeseries_stop(&steady);
+
+    printf("\n=== Aggregate ===\n");
+    printf("Messages: %ld, Bytes: %.2f MB\n",
+           aggregate.messages_received,
+           aggregate.bytes_received / (1024.0 * 1024.0));
+    printf("Throughput: %.2f MB/s\n",
+           (aggregate.bytes_received / (1024.0 * 1024.0)) / aggregate.elapsed_time);
+    printf("Steady state: %.2f MB/s after %.2f s warm-up (%d of %d intervals, CV %.3f)\n",
+           steady.steady_gbps * 1e9 / 8 / (1024.0 * 1024.0), steady.warmup_s,
+           steady.steady_samples, steady.samples, steady.steady_cv);
+    // PA02 requirement: Output parseable metrics for script collection
+    double throughput_gbps = (aggregate.bytes_received * 8.0) / (aggregate.elapsed_time * 1e9);
+    double latency_us = (aggregate.elapsed_time * 1e6) / aggregate.messages_received;
+    // Tail latency from the merged per-thread histograms
+    char percentiles[160];
+    hist_format_metrics(&aggregate.latency, percentiles, sizeof(percentiles));
+    // Receive-side CPU cost: all client threads' CPU time per message
+    double cpu_us_per_msg = aggregate.messages_received
+                          ? aggregate.cpu_ns / 1e3 / aggregate.messages_received : 0.0;
+    char steady_rates[128];
+    timeseries_format_metrics(&steady, steady_rates, sizeof(steady_rates));
+    // Which threads paid for the run, in user and kernel mode
+    char hw[1024];
+    hwc_report("client", NULL);
+    hwc_format_metrics(hw, sizeof(hw));
+    // CPU placement of each server:client pair, to tie cache misses to topology
+    char placement[256];
+    affinity_format_metrics(num_threads, placement, sizeof(placement));
+    printf("METRICS throughput_gbps=%.6f latency_us=%.2f bytes=%ld lost=%ld "
+           "%s cpu_us_per_msg=%.3f %s %s %s\n",
+           throughput_gbps, latency_us, aggregate.bytes_received,
+           aggregate.messages_lost, percentiles, cpu_us_per_msg, steady_rates, hw, placement);
+    free(threads);
+    return 0;
+}
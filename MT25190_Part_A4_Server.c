@@ -0,0 +1,459 @@
+/*
+ * io_uring ZERO-COPY ARCHITECTURE (IORING_OP_SEND_ZC):
+ * ASCII Diagram:
+ *
+ *   Registered buffer ring (pinned once at io_uring_register)
+ *   [slot 0][slot 1] ... [slot K-1]
+ *        |
+ *        | batch of linked SEND_ZC SQEs -> ONE io_uring_enter()
+ *        v
+ *   Kernel Socket Layer (references slot pages, no copy)
+ *        |
+ *        | (DMA descriptor setup)
+ *        v
+ *   NIC DMA Engine ----> Network
+ *        |
+ *        +--> CQE #1: send result (IORING_CQE_F_MORE set)
+ *        +--> CQE #2: notification (IORING_CQE_F_NOTIF) -> slot reusable
+ *
+ * Compared to A3 (send(MSG_ZEROCOPY) + recvmsg(MSG_ERRQUEUE)):
+ * - One syscall submits a whole batch of sends instead of one per message
+ * - Completions arrive on the shared CQ ring: no separate error-queue syscall
+ * - Buffers are pinned once at registration instead of per send
+ * - The next batch is queued while earlier sends are still in flight: a
+ *   pipe byte written at the end of each chain releases the next chain in
+ *   the kernel, so batches follow each other without a user-space wait
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <errno.h>
+#include <signal.h>
+#include <getopt.h>
+#include <stdint.h>
+
+#include "MT25190_Uring.h"
+#include "MT25190_Histogram.h"   // monotonic_ns()
+#include "MT25190_Framing.h"
+#include "MT25190_Affinity.h"
+#include "MT25190_HwCounters.h"
+
+#define DEFAULT_PORT 8083
+#define MAX_CLIENTS 100
+#define HW_REPORT_WAIT_MS 1000  // Sender threads to exit before --hw-counters reports
+#define NUM_FIELDS 8
+#define DEFAULT_DEPTH 32    // Registered buffer slots (max sends in flight)
+#define HANDOFF_READ UINT64_MAX          // user_data: hand-off read starting a batch
+#define HANDOFF_WRITE (UINT64_MAX - 1)  // user_data: hand-off write ending a batch
+
+int message_size = 1024;
+int num_threads = 4;
+int ring_depth = DEFAULT_DEPTH;
+volatile sig_atomic_t running = 1;
+
+/* Signal handler for graceful shutdown */
+void signal_handler(int signum) {
+    (void)signum;
+    printf("\nReceived shutdown signal. Stopping server...\n");
+    running = 0;
+}
+
+/*
+ * Per-connection send ring
+ * A slot is in flight from submission until BOTH its result CQE and its
+ * notification CQE have arrived; only then may its pages be rewritten.
+ */
+typedef struct {
+    Uring ring;
+    char *pool;             // depth * msg_bytes, registered as fixed buffers
+    size_t msg_bytes;
+    int depth;
+    char *result_pending;   // Per slot: waiting for the send result CQE
+    char *notif_pending;    // Per slot: waiting for the F_NOTIF CQE
+    int results_outstanding;
+    int handoff[2];         // Pipe: one byte per finished batch
+    char handoff_out;       // Written by a batch's last link
+    char handoff_in;        // Read target of the next batch's first link
+    int chained;            // A batch has been queued: the next one waits for it
+    int handoff_waiting;    // A queued batch has not started yet (read pending)
+    long messages_sent;
+    uint64_t frame_seq;     // Sequence number stamped into the next queued frame
+    long batches;           // io_uring_enter() calls that submitted sends
+    long notifications;
+    long copied;            // Notifications reporting a copy fallback
+} UringSender;
+
+/*
+ * uring_sender_init: Allocates and registers the buffer pool
+ * Registration pins the pages once; every SEND_ZC then references them by
+ * index (IORING_RECVSEND_FIXED_BUF) without per-send page pinning.
+ */
+static int uring_sender_init(UringSender *s, int field_size, int depth) {
+    memset(s, 0, sizeof(*s));
+    s->msg_bytes = (size_t)field_size * NUM_FIELDS;
+    s->depth = depth;
+
+    // A pipe rather than an eventfd: io_uring reads and writes pipes
+    // inline, while eventfd I/O would be punted to an io-wq worker thread
+    if (pipe(s->handoff) < 0) {
+        perror("pipe failed");
+        return -1;
+    }
+
+    // Two CQEs per send (result + notification) plus the batch hand-off
+    // links, so size the ring generously
+    if (uring_init(&s->ring, (unsigned)depth * 2 + 2) < 0) {
+        perror("io_uring_setup failed");
+        close(s->handoff[0]);
+        close(s->handoff[1]);
+        return -1;
+    }
+
+    s->pool = aligned_alloc(4096, ((s->msg_bytes * depth) + 4095) & ~(size_t)4095);
+    s->result_pending = calloc(depth, 1);
+    s->notif_pending = calloc(depth, 1);
+    struct iovec *iov = calloc(depth, sizeof(struct iovec));
+    if (!s->pool || !s->result_pending || !s->notif_pending || !iov) {
+        perror("Failed to allocate send ring");
+        goto fail;
+    }
+
+    for (int slot = 0; slot < depth; slot++) {
+        char *base = s->pool + slot * s->msg_bytes;
+        // Same 8-field payload layout as A1/A2
+        for (int f = 0; f < NUM_FIELDS; f++) {
+            memset(base + f * field_size, 'A' + f, field_size - 1);
+            base[f * field_size + field_size - 1] = '\0';
+        }
+        iov[slot].iov_base = base;
+        iov[slot].iov_len = s->msg_bytes;
+    }
+
+    if (uring_register_buffers(&s->ring, iov, depth) < 0) {
+        perror("IORING_REGISTER_BUFFERS failed");
+        goto fail;
+    }
+    free(iov);
+    return 0;
+
+fail:
+    free(iov);
+    free(s->pool);
+    free(s->result_pending);
+    free(s->notif_pending);
+    uring_exit(&s->ring);
+    close(s->handoff[0]);
+    close(s->handoff[1]);
+    return -1;
+}
+
+/*
+ * uring_sender_free: Tearing down the ring cancels anything still in flight;
+ * the kernel holds its own page references until those requests finish.
+ */
+static void uring_sender_free(UringSender *s) {
+    uring_exit(&s->ring);
+    close(s->handoff[0]);
+    close(s->handoff[1]);
+    free(s->pool);
+    free(s->result_pending);
+    free(s->notif_pending);
+}
+
+/* free_slots: Slots whose result and notification have both arrived */
+static int free_slots(const UringSender *s) {
+    int n = 0;
+    for (int slot = 0; slot < s->depth; slot++)
+        if (!s->result_pending[slot] && !s->notif_pending[slot]) n++;
+    return n;
+}
+
+/* queue_handoff: Links a one-byte hand-off pipe read or write into the chain */
+static struct io_uring_sqe* queue_handoff(UringSender *s, int opcode, char *byte,
+                                          uint64_t user_data) {
+    struct io_uring_sqe *sqe = uring_get_sqe(&s->ring);
+    if (!sqe) return NULL;
+    sqe->opcode = opcode;
+    sqe->fd = s->handoff[opcode == IORING_OP_READ ? 0 : 1];
+    sqe->addr = (unsigned long)byte;
+    sqe->len = 1;
+    sqe->off = (uint64_t)-1;    // Pipes have no file position
+    sqe->flags = IOSQE_IO_LINK;
+    sqe->user_data = user_data;
+    return sqe;
+}
+
+/*
+ * queue_send_batch: Prepares one SEND_ZC per free slot, linked in order
+ * IOSQE_IO_LINK keeps the batch's sends in stream order, and MSG_WAITALL
+ * makes io_uring retry short sends so every send carries a whole message.
+ * Each slot's frame header is stamped just before it is queued; the linked
+ * order keeps the stamped sequence numbers in stream order.
+ * Links do not reach across io_uring_enter() calls, so consecutive batches
+ * are chained through the hand-off pipe instead: a batch's last link
+ * writes one byte, and the next batch starts by reading one byte, which
+ * blocks in the kernel until the previous batch's sends have all gone out.
+ * Only one batch waits at a time: two pending reads could take each other's
+ * bytes and start out of order.
+ * Returns the number of sends prepared.
+ */
+static int queue_send_batch(UringSender *s, int sockfd) {
+    if (s->handoff_waiting) return 0;
+    int slots = free_slots(s);
+    // Room for the sends plus both hand-off links, or nothing at all
+    if (slots == 0 || uring_sq_space(&s->ring) < (unsigned)slots + 2) return 0;
+
+    if (s->chained) {
+        queue_handoff(s, IORING_OP_READ, &s->handoff_in, HANDOFF_READ);
+        s->handoff_waiting = 1;
+    }
+
+    int queued = 0;
+    for (int slot = 0; slot < s->depth; slot++) {
+        if (s->result_pending[slot] || s->notif_pending[slot]) continue;
+
+        struct io_uring_sqe *sqe = uring_get_sqe(&s->ring);
+        frame_stamp(s->pool + slot * s->msg_bytes, (uint32_t)s->msg_bytes,
+                    s->frame_seq++, monotonic_ns());
+        sqe->opcode = IORING_OP_SEND_ZC;
+        sqe->fd = sockfd;
+        sqe->addr = (unsigned long)(s->pool + slot * s->msg_bytes);
+        sqe->len = (unsigned)s->msg_bytes;
+        sqe->msg_flags = MSG_WAITALL;
+        sqe->ioprio = IORING_RECVSEND_FIXED_BUF | IORING_SEND_ZC_REPORT_USAGE;
+        sqe->buf_index = (unsigned short)slot;
+        sqe->flags = IOSQE_IO_LINK;
+        sqe->user_data = (unsigned long)slot;
+
+        s->result_pending[slot] = 1;
+        s->notif_pending[slot] = 1;
+        s->results_outstanding++;
+        queued++;
+    }
+
+    // Chain ends at the batch boundary, after releasing the next batch
+    queue_handoff(s, IORING_OP_WRITE, &s->handoff_out, HANDOFF_WRITE)->flags &= ~IOSQE_IO_LINK;
+    s->chained = 1;
+    return queued;
+}
+
+/*
+ * reap_completions: Processes every CQE currently on the ring
+ * Returns 0, or a positive errno if a send failed (EPIPE, ECONNRESET, ...)
+ */
+static int reap_completions(UringSender *s) {
+    struct io_uring_cqe *cqe;
+    int error = 0;
+
+    while ((cqe = uring_peek_cqe(&s->ring)) != NULL) {
+        int slot = (int)cqe->user_data;
+
+        if (cqe->user_data == HANDOFF_READ || cqe->user_data == HANDOFF_WRITE) {
+            // Only fails if the chain broke, which its sends report
+            if (cqe->user_data == HANDOFF_READ) s->handoff_waiting = 0;
+            uring_cqe_seen(&s->ring);
+            continue;
+        }
+        if (cqe->flags & IORING_CQE_F_NOTIF) {
+            // Kernel has released the slot's pages: safe to resend/rewrite
+            s->notif_pending[slot] = 0;
+            s->notifications++;
+            if ((unsigned)cqe->res & IORING_NOTIF_USAGE_ZC_COPIED) s->copied++;
+        } else {
+            s->result_pending[slot] = 0;
+            s->results_outstanding--;
+            // No F_MORE means no notification will follow for this send
+            if (!(cqe->flags & IORING_CQE_F_MORE)) s->notif_pending[slot] = 0;
+
+            if (cqe->res >= 0 && (size_t)cqe->res == s->msg_bytes) {
+                s->messages_sent++;
+            } else if (cqe->res < 0 && cqe->res != -ECANCELED && !error) {
+                error = -cqe->res;
+            } else if (cqe->res >= 0 && !error) {
+                error = EIO;   // Short send despite MSG_WAITALL: stream is misaligned
+            }
+        }
+        uring_cqe_seen(&s->ring);
+    }
+    return error;
+}
+
+void* client_handler(void *arg) {
+    int client_sock = *(int*)arg;
+    free(arg);
+    affinity_pin_next();    // Before allocating: buffers land on this CPU's node
+    hwc_thread_begin();     // Counted until the thread exits (--hw-counters)
+
+    printf("[Thread %lu] Client connected\n", pthread_self());
+
+    UringSender sender;
+    if (uring_sender_init(&sender, message_size, ring_depth) < 0) {
+        close(client_sock);
+        return NULL;
+    }
+
+    // While sends are outstanding the next batch waits for them anyway, so
+    // it is only queued once at least half the ring is free again
+    int min_batch = ring_depth / 2 > 1 ? ring_depth / 2 : 1;
+    while (running) {
+        int queued = 0;
+        if (sender.results_outstanding == 0 || free_slots(&sender) >= min_batch)
+            queued = queue_send_batch(&sender, client_sock);
+
+        // One syscall submits the whole batch; wait for at least one CQE
+        if (uring_submit_and_wait(&sender.ring, 1) < 0) {
+            if (errno == EINTR) continue;
+            perror("io_uring_enter failed");
+            break;
+        }
+        if (queued) sender.batches++;
+
+        int error = reap_completions(&sender);
+        if (error) {
+            if (error != EPIPE && error != ECONNRESET) {
+                errno = error;
+                perror("io_uring send_zc error");
+            }
+            break;
+        }
+    }
+
+    printf("[Thread %lu] Sent %ld messages in %ld batches "
+           "(notifications: %ld, copied fallbacks: %ld)\n",
+           pthread_self(), sender.messages_sent, sender.batches,
+           sender.notifications, sender.copied);
+
+    uring_sender_free(&sender);
+    close(client_sock);
+    return NULL;
+}
+
+/*
+ * report_hw_counters: Per-thread lines and one SERVER_METRICS line of the
+ * sender threads (--hw-counters), once they have left after 'running' dropped
+ */
+static void report_hw_counters(void) {
+    char hw[1024];
+    hwc_wait_threads(HW_REPORT_WAIT_MS);
+    hwc_report("server", NULL);
+    hwc_format_metrics(hw, sizeof(hw));
+    printf("SERVER_METRICS %s\n", hw);
+}
+
+int main(int argc, char *argv[]) {
+    int server_sock, client_sock;
+    struct sockaddr_in server_addr, client_addr;
+    socklen_t client_len = sizeof(client_addr);
+    pthread_t thread_id;
+
+    // Register signal handlers for graceful shutdown
+    signal(SIGINT, signal_handler);
+    signal(SIGTERM, signal_handler);
+
+    // Optional flags (may appear anywhere): --depth=K registered buffer slots
+    // --affinity=POLICY (pin threads to CPUs, see MT25190_Affinity.h)
+    // --hw-counters (per-thread perf_event_open counters, see MT25190_HwCounters.h)
+    int hw_counters = 0;
+    static const struct option long_options[] = {
+        {"depth", required_argument, 0, 'd'},
+        {"affinity", required_argument, 0, 'a'},
+        {"hw-counters", no_argument, 0, 'K'},
+        {0, 0, 0, 0}
+    };
+    int opt_char;
+    while ((opt_char = getopt_long(argc, argv, "", long_options, NULL)) != -1) {
+        switch (opt_char) {
+        case 'd':
+            ring_depth = atoi(optarg);
+            if (ring_depth < 1) ring_depth = 1;
+            break;
+        case 'a':
+            if (affinity_configure(optarg, AFFINITY_SERVER) < 0) exit(EXIT_FAILURE);
+            break;
+        case 'K':
+            hw_counters = 1;
+            break;
+        default:
+            fprintf(stderr, "Usage: %s <port> <message_size> <num_threads> [--depth=K] "
+                            "[--affinity=POLICY] [--hw-counters]\n",
+                    argv[0]);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // Parse positional arguments: <port> <message_size> <num_threads>
+    // PA02 requirement: Port must be passed explicitly for automation
+    int port = DEFAULT_PORT;
+    if (argc > optind) port = atoi(argv[optind]);
+    if (argc > optind + 1) message_size = atoi(argv[optind + 1]);
+    if (argc > optind + 2) num_threads = atoi(argv[optind + 2]);
+    if (message_size < (int)sizeof(FrameHeader)) {
+        fprintf(stderr, "message_size must be >= %zu (frame header)\n", sizeof(FrameHeader));
+        exit(EXIT_FAILURE);
+    }
+
+    printf("=== PA02 Part A4: io_uring Zero-Copy Server ===\n");
+    printf("Roll Number: MT25190\n");
+    printf("Port: %d\n", port);
+    printf("Message size: %d bytes per field\n", message_size);
+    printf("Expected threads: %d\n", num_threads);
+    printf("Using IORING_OP_SEND_ZC with %d registered buffers per connection\n", ring_depth);
+    if (hw_counters && hwc_enable() < 0) hw_counters = 0;
+    printf("\n");
+
+    server_sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (server_sock < 0) {
+        perror("Socket creation failed");
+        exit(EXIT_FAILURE);
+    }
+
+    int opt = 1;
+    if (setsockopt(server_sock, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0) {
+        perror("setsockopt SO_REUSEADDR failed");
+    }
+
+    memset(&server_addr, 0, sizeof(server_addr));
+    server_addr.sin_family = AF_INET;
+    server_addr.sin_addr.s_addr = INADDR_ANY;
+    server_addr.sin_port = htons(port);
+
+    if (bind(server_sock, (struct sockaddr*)&server_addr, sizeof(server_addr)) < 0) {
+        perror("Bind failed");
+        close(server_sock);
+        exit(EXIT_FAILURE);
+    }
+
+    if (listen(server_sock, MAX_CLIENTS) < 0) {
+        perror("Listen failed");
+        close(server_sock);
+        exit(EXIT_FAILURE);
+    }
+
+    printf("Server listening on port %d...\n", port);
+
+    int connected = 0;
+    while (connected < num_threads) {
+        client_sock = accept(server_sock, (struct sockaddr*)&client_addr, &client_len);
+        if (client_sock < 0) continue;
+
+        printf("Client %d connected\n", ++connected);
+
+        int *sock_ptr = malloc(sizeof(int));
+        *sock_ptr = client_sock;
+
+        pthread_create(&thread_id, NULL, client_handler, sock_ptr);
+        pthread_detach(thread_id);
+    }
+
+    printf("All clients connected. Running...\n");
+    while (running) sleep(1);
+
+    close(server_sock);
+    if (hw_counters) report_hw_counters();
+    return 0;
+}
@@ -0,0 +1,296 @@
+/*
+ * Shared-memory client for the A6 ring server
+ * Each thread maps its own SPSC ring (memfd received over a Unix socket)
+ * and is the ring's consumer. The data path has no syscalls at all while
+ * messages keep coming; an empty ring is waited on by spinning or futex:
+ * Copy 1: Server fields → shared slot (server side)
+ * Copy 2: Shared slot → User buffer (this client, replaces recv())
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+#include <getopt.h>
+#include <errno.h>
+
+#include "MT25190_ShmRing.h"
+#include "MT25190_Histogram.h"
+#include "MT25190_Framing.h"
+#include "MT25190_Affinity.h"
+#include "MT25190_TimeSeries.h"
+#include "MT25190_HwCounters.h"
+
+#define DEFAULT_PORT 8085
+#define DEFAULT_SERVER "127.0.0.1"
+#define NUM_FIELDS 8
+#define RUN_DURATION 30
+#define WAIT_TIMEOUT_MS 100     // Re-check the run duration this often
+
+typedef struct {
+    long bytes_received;
+    long messages_received;
+    double elapsed_time;
+    long messages_lost;     // Gaps in the frame sequence numbers
+    uint64_t cpu_ns;        // Thread CPU time (user + system) while receiving
+    long ring_sleeps;       // Times the consumer slept in FUTEX_WAIT (empty ring)
+    // Per-message latency: one-way delay from the frame's send timestamp
+    LatencyHistogram latency;
+} ThreadStats;
+
+char server_ip[32] = DEFAULT_SERVER;   // Unused: the rings are host-local
+int server_port = DEFAULT_PORT;
+int message_size = 1024;
+int num_threads = 4;
+int run_duration = RUN_DURATION;
+const char *timeseries_path = NULL;     // Per-interval samples as CSV (--timeseries=FILE)
+int ts_interval_ms = TS_DEFAULT_INTERVAL_MS;    // Sampling period (--ts-interval=MS)
+int hw_counters = 0;                    // Per-thread perf_event_open counters (--hw-counters)
+int wait_mode = SHM_WAIT_FUTEX;
+volatile int running = 1;
+
+/*
+ * attach_ring: Fetches this thread's ring from the server and maps it
+ * Returns 0 on success, -1 on failure.
+ */
+static int attach_ring(ShmRing *ring) {
+    int sock = shm_connect(server_port);
+    if (sock < 0) {
+        perror("Connection failed");
+        return -1;
+    }
+    int fd = shm_recv_fd(sock);
+    close(sock);
+    if (fd < 0) {
+        perror("Ring handoff failed");
+        return -1;
+    }
+    if (shm_ring_attach(ring, fd, wait_mode) < 0) {
+        perror("Ring mmap failed");
+        return -1;
+    }
+    return 0;
+}
+
+void* client_thread(void *arg) {
+    int thread_id = *(int*)arg;
+    free(arg);
+    affinity_pin_next();    // Before allocating: buffers land on this CPU's node
+    hwc_thread_begin();     // Counted until the thread exits (--hw-counters)
+    TsCounter *ts = timeseries_counter(thread_id - 1);
+
+    char *buffer;
+    ShmRing ring;
+    ThreadStats stats = {0};
+    struct timespec start_time, end_time;
+    FrameAssembler fa;
+    size_t msg_bytes = (size_t)message_size * NUM_FIELDS;
+
+    buffer = malloc(msg_bytes);
+    if (!buffer) {
+        perror("Failed to allocate buffer");
+        return NULL;
+    }
+
+    printf("[Thread %d] Connecting...\n", thread_id);
+    if (attach_ring(&ring) < 0) {
+        free(buffer);
+        return NULL;
+    }
+    if (ring.hdr->slot_size != msg_bytes) {
+        fprintf(stderr, "[Thread %d] Ring slot is %u bytes, expected %zu (message_size mismatch?)\n",
+                thread_id, ring.hdr->slot_size, msg_bytes);
+        shm_ring_close(&ring);
+        shm_ring_detach(&ring);
+        free(buffer);
+        return NULL;
+    }
+
+    printf("[Thread %d] Connected (%u slots)\n", thread_id, ring.hdr->slots);
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+    uint64_t start_ns = monotonic_ns();
+    uint64_t cpu_start = thread_cpu_ns();
+    frame_assembler_init(&fa, msg_bytes);
+
+    // Each slot holds exactly one frame: copy it out, then free the slot
+    while (running) {
+        const char *slot = shm_ring_peek(&ring, WAIT_TIMEOUT_MS);
+        if (slot) {
+            memcpy(buffer, slot, msg_bytes);
+            shm_ring_release(&ring);
+
+            uint64_t now_ns = monotonic_ns();
+            if (frame_received(&fa, buffer, msg_bytes) != FRAME_COMPLETE) {
+                fprintf(stderr, "[Thread %d] Framing error (message_size mismatch?)\n", thread_id);
+                break;
+            }
+            const FrameHeader *hdr = frame_header(&fa);
+            stats.bytes_received += hdr->length;
+            stats.messages_received++;
+            ts_record(ts, hdr->length);
+            hist_record(&stats.latency, frame_age_ns(hdr, now_ns));
+        } else if (shm_ring_closed(&ring)) {
+            printf("[Thread %d] Server closed ring\n", thread_id);
+            break;
+        }
+
+        double elapsed = (monotonic_ns() - start_ns) / 1e9;
+        if (elapsed >= run_duration) running = 0;
+    }
+
+    stats.messages_lost = fa.lost;
+    stats.cpu_ns = thread_cpu_ns() - cpu_start;
+    stats.ring_sleeps = ring.sleeps;
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+    stats.elapsed_time = (end_time.tv_sec - start_time.tv_sec) +
+                        (end_time.tv_nsec - start_time.tv_nsec) / 1e9;
+
+    printf("[Thread %d] Msgs: %ld, Throughput: %.2f MB/s, futex sleeps: %ld\n",
+           thread_id, stats.messages_received,
+           (stats.bytes_received / (1024.0 * 1024.0)) / stats.elapsed_time,
+           stats.ring_sleeps);
+
+    // Tells the producer to stop
+    shm_ring_close(&ring);
+    shm_ring_detach(&ring);
+    free(buffer);
+
+    ThreadStats *result = malloc(sizeof(ThreadStats));
+    *result = stats;
+    return result;
+}
+
+int main(int argc, char *argv[]) {
+    // Optional flags (may appear anywhere): --wait=futex|spin (empty-ring waiting)
+    // --affinity=POLICY (pin threads to CPUs, see MT25190_Affinity.h)
+    // --timeseries=FILE --ts-interval=MS (per-interval samples, see MT25190_TimeSeries.h)
+    // --hw-counters (per-thread perf_event_open counters, see MT25190_HwCounters.h)
+    static const struct option long_options[] = {
+        {"wait", required_argument, 0, 'W'},
+        {"timeseries", required_argument, 0, 'T'},
+        {"ts-interval", required_argument, 0, 'I'},
+        {"hw-counters", no_argument, 0, 'K'},
+        {"affinity", required_argument, 0, 'a'},
+        {0, 0, 0, 0}
+    };
+    int opt_char;
+    while ((opt_char = getopt_long(argc, argv, "", long_options, NULL)) != -1) {
+        switch (opt_char) {
+        case 'W':
+            wait_mode = parse_wait_mode(optarg);
+            if (wait_mode < 0) {
+                fprintf(stderr, "Unknown wait mode '%s' (expected futex|spin)\n", optarg);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'T':
+            timeseries_path = optarg;
+            break;
+        case 'K':
+            hw_counters = 1;
+            break;
+        case 'I':
+            ts_interval_ms = atoi(optarg);
+            if (ts_interval_ms <= 0) {
+                fprintf(stderr, "Invalid --ts-interval '%s' (milliseconds)\n", optarg);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'a':
+            if (affinity_configure(optarg, AFFINITY_CLIENT) < 0) exit(EXIT_FAILURE);
+            break;
+        default:
+            fprintf(stderr, "Usage: %s <server_ip> <port> <message_size> <num_threads> "
+                            "<duration> [--wait=futex|spin] [--affinity=POLICY]\n"
+                            "       [--timeseries=FILE] [--ts-interval=MS] [--hw-counters]\n",
+                            argv[0]);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // Parse positional arguments: <server_ip> <port> <message_size> <num_threads> <duration>
+    // Same shape as A1-A5 for automation; server_ip is accepted but unused
+    if (argc > optind) strncpy(server_ip, argv[optind], sizeof(server_ip) - 1);
+    if (argc > optind + 1) server_port = atoi(argv[optind + 1]);
+    if (argc > optind + 2) message_size = atoi(argv[optind + 2]);
+    if (argc > optind + 3) num_threads = atoi(argv[optind + 3]);
+    if (argc > optind + 4) run_duration = atoi(argv[optind + 4]);
+    if (message_size < (int)sizeof(FrameHeader)) {
+        fprintf(stderr, "message_size must be >= %zu (frame header)\n", sizeof(FrameHeader));
+        exit(EXIT_FAILURE);
+    }
+
+    printf("=== PA02 Part A6: Shared-Memory Ring Client ===\n");
+    printf("Roll Number: MT25190\n");
+    printf("Ring: @MT25190_shm_%d, wait=%s, Duration: %d sec\n\n", server_port,
+           wait_mode == SHM_WAIT_SPIN ? "spin" : "futex", run_duration);
+
+    pthread_t *threads = malloc(num_threads * sizeof(pthread_t));
+    ThreadStats aggregate = {0};
+
+    if (hw_counters && hwc_enable() < 0) hw_counters = 0;
+    // Per-interval sampler: steady-state rates without the warm-up
+    if (timeseries_start(timeseries_path, ts_interval_ms, num_threads) < 0) exit(EXIT_FAILURE);
+
+    for (int i = 0; i < num_threads; i++) {
+        int *id = malloc(sizeof(int));
+        *id = i + 1;
+        pthread_create(&threads[i], NULL, client_thread, id);
+        usleep(10000);  // 10ms
+    }
+
+    for (int i = 0; i < num_threads; i++) {
+        ThreadStats *stats;
+        pthread_join(threads[i], (void**)&stats);
+        if (stats) {
+            aggregate.bytes_received += stats->bytes_received;
+            aggregate.messages_received += stats->messages_received;
+            aggregate.messages_lost += stats->messages_lost;
+            aggregate.cpu_ns += stats->cpu_ns;
+            aggregate.ring_sleeps += stats->ring_sleeps;
+            hist_merge(&aggregate.latency, &stats->latency);
+            if (stats->elapsed_time > aggregate.elapsed_time)
+                aggregate.elapsed_time = stats->elapsed_time;
+            free(stats);
+        }
+    }
+    TsSummary steady;
+    timeseries_stop(&steady);
+
+    printf("\n=== Aggregate ===\n");
+    printf("Messages: %ld, Bytes: %.2f MB, futex sleeps: %ld\n",
+           aggregate.messages_received,
+           aggregate.bytes_received / (1024.0 * 1024.0),
+           aggregate.ring_sleeps);
+    printf("Throughput: %.2f MB/s\n",
+           (aggregate.bytes_received / (1024.0 * 1024.0)) / aggregate.elapsed_time);
+    printf("Steady state: %.2f MB/s after %.2f s warm-up (%d of %d intervals, CV %.3f)\n",
+           steady.steady_gbps * 1e9 / 8 / (1024.0 * 1024.0), steady.warmup_s,
+           steady.steady_samples, steady.samples, steady.steady_cv);
+    // PA02 requirement: Output parseable metrics for script collection
+    double throughput_gbps = (aggregate.bytes_received * 8.0) / (aggregate.elapsed_time * 1e9);
+    double latency_us = (aggregate.elapsed_time * 1e6) / aggregate.messages_received;
+    // Tail latency from the merged per-thread histograms
+    char percentiles[160];
+    hist_format_metrics(&aggregate.latency, percentiles, sizeof(percentiles));
+    // Receive-side CPU cost: all client threads' CPU time per message
+    double cpu_us_per_msg = aggregate.messages_received
+                          ? aggregate.cpu_ns / 1e3 / aggregate.messages_received : 0.0;
+    char steady_rates[128];
+    timeseries_format_metrics(&steady, steady_rates, sizeof(steady_rates));
+    // Which threads paid for the run, in user and kernel mode
+    char hw[1024];
+    hwc_report("client", NULL);
+    hwc_format_metrics(hw, sizeof(hw));
+    // CPU placement of each server:client pair, to tie cache misses to topology
+    char placement[256];
+    affinity_format_metrics(num_threads, placement, sizeof(placement));
+    printf("METRICS throughput_gbps=%.6f latency_us=%.2f bytes=%ld lost=%ld "
+           "%s cpu_us_per_msg=%.3f %s %s %s\n",
+           throughput_gbps, latency_us, aggregate.bytes_received,
+           aggregate.messages_lost, percentiles, cpu_us_per_msg, steady_rates, hw, placement);
+    free(threads);
+    return 0;
+}
@@ -0,0 +1,266 @@
+/*
+ * Shared-memory server: the no-socket baseline for A1-A5
+ *
+ * Each client thread gets its own single-producer/single-consumer ring in a
+ * memfd (MT25190_ShmRing.h); the server thread for that client is the
+ * producer:
+ *
+ *   server thread:  8 fields --memcpy--> ring slot --publish--> (head++)
+ *   client thread:  (head != tail) --> ring slot --memcpy--> receive buffer
+ *
+ *   Copy 1: User fields → shared slot (stands in for send() into the socket buffer)
+ *   Copy 2: Shared slot → client buffer (stands in for recv())
+ *
+ * Same number of copies as A1/A2, but no syscalls, no skbs and no TCP/IP
+ * processing on the data path, so A6 is an upper bound for same-host
+ * transfer and the A1-A3 gap to it is the cost of the network stack.
+ * The only socket is an abstract Unix socket used once per client to pass
+ * the memfd (SCM_RIGHTS).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <errno.h>
+#include <signal.h>
+#include <getopt.h>
+
+#include "MT25190_ShmRing.h"
+#include "MT25190_Histogram.h"
+#include "MT25190_Framing.h"
+#include "MT25190_Affinity.h"
+#include "MT25190_HwCounters.h"
+
+#define DEFAULT_PORT 8085
+#define MAX_CLIENTS 100
+#define NUM_FIELDS 8
+#define WAIT_TIMEOUT_MS 100     // Re-check 'running' / peer close this often
+#define HW_REPORT_WAIT_MS 1000  // Sender threads to exit before --hw-counters reports
+
+int message_size = 1024;
+int num_threads = 4;
+int wait_mode = SHM_WAIT_FUTEX;
+uint32_t ring_slots = 0;        // --slots=N, 0 = shm_ring_default_slots()
+volatile sig_atomic_t running = 1;
+
+/* Signal handler for graceful shutdown */
+void signal_handler(int signum) {
+    (void)signum;
+    printf("\nReceived shutdown signal. Stopping server...\n");
+    running = 0;
+}
+
+/* Per-client producer state */
+typedef struct {
+    int control_sock;       // Unix connection the ring fd is passed over
+    ShmRing ring;           // Created here, mapped by the client from the passed fd
+} ShmConnection;
+
+/*
+ * fill_slot: Builds one message in a ring slot
+ * The 8 fields are copied in order (the shared-memory equivalent of the
+ * socket-buffer copy), then the frame header is stamped over the start of
+ * field 1 exactly as the socket servers do.
+ */
+static void fill_slot(char *slot, char *const fields[NUM_FIELDS], uint64_t seq) {
+    for (int i = 0; i < NUM_FIELDS; i++) {
+        memcpy(slot + (size_t)i * message_size, fields[i], message_size);
+    }
+    frame_stamp(slot, (uint32_t)(message_size * NUM_FIELDS), seq, monotonic_ns());
+}
+
+void* client_handler(void *arg) {
+    ShmConnection *c = (ShmConnection*)arg;
+    char *fields[NUM_FIELDS];
+    affinity_pin_next();    // Before creating the ring: its pages land on this CPU's node
+    hwc_thread_begin();     // Counted until the thread exits (--hw-counters)
+
+    // One ring per client thread; the client maps it from the passed fd
+    if (shm_ring_create(&c->ring, ring_slots, (uint32_t)(message_size * NUM_FIELDS),
+                        wait_mode) < 0) {
+        perror("Ring creation failed");
+        close(c->control_sock);
+        free(c);
+        return NULL;
+    }
+    if (shm_send_fd(c->control_sock, c->ring.fd) < 0) {
+        perror("Ring handoff failed");
+        shm_ring_detach(&c->ring);
+        close(c->control_sock);
+        free(c);
+        return NULL;
+    }
+    close(c->control_sock);     // The ring carries everything from here on
+
+    for (int i = 0; i < NUM_FIELDS; i++) {
+        fields[i] = malloc(message_size);
+        if (!fields[i]) {
+            perror("Failed to allocate field");
+            for (int j = 0; j < i; j++) free(fields[j]);
+            shm_ring_close(&c->ring);
+            shm_ring_detach(&c->ring);
+            free(c);
+            return NULL;
+        }
+        memset(fields[i], 'A' + i, message_size - 1);
+        fields[i][message_size - 1] = '\0';
+    }
+
+    printf("[Thread %lu] Client attached (%u slots x %u bytes)\n", pthread_self(),
+           c->ring.hdr->slots, c->ring.hdr->slot_size);
+
+    long messages_sent = 0;
+    while (running) {
+        char *slot = shm_ring_acquire(&c->ring, WAIT_TIMEOUT_MS);
+        if (!slot) {
+            if (shm_ring_closed(&c->ring)) {
+                printf("[Thread %lu] Client disconnected\n", pthread_self());
+                break;
+            }
+            continue;   // Ring full past the timeout: re-check 'running'
+        }
+        fill_slot(slot, fields, (uint64_t)messages_sent);
+        shm_ring_publish(&c->ring);
+        messages_sent++;
+    }
+
+    printf("[Thread %lu] Total messages sent: %ld (futex sleeps %ld, wakes %ld)\n",
+           pthread_self(), messages_sent, c->ring.sleeps, c->ring.wakes);
+
+    shm_ring_close(&c->ring);
+    shm_ring_detach(&c->ring);
+    for (int i = 0; i < NUM_FIELDS; i++) free(fields[i]);
+    free(c);
+    return NULL;
+}
+
+/*
+ * report_hw_counters: Per-thread lines and one SERVER_METRICS line of the
+ * sender threads (--hw-counters), once they have left after 'running' dropped
+ */
+static void report_hw_counters(void) {
+    char hw[1024];
+    hwc_wait_threads(HW_REPORT_WAIT_MS);
+    hwc_report("server", NULL);
+    hwc_format_metrics(hw, sizeof(hw));
+    printf("SERVER_METRICS %s\n", hw);
+}
+
+int main(int argc, char *argv[]) {
+    pthread_t thread_id;
+
+    signal(SIGINT, signal_handler);
+    signal(SIGTERM, signal_handler);
+
+    // Optional flags (may appear anywhere): --wait=futex|spin --slots=N
+    // --affinity=POLICY (pin threads to CPUs, see MT25190_Affinity.h)
+    // --hw-counters (per-thread perf_event_open counters, see MT25190_HwCounters.h)
+    int hw_counters = 0;
+    static const struct option long_options[] = {
+        {"wait",  required_argument, 0, 'W'},
+        {"slots", required_argument, 0, 's'},
+        {"affinity", required_argument, 0, 'a'},
+        {"hw-counters", no_argument, 0, 'K'},
+        {0, 0, 0, 0}
+    };
+    int opt_char;
+    while ((opt_char = getopt_long(argc, argv, "", long_options, NULL)) != -1) {
+        switch (opt_char) {
+        case 'W':
+            wait_mode = parse_wait_mode(optarg);
+            if (wait_mode < 0) {
+                fprintf(stderr, "Unknown wait mode '%s' (expected futex|spin)\n", optarg);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 's':
+            ring_slots = (uint32_t)atoi(optarg);
+            break;
+        case 'a':
+            if (affinity_configure(optarg, AFFINITY_SERVER) < 0) exit(EXIT_FAILURE);
+            break;
+        case 'K':
+            hw_counters = 1;
+            break;
+        default:
+            fprintf(stderr, "Usage: %s <port> <message_size> <num_threads> "
+                            "[--wait=futex|spin] [--slots=N] [--affinity=POLICY]\n"
+                            "       [--hw-counters]\n", argv[0]);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // Parse positional arguments: <port> <message_size> <num_threads>
+    // The port only names the Unix socket used to hand out the rings
+    int port = DEFAULT_PORT;
+    if (argc > optind) port = atoi(argv[optind]);
+    if (argc > optind + 1) message_size = atoi(argv[optind + 1]);
+    if (argc > optind + 2) num_threads = atoi(argv[optind + 2]);
+
+    if (message_size < (int)sizeof(FrameHeader)) {
+        fprintf(stderr, "message_size must be >= %zu (frame header)\n", sizeof(FrameHeader));
+        exit(EXIT_FAILURE);
+    }
+    uint32_t slot_size = (uint32_t)(message_size * NUM_FIELDS);
+    if (ring_slots == 0) ring_slots = shm_ring_default_slots(slot_size);
+
+    printf("=== PA02 Part A6: Shared-Memory Ring Server ===\n");
+    printf("Roll Number: MT25190\n");
+    printf("Port: %d (abstract Unix socket @MT25190_shm_%d)\n", port, port);
+    printf("Message size: %d bytes per field\n", message_size);
+    printf("Expected threads: %d\n", num_threads);
+    printf("Ring: %u slots per client, wait=%s\n", ring_slots,
+           wait_mode == SHM_WAIT_SPIN ? "spin" : "futex");
+    if (hw_counters && hwc_enable() < 0) hw_counters = 0;
+    printf("\n");
+
+    int server_sock = shm_listen(port, MAX_CLIENTS);
+    if (server_sock < 0) {
+        perror("Unix socket listen failed");
+        exit(EXIT_FAILURE);
+    }
+
+    printf("Server listening on @MT25190_shm_%d...\n", port);
+    printf("Waiting for %d client connections...\n\n", num_threads);
+
+    int connected_clients = 0;
+    while (connected_clients < num_threads && running) {
+        int client_sock = accept(server_sock, NULL, NULL);
+        if (client_sock < 0) {
+            if (errno != EINTR) perror("Accept failed");
+            continue;
+        }
+
+        ShmConnection *c = malloc(sizeof(ShmConnection));
+        if (!c) {
+            perror("Failed to allocate connection state");
+            close(client_sock);
+            continue;
+        }
+        c->control_sock = client_sock;     // The thread creates and hands out the ring
+
+        printf("Accepted connection %d\n", connected_clients + 1);
+
+        if (pthread_create(&thread_id, NULL, client_handler, c) != 0) {
+            perror("Thread creation failed");
+            close(client_sock);
+            free(c);
+            continue;
+        }
+        pthread_detach(thread_id);
+        connected_clients++;
+    }
+
+    printf("\nAll %d clients connected. Press Ctrl+C to stop.\n", num_threads);
+
+    while (running) {
+        sleep(1);
+    }
+
+    close(server_sock);
+    if (hw_counters) report_hw_counters();
+    return 0;
+}
@@ -0,0 +1,375 @@
+/*
+ * UDP datagram client for the A7 server
+ * Receives up to B datagrams per recvmmsg() call; each datagram is one
+ * whole frame, so there is no stream reassembly. With --gro the socket
+ * accepts coalesced super-packets (UDP_GRO) and splits them at the
+ * segment size the kernel reports.
+ * Copy 1: NIC → Kernel space (DMA)
+ * Copy 2: Kernel space → User space (via recvmmsg())
+ *
+ * UDP can drop and reorder: every thread counts gaps in the frame
+ * sequence (lost), late frames (reordered) and malformed datagrams.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <getopt.h>
+#include <errno.h>
+
+#include "MT25190_Histogram.h"
+#include "MT25190_Framing.h"
+#include "MT25190_Affinity.h"
+#include "MT25190_TimeSeries.h"
+#include "MT25190_HwCounters.h"
+
+#define DEFAULT_PORT 8086
+#define DEFAULT_SERVER "127.0.0.1"
+#define NUM_FIELDS 8
+#define RUN_DURATION 30
+#define MAX_BATCH 64
+#define GRO_BUFFER_SIZE 65536       // Largest coalesced GRO super-packet
+#define RCVBUF_BYTES (4 * 1024 * 1024)
+#define HELLO_INTERVAL_MS 100       // Registration retry / receive timeout
+
+typedef struct {
+    long bytes_received;
+    long messages_received;
+    double elapsed_time;
+    long messages_lost;     // Sequence gaps never filled by a late datagram
+    uint64_t cpu_ns;        // Thread CPU time (user + system) while receiving
+    long messages_reordered;// Datagrams that arrived after a later one
+    long invalid;           // Truncated or malformed datagrams
+    // Per-message latency: one-way delay from the frame's send timestamp
+    LatencyHistogram latency;
+} ThreadStats;
+
+char server_ip[32] = DEFAULT_SERVER;
+int server_port = DEFAULT_PORT;
+int message_size = 1024;
+int num_threads = 4;
+int run_duration = RUN_DURATION;
+const char *timeseries_path = NULL;     // Per-interval samples as CSV (--timeseries=FILE)
+int ts_interval_ms = TS_DEFAULT_INTERVAL_MS;    // Sampling period (--ts-interval=MS)
+int hw_counters = 0;                    // Per-thread perf_event_open counters (--hw-counters)
+int batch_size = 8;
+int use_gro = 0;            // 1: accept UDP_GRO super-packets (--gro)
+volatile int running = 1;
+
+/*
+ * account_datagram: Frame accounting for one datagram (or GRO segment)
+ */
+static void account_datagram(ThreadStats *stats, TsCounter *ts, FrameAssembler *fa,
+                             const char *data, size_t len, uint64_t now_ns) {
+    if (frame_datagram(fa, data, len) != FRAME_COMPLETE) {
+        stats->invalid++;
+        return;
+    }
+    const FrameHeader *hdr = frame_header(fa);
+    stats->bytes_received += hdr->length;
+    stats->messages_received++;
+    ts_record(ts, hdr->length);
+    hist_record(&stats->latency, frame_age_ns(hdr, now_ns));
+}
+
+/*
+ * gro_segment_size: Segment size of a coalesced datagram, 0 if it was not
+ * coalesced (the kernel attaches a UDP_GRO cmsg only to super-packets)
+ */
+static size_t gro_segment_size(struct msghdr *mh) {
+    for (struct cmsghdr *cm = CMSG_FIRSTHDR(mh); cm; cm = CMSG_NXTHDR(mh, cm)) {
+        if (cm->cmsg_level == SOL_UDP && cm->cmsg_type == UDP_GRO) {
+            int size;
+            memcpy(&size, CMSG_DATA(cm), sizeof(size));
+            return size > 0 ? (size_t)size : 0;
+        }
+    }
+    return 0;
+}
+
+void* client_thread(void *arg) {
+    int thread_id = *(int*)arg;
+    free(arg);
+    affinity_pin_next();    // Before allocating: buffers land on this CPU's node
+    hwc_thread_begin();     // Counted until the thread exits (--hw-counters)
+    TsCounter *ts = timeseries_counter(thread_id - 1);
+
+    ThreadStats stats = {0};
+    struct timespec start_time, end_time;
+    FrameAssembler fa;
+    size_t msg_bytes = (size_t)message_size * NUM_FIELDS;
+    // One extra byte exposes oversized datagrams as MSG_TRUNC
+    size_t slot_size = use_gro ? GRO_BUFFER_SIZE : msg_bytes + 1;
+
+    char *buffers = malloc(slot_size * batch_size);
+    struct mmsghdr *msgs = calloc(batch_size, sizeof(struct mmsghdr));
+    struct iovec *iov = calloc(batch_size, sizeof(struct iovec));
+    char (*control)[CMSG_SPACE(sizeof(int))] = calloc(batch_size, sizeof(*control));
+    if (!buffers || !msgs || !iov || !control) {
+        perror("Failed to allocate receive batch");
+        free(buffers);
+        free(msgs);
+        free(iov);
+        free(control);
+        return NULL;
+    }
+
+    int sock = socket(AF_INET, SOCK_DGRAM, 0);
+    if (sock < 0) {
+        perror("Socket creation failed");
+        free(buffers);
+        free(msgs);
+        free(iov);
+        free(control);
+        return NULL;
+    }
+
+    // Large receive buffer: a datagram that does not fit is dropped (= lost)
+    int rcvbuf = RCVBUF_BYTES;
+    setsockopt(sock, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    struct timeval tv = { 0, HELLO_INTERVAL_MS * 1000 };
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    int one = 1;
+    if (use_gro && setsockopt(sock, SOL_UDP, UDP_GRO, &one, sizeof(one)) < 0) {
+        perror("UDP_GRO unavailable");
+    }
+
+    struct sockaddr_in server_addr;
+    memset(&server_addr, 0, sizeof(server_addr));
+    server_addr.sin_family = AF_INET;
+    server_addr.sin_port = htons(server_port);
+    inet_pton(AF_INET, server_ip, &server_addr.sin_addr);
+
+    // Hello: a bare frame header announcing the expected datagram size
+    FrameHeader hello;
+    frame_stamp(&hello, (uint32_t)msg_bytes, 0, 0);
+
+    printf("[Thread %d] Registering...\n", thread_id);
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+    uint64_t start_ns = monotonic_ns();
+    uint64_t cpu_start = thread_cpu_ns();
+    frame_assembler_init(&fa, msg_bytes);
+
+    int registered = 0;
+    while (running) {
+        // Re-send the hello until the first datagram proves it arrived
+        if (!registered &&
+            sendto(sock, &hello, sizeof(hello), 0,
+                   (struct sockaddr*)&server_addr, sizeof(server_addr)) < 0) {
+            perror("Hello send failed");
+            break;
+        }
+
+        for (int i = 0; i < batch_size; i++) {
+            iov[i].iov_base = buffers + (size_t)i * slot_size;
+            iov[i].iov_len = slot_size;
+            memset(&msgs[i].msg_hdr, 0, sizeof(msgs[i].msg_hdr));
+            msgs[i].msg_hdr.msg_iov = &iov[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+            msgs[i].msg_hdr.msg_control = control[i];
+            msgs[i].msg_hdr.msg_controllen = sizeof(control[i]);
+        }
+
+        // Blocks for the first datagram (up to the receive timeout), then
+        // returns whatever else is already queued, up to batch_size
+        int n = recvmmsg(sock, msgs, (unsigned)batch_size, MSG_WAITFORONE, NULL);
+        uint64_t now_ns = monotonic_ns();
+        if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            perror("recvmmsg error");
+            break;
+        }
+        if (n > 0 && !registered) {
+            registered = 1;
+            printf("[Thread %d] Receiving\n", thread_id);
+        }
+
+        for (int i = 0; i < n; i++) {
+            struct msghdr *mh = &msgs[i].msg_hdr;
+            size_t len = msgs[i].msg_len;
+            if (mh->msg_flags & MSG_TRUNC) {
+                stats.invalid++;
+                continue;
+            }
+            size_t seg = use_gro ? gro_segment_size(mh) : 0;
+            if (seg == 0) seg = len;
+            for (size_t off = 0; off < len; off += seg) {
+                size_t chunk = len - off < seg ? len - off : seg;
+                account_datagram(&stats, ts, &fa, (const char*)iov[i].iov_base + off, chunk,
+                                 now_ns);
+            }
+        }
+
+        double elapsed = (now_ns - start_ns) / 1e9;
+        if (elapsed >= run_duration) running = 0;
+    }
+
+    stats.messages_lost = fa.lost;
+    stats.cpu_ns = thread_cpu_ns() - cpu_start;
+    stats.messages_reordered = fa.reordered;
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+    stats.elapsed_time = (end_time.tv_sec - start_time.tv_sec) +
+                        (end_time.tv_nsec - start_time.tv_nsec) / 1e9;
+
+    printf("[Thread %d] Msgs: %ld, Throughput: %.2f MB/s, lost: %ld, reordered: %ld, "
+           "invalid: %ld\n", thread_id, stats.messages_received,
+           (stats.bytes_received / (1024.0 * 1024.0)) / stats.elapsed_time,
+           stats.messages_lost, stats.messages_reordered, stats.invalid);
+
+    // Closing the socket makes the server's next send fail (ECONNREFUSED)
+    close(sock);
+    free(buffers);
+    free(msgs);
+    free(iov);
+    free(control);
+
+    ThreadStats *result = malloc(sizeof(ThreadStats));
+    *result = stats;
+    return result;
+}
+
+int main(int argc, char *argv[]) {
+    // Optional flags (may appear anywhere): --batch=N (datagrams per recvmmsg)
+    // --gro (accept coalesced super-packets)
+    // --affinity=POLICY (pin threads to CPUs, see MT25190_Affinity.h)
+    // --timeseries=FILE --ts-interval=MS (per-interval samples, see MT25190_TimeSeries.h)
+    // --hw-counters (per-thread perf_event_open counters, see MT25190_HwCounters.h)
+    static const struct option long_options[] = {
+        {"batch", required_argument, 0, 'b'},
+        {"gro",   no_argument,       0, 'g'},
+        {"timeseries", required_argument, 0, 'T'},
+        {"ts-interval", required_argument, 0, 'I'},
+        {"hw-counters", no_argument, 0, 'K'},
+        {"affinity", required_argument, 0, 'a'},
+        {0, 0, 0, 0}
+    };
+    int opt_char;
+    while ((opt_char = getopt_long(argc, argv, "", long_options, NULL)) != -1) {
+        switch (opt_char) {
+        case 'b':
+            batch_size = atoi(optarg);
+            break;
+        case 'g':
+            use_gro = 1;
+            break;
+        case 'T':
+            timeseries_path = optarg;
+            break;
+        case 'K':
+            hw_counters = 1;
+            break;
+        case 'I':
+            ts_interval_ms = atoi(optarg);
+            if (ts_interval_ms <= 0) {
+                fprintf(stderr, "Invalid --ts-interval '%s' (milliseconds)\n", optarg);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'a':
+            if (affinity_configure(optarg, AFFINITY_CLIENT) < 0) exit(EXIT_FAILURE);
+            break;
+        default:
+            fprintf(stderr, "Usage: %s <server_ip> <port> <message_size> <num_threads> "
+                            "<duration> [--batch=N] [--gro] [--affinity=POLICY]\n"
+                            "       [--timeseries=FILE] [--ts-interval=MS] [--hw-counters]\n",
+                            argv[0]);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // Parse positional arguments: <server_ip> <port> <message_size> <num_threads> <duration>
+    // PA02 requirement: All parameters must be passed explicitly for automation
+    if (argc > optind) strncpy(server_ip, argv[optind], sizeof(server_ip) - 1);
+    if (argc > optind + 1) server_port = atoi(argv[optind + 1]);
+    if (argc > optind + 2) message_size = atoi(argv[optind + 2]);
+    if (argc > optind + 3) num_threads = atoi(argv[optind + 3]);
+    if (argc > optind + 4) run_duration = atoi(argv[optind + 4]);
+    if (message_size < (int)sizeof(FrameHeader)) {
+        fprintf(stderr, "message_size must be >= %zu (frame header)\n", sizeof(FrameHeader));
+        exit(EXIT_FAILURE);
+    }
+    if (batch_size < 1) batch_size = 1;
+    if (batch_size > MAX_BATCH) batch_size = MAX_BATCH;
+
+    printf("=== PA02 Part A7: UDP Datagram Client ===\n");
+    printf("Roll Number: MT25190\n");
+    printf("Server: %s:%d, Duration: %d sec\n", server_ip, server_port, run_duration);
+    printf("Receive: recvmmsg() x%d%s\n\n", batch_size, use_gro ? " with UDP_GRO" : "");
+
+    pthread_t *threads = malloc(num_threads * sizeof(pthread_t));
+    ThreadStats aggregate = {0};
+
+    if (hw_counters && hwc_enable() < 0) hw_counters = 0;
+    // Per-interval sampler: steady-state rates without the warm-up
+    if (timeseries_start(timeseries_path, ts_interval_ms, num_threads) < 0) exit(EXIT_FAILURE);
+
+    for (int i = 0; i < num_threads; i++) {
+        int *id = malloc(sizeof(int));
+        *id = i + 1;
+        pthread_create(&threads[i], NULL, client_thread, id);
+        usleep(10000);  // 10ms
+    }
+
+    for (int i = 0; i < num_threads; i++) {
+        ThreadStats *stats;
+        pthread_join(threads[i], (void**)&stats);
+        if (stats) {
+            aggregate.bytes_received += stats->bytes_received;
+            aggregate.messages_received += stats->messages_received;
+            aggregate.messages_lost += stats->messages_lost;
+            aggregate.cpu_ns += stats->cpu_ns;
+            aggregate.messages_reordered += stats->messages_reordered;
+            aggregate.invalid += stats->invalid;
+            hist_merge(&aggregate.latency, &stats->latency);
+            if (stats->elapsed_time > aggregate.elapsed_time)
+                aggregate.elapsed_time = stats->elapsed_time;
+            free(stats);
+        }
+    }
+    TsSummary steady;
+    timeseries_stop(&steady);
+
+    printf("\n=== Aggregate ===\n");
+    printf("Messages: %ld, Bytes: %.2f MB\n",
+           aggregate.messages_received,
+           aggregate.bytes_received / (1024.0 * 1024.0));
+    printf("Lost: %ld, Reordered: %ld, Invalid: %ld\n",
+           aggregate.messages_lost, aggregate.messages_reordered, aggregate.invalid);
+    printf("Throughput: %.2f MB/s\n",
+           (aggregate.bytes_received / (1024.0 * 1024.0)) / aggregate.elapsed_time);
+    printf("Steady state: %.2f MB/s after %.2f s warm-up (%d of %d intervals, CV %.3f)\n",
+           steady.steady_gbps * 1e9 / 8 / (1024.0 * 1024.0), steady.warmup_s,
+           steady.steady_samples, steady.samples, steady.steady_cv);
+    // PA02 requirement: Output parseable metrics for script collection
+    double throughput_gbps = (aggregate.bytes_received * 8.0) / (aggregate.elapsed_time * 1e9);
+    double latency_us = (aggregate.elapsed_time * 1e6) / aggregate.messages_received;
+    // Tail latency from the merged per-thread histograms
+    char percentiles[160];
+    hist_format_metrics(&aggregate.latency, percentiles, sizeof(percentiles));
+    // Receive-side CPU cost: all client threads' CPU time per message
+    double cpu_us_per_msg = aggregate.messages_received
+                          ? aggregate.cpu_ns / 1e3 / aggregate.messages_received : 0.0;
+    char steady_rates[128];
+    timeseries_format_metrics(&steady, steady_rates, sizeof(steady_rates));
+    // Which threads paid for the run, in user and kernel mode
+    char hw[1024];
+    hwc_report("client", NULL);
+    hwc_format_metrics(hw, sizeof(hw));
+    // CPU placement of each server:client pair, to tie cache misses to topology
+    char placement[256];
+    affinity_format_metrics(num_threads, placement, sizeof(placement));
+    printf("METRICS throughput_gbps=%.6f latency_us=%.2f bytes=%ld lost=%ld "
+           "reordered=%ld %s cpu_us_per_msg=%.3f %s %s %s\n",
+           throughput_gbps, latency_us, aggregate.bytes_received,
+           aggregate.messages_lost, aggregate.messages_reordered, percentiles,
+           cpu_us_per_msg, steady_rates, hw, placement);
+    free(threads);
+    return 0;
+}
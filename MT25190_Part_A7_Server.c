@@ -0,0 +1,582 @@
+/*
+ * UDP datagram server: the A1/A2/A3 copy strategies over UDP
+ *
+ * Every message is one datagram carrying one frame (8 fields, header
+ * first), and messages go out in batches of B:
+ *
+ *   sendmmsg():         [frame][frame][frame] ...  -> B datagrams, 1 syscall
+ *   --gso (UDP_SEGMENT): [frame|frame|frame ...]   -> 1 super-packet through
+ *                        the stack, split into B datagrams at the bottom
+ *
+ * Copy strategy (--copy):
+ *   two:  fields --memcpy--> staging frame --send copy--> kernel (like A1's
+ *         user-level assembly plus the socket copy)
+ *   one:  per-message iovec {header, field 1 tail, fields 2..8}; the kernel
+ *         gathers straight from the fields (like A2's sendmsg)
+ *   zero: frames in a ring of pinned slots sent with MSG_ZEROCOPY; a slot is
+ *         rewritten only after its MSG_ERRQUEUE completion (like A3)
+ *
+ * UDP has no connection: each client thread registers by sending a hello
+ * datagram to the server port, and the server answers from a new socket
+ * connect()ed to that client. When the client closes its socket the next
+ * send fails with ECONNREFUSED and the sender thread exits.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <sys/socket.h>
+#include <sys/mman.h>
+#include <linux/errqueue.h>
+#include <poll.h>
+#include <errno.h>
+#include <signal.h>
+#include <getopt.h>
+
+#include "MT25190_Histogram.h"
+#include "MT25190_Framing.h"
+#include "MT25190_Affinity.h"
+#include "MT25190_HwCounters.h"
+
+#define DEFAULT_PORT 8086
+#define NUM_FIELDS 8
+#define MAX_BATCH 64            // Datagrams per sendmmsg() / GSO super-packet
+#define UDP_MAX_PAYLOAD 65507   // 65535 - IPv4 header - UDP header
+#define DEFAULT_ZC_DEPTH 8      // Batches in flight with --copy=zero
+#define HW_REPORT_WAIT_MS 1000  // Sender threads to exit before --hw-counters reports
+
+/* Copy strategy (--copy) */
+typedef enum {
+    COPY_TWO  = 0,
+    COPY_ONE  = 1,
+    COPY_ZERO = 2
+} CopyMode;
+
+int message_size = 1024;
+int num_threads = 4;
+int copy_mode = COPY_ONE;
+int batch_size = 8;
+int use_gso = 0;                    // 1: one UDP_SEGMENT super-packet per batch (--gso)
+int zc_depth = DEFAULT_ZC_DEPTH;
+size_t message_bytes;               // NUM_FIELDS * message_size: one datagram
+volatile sig_atomic_t running = 1;
+
+/* Signal handler for graceful shutdown */
+void signal_handler(int signum) {
+    (void)signum;
+    printf("\nReceived shutdown signal. Stopping server...\n");
+    running = 0;
+}
+
+/*
+ * Per-client sender
+ * 'pool' holds 'depth' slots of 'batch_size' contiguous frames: one staging
+ * slot for --copy=two, the pinned in-flight ring for --copy=zero.
+ * Zero-copy ids are mapped back to slots exactly as in A3.
+ */
+typedef struct {
+    int sockfd;
+    struct sockaddr_in peer;
+    char *fields[NUM_FIELDS];       // Source fields ('A'..'H')
+    FrameHeader headers[MAX_BATCH]; // --copy=one: per-datagram header iovecs
+    struct iovec iov[MAX_BATCH * (NUM_FIELDS + 1)];
+    struct mmsghdr msgs[MAX_BATCH];
+    int iov_per_msg;
+    char *pool;
+    size_t stride;                  // Slot spacing, whole pages
+    int depth;
+    int *inflight;                  // Per slot: zerocopy sends still referencing it
+    int *seq_slot;                  // Zerocopy id -> slot (-1 when unused)
+    int seq_map_size;
+    uint32_t next_zc_id;
+    int next_slot;
+    int zerocopy;                   // SO_ZEROCOPY active
+    uint64_t frame_seq;
+    long completions;
+} UdpSender;
+
+static char* pool_slot(UdpSender *s, int slot) {
+    return s->pool + (size_t)slot * s->stride;
+}
+
+/*
+ * drain_completions: Frees ring slots whose MSG_ZEROCOPY sends completed
+ */
+static void drain_completions(UdpSender *s) {
+    char control[128];
+    struct msghdr msg = {0};
+    msg.msg_control = control;
+
+    while (1) {
+        msg.msg_controllen = sizeof(control);
+        if (recvmsg(s->sockfd, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) break;
+
+        struct cmsghdr *cm = CMSG_FIRSTHDR(&msg);
+        if (!cm || cm->cmsg_level != SOL_IP || cm->cmsg_type != IP_RECVERR) continue;
+        struct sock_extended_err *serr = (struct sock_extended_err*)CMSG_DATA(cm);
+        if (serr->ee_errno != 0 || serr->ee_origin != SO_EE_ORIGIN_ZEROCOPY) continue;
+
+        // Inclusive, wrap-safe id range [ee_info, ee_data]
+        for (uint32_t id = serr->ee_info; ; id++) {
+            int idx = (int)(id % (uint32_t)s->seq_map_size);
+            int slot = s->seq_slot[idx];
+            if (slot >= 0) {
+                s->seq_slot[idx] = -1;
+                s->inflight[slot]--;
+            }
+            if (id == serr->ee_data) break;
+        }
+        s->completions++;
+    }
+}
+
+static void wait_for_completion(UdpSender *s) {
+    struct pollfd pfd = { .fd = s->sockfd, .events = 0 };
+    poll(&pfd, 1, 100);
+    drain_completions(s);
+}
+
+/*
+ * acquire_slot: Slot for the next batch
+ * Copying strategies always reuse slot 0; zero-copy blocks until a slot and
+ * enough sequence-map entries for a whole batch are free.
+ */
+static int acquire_slot(UdpSender *s) {
+    if (copy_mode != COPY_ZERO || !s->zerocopy) return 0;
+    drain_completions(s);
+    while (running) {
+        int ids_free = 1;
+        for (int i = 0; i < batch_size && ids_free; i++) {
+            ids_free = s->seq_slot[(s->next_zc_id + i) % (uint32_t)s->seq_map_size] < 0;
+        }
+        for (int i = 0; ids_free && i < s->depth; i++) {
+            int slot = (s->next_slot + i) % s->depth;
+            if (s->inflight[slot] == 0) {
+                s->next_slot = (slot + 1) % s->depth;
+                return slot;
+            }
+        }
+        wait_for_completion(s);
+    }
+    errno = EINTR;
+    return -1;
+}
+
+/* track_zerocopy: Records 'n' successful MSG_ZEROCOPY sends from 'slot' */
+static void track_zerocopy(UdpSender *s, int slot, int n) {
+    if (copy_mode != COPY_ZERO || !s->zerocopy) return;
+    for (int i = 0; i < n; i++) {
+        s->seq_slot[s->next_zc_id % (uint32_t)s->seq_map_size] = slot;
+        s->inflight[slot]++;
+        s->next_zc_id++;
+    }
+}
+
+/*
+ * build_batch: Stamps 'count' frames and points the mmsghdrs at them
+ */
+static void build_batch(UdpSender *s, int slot, int count) {
+    for (int i = 0; i < count; i++) {
+        struct iovec *iov = &s->iov[i * s->iov_per_msg];
+        uint64_t now = monotonic_ns();
+
+        if (copy_mode == COPY_ONE) {
+            // Scatter-gather: only the 32-byte header differs per datagram
+            frame_stamp(&s->headers[i], (uint32_t)message_bytes, s->frame_seq++, now);
+            iov[0].iov_base = &s->headers[i];
+            iov[0].iov_len = sizeof(FrameHeader);
+            iov[1].iov_base = s->fields[0] + sizeof(FrameHeader);
+            iov[1].iov_len = message_size - sizeof(FrameHeader);
+            for (int f = 1; f < NUM_FIELDS; f++) {
+                iov[f + 1].iov_base = s->fields[f];
+                iov[f + 1].iov_len = message_size;
+            }
+        } else {
+            char *frame = pool_slot(s, slot) + (size_t)i * message_bytes;
+            if (copy_mode == COPY_TWO) {
+                // Copy 1: assemble the datagram in user space
+                for (int f = 0; f < NUM_FIELDS; f++) {
+                    memcpy(frame + (size_t)f * message_size, s->fields[f], message_size);
+                }
+            }
+            frame_stamp(frame, (uint32_t)message_bytes, s->frame_seq++, now);
+            iov[0].iov_base = frame;
+            iov[0].iov_len = message_bytes;
+        }
+
+        memset(&s->msgs[i].msg_hdr, 0, sizeof(s->msgs[i].msg_hdr));
+        s->msgs[i].msg_hdr.msg_iov = iov;
+        s->msgs[i].msg_hdr.msg_iovlen = s->iov_per_msg;
+    }
+}
+
+/*
+ * send_batch: Sends 'count' built datagrams
+ * --gso: one sendmsg() whose payload the stack splits every message_bytes
+ * (UDP_SEGMENT); otherwise sendmmsg(), resumed after partial returns.
+ * Returns 0, or -1 with errno set (ECONNREFUSED once the client is gone).
+ */
+static int send_batch(UdpSender *s, int slot, int count) {
+    int flags = (copy_mode == COPY_ZERO && s->zerocopy) ? MSG_ZEROCOPY : 0;
+
+    if (use_gso) {
+        char control[CMSG_SPACE(sizeof(uint16_t))] = {0};
+        struct msghdr mh = {0};
+        mh.msg_iov = s->iov;
+        mh.msg_iovlen = (size_t)count * s->iov_per_msg;
+        mh.msg_control = control;
+        mh.msg_controllen = sizeof(control);
+        struct cmsghdr *cm = CMSG_FIRSTHDR(&mh);
+        cm->cmsg_level = SOL_UDP;
+        cm->cmsg_type = UDP_SEGMENT;
+        cm->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+        uint16_t gso_size = (uint16_t)message_bytes;
+        memcpy(CMSG_DATA(cm), &gso_size, sizeof(gso_size));
+
+        while (sendmsg(s->sockfd, &mh, flags) < 0) {
+            if ((errno == EINTR || errno == ENOBUFS) && running) {
+                if (errno == ENOBUFS && flags) wait_for_completion(s);
+                continue;
+            }
+            return -1;
+        }
+        track_zerocopy(s, slot, 1);
+        return 0;
+    }
+
+    int done = 0;
+    while (done < count) {
+        int n = sendmmsg(s->sockfd, s->msgs + done, (unsigned)(count - done), flags);
+        if (n < 0) {
+            if ((errno == EINTR || errno == ENOBUFS) && running) {
+                if (errno == ENOBUFS && flags) wait_for_completion(s);
+                continue;
+            }
+            return -1;
+        }
+        track_zerocopy(s, slot, n);
+        done += n;
+    }
+    return 0;
+}
+
+static void free_sender(UdpSender *s) {
+    // Bounded wait so the kernel no longer references pinned slots
+    for (int waited = 0; copy_mode == COPY_ZERO && s->zerocopy && waited < 10; waited++) {
+        int busy = 0;
+        for (int i = 0; i < s->depth; i++) busy += s->inflight[i];
+        if (!busy) break;
+        wait_for_completion(s);
+    }
+    if (s->pool) {
+        if (copy_mode == COPY_ZERO) munlock(s->pool, s->stride * s->depth);
+        free(s->pool);
+    }
+    for (int i = 0; i < NUM_FIELDS; i++) free(s->fields[i]);
+    free(s->inflight);
+    free(s->seq_slot);
+    if (s->sockfd >= 0) close(s->sockfd);
+    free(s);
+}
+
+/*
+ * create_sender: Socket connect()ed to the client plus the buffers for
+ * the selected copy strategy. Returns NULL on failure.
+ */
+static UdpSender* create_sender(const struct sockaddr_in *peer) {
+    UdpSender *s = calloc(1, sizeof(UdpSender));
+    if (!s) {
+        perror("Failed to allocate sender");
+        return NULL;
+    }
+    s->peer = *peer;
+    s->sockfd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (s->sockfd < 0) {
+        perror("Socket creation failed");
+        free(s);
+        return NULL;
+    }
+    if (connect(s->sockfd, (const struct sockaddr*)peer, sizeof(*peer)) < 0) {
+        perror("UDP connect failed");
+        free_sender(s);
+        return NULL;
+    }
+
+    for (int i = 0; i < NUM_FIELDS; i++) {
+        s->fields[i] = aligned_alloc(4096, ((size_t)message_size + 4095) & ~(size_t)4095);
+        if (!s->fields[i]) {
+            perror("Failed to allocate field");
+            free_sender(s);
+            return NULL;
+        }
+        memset(s->fields[i], 'A' + i, message_size - 1);
+        s->fields[i][message_size - 1] = '\0';
+    }
+    s->iov_per_msg = copy_mode == COPY_ONE ? NUM_FIELDS + 1 : 1;
+    if (copy_mode == COPY_ONE) return s;
+
+    int one = 1;
+    if (copy_mode == COPY_ZERO &&
+        setsockopt(s->sockfd, SOL_SOCKET, SO_ZEROCOPY, &one, sizeof(one)) == 0) {
+        s->zerocopy = 1;
+    } else if (copy_mode == COPY_ZERO) {
+        perror("SO_ZEROCOPY unavailable - sending with copies");
+    }
+
+    s->depth = copy_mode == COPY_ZERO ? zc_depth : 1;
+    s->stride = ((size_t)batch_size * message_bytes + 4095) & ~(size_t)4095;
+    s->pool = aligned_alloc(4096, s->stride * s->depth);
+    s->seq_map_size = s->depth * batch_size;
+    s->inflight = calloc(s->depth, sizeof(int));
+    s->seq_slot = malloc(s->seq_map_size * sizeof(int));
+    if (!s->pool || !s->inflight || !s->seq_slot) {
+        perror("Failed to allocate send slots");
+        free_sender(s);
+        return NULL;
+    }
+    for (int i = 0; i < s->seq_map_size; i++) s->seq_slot[i] = -1;
+    if (copy_mode == COPY_ZERO && mlock(s->pool, s->stride * s->depth) != 0) {
+        perror("mlock failed - zero-copy may not work");
+    }
+
+    // Zero-copy slots hold the fields permanently; only headers are rewritten
+    for (int slot = 0; slot < s->depth; slot++) {
+        for (int i = 0; i < batch_size; i++) {
+            char *frame = pool_slot(s, slot) + (size_t)i * message_bytes;
+            for (int f = 0; f < NUM_FIELDS; f++) {
+                memcpy(frame + (size_t)f * message_size, s->fields[f], message_size);
+            }
+        }
+    }
+    return s;
+}
+
+void* client_handler(void *arg) {
+    struct sockaddr_in peer = *(struct sockaddr_in*)arg;
+    free(arg);
+    affinity_pin_next();    // Before allocating: send slots land on this CPU's node
+    hwc_thread_begin();     // Counted until the thread exits (--hw-counters)
+
+    UdpSender *s = create_sender(&peer);
+    if (!s) return NULL;
+
+    printf("[Thread %lu] Streaming to %s:%d\n", pthread_self(),
+           inet_ntoa(s->peer.sin_addr), ntohs(s->peer.sin_port));
+
+    long messages_sent = 0;
+    while (running) {
+        int slot = acquire_slot(s);
+        if (slot < 0) break;
+        build_batch(s, slot, batch_size);
+        if (send_batch(s, slot, batch_size) < 0) {
+            if (errno == ECONNREFUSED || errno == EINTR) {
+                printf("[Thread %lu] Client disconnected\n", pthread_self());
+            } else {
+                perror(use_gso ? "UDP GSO send error" : "sendmmsg error");
+            }
+            break;
+        }
+        messages_sent += batch_size;
+    }
+
+    printf("[Thread %lu] Total messages sent: %ld", pthread_self(), messages_sent);
+    if (copy_mode == COPY_ZERO) printf(" (zerocopy completions: %ld)", s->completions);
+    printf("\n");
+
+    free_sender(s);
+    return NULL;
+}
+
+/*
+ * report_hw_counters: Per-thread lines and one SERVER_METRICS line of the
+ * sender threads (--hw-counters), once they have left after 'running' dropped
+ */
+static void report_hw_counters(void) {
+    char hw[1024];
+    hwc_wait_threads(HW_REPORT_WAIT_MS);
+    hwc_report("server", NULL);
+    hwc_format_metrics(hw, sizeof(hw));
+    printf("SERVER_METRICS %s\n", hw);
+}
+
+int main(int argc, char *argv[]) {
+    pthread_t thread_id;
+
+    signal(SIGINT, signal_handler);
+    signal(SIGTERM, signal_handler);
+
+    // Optional flags (may appear anywhere): --copy=two|one|zero --batch=N
+    // --gso --depth=K (zero-copy batches in flight)
+    // --affinity=POLICY (pin threads to CPUs, see MT25190_Affinity.h)
+    // --hw-counters (per-thread perf_event_open counters, see MT25190_HwCounters.h)
+    int hw_counters = 0;
+    static const struct option long_options[] = {
+        {"copy",  required_argument, 0, 'c'},
+        {"batch", required_argument, 0, 'b'},
+        {"gso",   no_argument,       0, 'g'},
+        {"depth", required_argument, 0, 'd'},
+        {"affinity", required_argument, 0, 'a'},
+        {"hw-counters", no_argument, 0, 'K'},
+        {0, 0, 0, 0}
+    };
+    int opt_char;
+    while ((opt_char = getopt_long(argc, argv, "", long_options, NULL)) != -1) {
+        switch (opt_char) {
+        case 'c':
+            if (strcmp(optarg, "two") == 0) {
+                copy_mode = COPY_TWO;
+            } else if (strcmp(optarg, "one") == 0) {
+                copy_mode = COPY_ONE;
+            } else if (strcmp(optarg, "zero") == 0) {
+                copy_mode = COPY_ZERO;
+            } else {
+                fprintf(stderr, "Unknown copy mode '%s' (expected two|one|zero)\n", optarg);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'b':
+            batch_size = atoi(optarg);
+            break;
+        case 'g':
+            use_gso = 1;
+            break;
+        case 'd':
+            zc_depth = atoi(optarg);
+            break;
+        case 'a':
+            if (affinity_configure(optarg, AFFINITY_SERVER) < 0) exit(EXIT_FAILURE);
+            break;
+        case 'K':
+            hw_counters = 1;
+            break;
+        default:
+            fprintf(stderr, "Usage: %s <port> <message_size> <num_threads> "
+                            "[--copy=two|one|zero] [--batch=N] [--gso] [--depth=K] "
+                            "[--affinity=POLICY] [--hw-counters]\n", argv[0]);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // Parse positional arguments: <port> <message_size> <num_threads>
+    int port = DEFAULT_PORT;
+    if (argc > optind) port = atoi(argv[optind]);
+    if (argc > optind + 1) message_size = atoi(argv[optind + 1]);
+    if (argc > optind + 2) num_threads = atoi(argv[optind + 2]);
+
+    if (message_size < (int)sizeof(FrameHeader)) {
+        fprintf(stderr, "message_size must be >= %zu (frame header)\n", sizeof(FrameHeader));
+        exit(EXIT_FAILURE);
+    }
+    message_bytes = (size_t)message_size * NUM_FIELDS;
+    if (message_bytes > UDP_MAX_PAYLOAD) {
+        fprintf(stderr, "message_size must be <= %d (one datagram per message)\n",
+                UDP_MAX_PAYLOAD / NUM_FIELDS);
+        exit(EXIT_FAILURE);
+    }
+    if (batch_size < 1) batch_size = 1;
+    if (batch_size > MAX_BATCH) batch_size = MAX_BATCH;
+    // A GSO super-packet is itself one UDP datagram on the way down
+    if (use_gso && (size_t)batch_size * message_bytes > UDP_MAX_PAYLOAD) {
+        batch_size = (int)(UDP_MAX_PAYLOAD / message_bytes);
+    }
+    if (zc_depth < 1) zc_depth = 1;
+
+    const char *copy_names[] = { "two-copy (staging memcpy + send)",
+                                 "one-copy (iovec gather)",
+                                 "zero-copy (MSG_ZEROCOPY)" };
+    printf("=== PA02 Part A7: UDP Datagram Server ===\n");
+    printf("Roll Number: MT25190\n");
+    printf("Port: %d\n", port);
+    printf("Message size: %d bytes per field (%zu-byte datagrams)\n", message_size, message_bytes);
+    printf("Expected threads: %d\n", num_threads);
+    printf("Copy: %s\n", copy_names[copy_mode]);
+    printf("Batch: %d datagrams per %s\n", batch_size,
+           use_gso ? "UDP_SEGMENT super-packet" : "sendmmsg()");
+    if (hw_counters && hwc_enable() < 0) hw_counters = 0;
+    printf("\n");
+
+    int server_sock = socket(AF_INET, SOCK_DGRAM, 0);
+    if (server_sock < 0) {
+        perror("Socket creation failed");
+        exit(EXIT_FAILURE);
+    }
+
+    struct sockaddr_in server_addr;
+    memset(&server_addr, 0, sizeof(server_addr));
+    server_addr.sin_family = AF_INET;
+    server_addr.sin_addr.s_addr = INADDR_ANY;
+    server_addr.sin_port = htons(port);
+    if (bind(server_sock, (struct sockaddr*)&server_addr, sizeof(server_addr)) < 0) {
+        perror("Bind failed");
+        exit(EXIT_FAILURE);
+    }
+
+    printf("Server listening on UDP port %d...\n", port);
+    printf("Waiting for %d client registrations...\n\n", num_threads);
+
+    // Clients re-send their hello until data arrives, so skip duplicates
+    struct sockaddr_in *clients = calloc(num_threads, sizeof(struct sockaddr_in));
+    int connected_clients = 0;
+    while (connected_clients < num_threads && running) {
+        FrameHeader hello;
+        struct sockaddr_in client_addr;
+        socklen_t client_len = sizeof(client_addr);
+        ssize_t n = recvfrom(server_sock, &hello, sizeof(hello), 0,
+                             (struct sockaddr*)&client_addr, &client_len);
+        if (n < 0) {
+            if (errno != EINTR) perror("recvfrom failed");
+            continue;
+        }
+        if (n != sizeof(hello) || hello.magic != FRAME_MAGIC) continue;
+        if (hello.length != message_bytes) {
+            fprintf(stderr, "Client %s:%d expects %u-byte messages, serving %zu "
+                            "(message_size mismatch)\n", inet_ntoa(client_addr.sin_addr),
+                    ntohs(client_addr.sin_port), hello.length, message_bytes);
+            continue;
+        }
+
+        int known = 0;
+        for (int i = 0; i < connected_clients && !known; i++) {
+            known = clients[i].sin_addr.s_addr == client_addr.sin_addr.s_addr &&
+                    clients[i].sin_port == client_addr.sin_port;
+        }
+        if (known) continue;
+
+        struct sockaddr_in *peer = malloc(sizeof(*peer));
+        if (!peer) {
+            perror("Failed to allocate peer address");
+            continue;
+        }
+        *peer = client_addr;
+
+        printf("Registered client %d from %s:%d\n",
+               connected_clients + 1,
+               inet_ntoa(client_addr.sin_addr),
+               ntohs(client_addr.sin_port));
+
+        if (pthread_create(&thread_id, NULL, client_handler, peer) != 0) {
+            perror("Thread creation failed");
+            free(peer);
+            continue;
+        }
+        pthread_detach(thread_id);
+        clients[connected_clients++] = client_addr;
+    }
+
+    printf("\nAll %d clients registered. Press Ctrl+C to stop.\n", num_threads);
+
+    while (running) {
+        sleep(1);
+    }
+
+    free(clients);
+    close(server_sock);
+    if (hw_counters) report_hw_counters();
+    return 0;
+}
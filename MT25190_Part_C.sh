@@ -16,15 +16,159 @@ if [ "$QUICK_TEST" = "1" ]; then
     MESSAGE_SIZES=(512 1024)
     THREAD_COUNTS=(1 2)
     DURATION=3
+    DEFAULT_REPS=3
 else
     MESSAGE_SIZES=(512 1024 2048 4096)  # All message sizes for full coverage
     THREAD_COUNTS=(1 2 4 8)             # All thread counts for full coverage
-    DURATION=30                         # 30 seconds per experiment
+    DURATION=30                         # 30 seconds per trial (repeated, see REPS)
+    DEFAULT_REPS=8
 fi
 
+# Sweep: "grid" measures every MESSAGE_SIZES x THREAD_COUNTS cell; "crossover"
+# starts from CROSSOVER_SIZES (64 B .. 1 MB per field) and keeps adding sizes
+# between neighbours whose throughput ranking of IMPLS differs, per thread
+# count, for up to CROSSOVER_STEPS passes or until neighbours are at most a
+# factor CROSSOVER_RESOLUTION apart. It writes the crossover table and the
+# best implementation per size band (the production size thresholds)
+SEARCH=${SEARCH:-grid}
+CROSSOVER_SIZES=(${CROSSOVER_SIZES:-64 256 1024 4096 16384 65536 262144 1048576})
+CROSSOVER_STEPS=${CROSSOVER_STEPS:-3}
+CROSSOVER_RESOLUTION=${CROSSOVER_RESOLUTION:-1.25}
+if [ "$SEARCH" = "crossover" ]; then
+    MESSAGE_SIZES=("${CROSSOVER_SIZES[@]}")
+    DEFAULT_IMPLS="A1 A2 A3"            # The copy strategies
+else
+    DEFAULT_IMPLS="A1 A2 A3 A4 A5 A6 A7 A8"
+fi
+
+# Implementations to sweep, e.g. IMPLS="A1 A2 A3" to compare the copy models only
+IMPLS=(${IMPLS:-$DEFAULT_IMPLS})
+
+# Repeated trials: every (implementation, size, threads) cell runs up to REPS
+# trials, one per round, and each round visits the cells in a fresh random
+# order so slow drift (thermals, background load) spreads over all of them.
+# From MIN_REPS trials on, a cell stops early once the 95% confidence interval
+# of its steady-state throughput is within +-CI_TARGET_PCT percent of the mean.
+# WARMUP_TRIALS trials before the first round warm the machine and are
+# discarded (Trial 0 in the CSV). SEED makes the order reproducible
+REPS=${REPS:-$DEFAULT_REPS}
+MIN_REPS=${MIN_REPS:-3}
+CI_TARGET_PCT=${CI_TARGET_PCT:-2}
+WARMUP_TRIALS=${WARMUP_TRIALS:-1}
+SEED=${SEED:-}
+# Seconds to wait for a server to start listening before the trial is skipped
+READY_TIMEOUT=${READY_TIMEOUT:-10}
+
+# Server engine: "thread" (one pthread per connection) or "epoll" (N workers)
+# Override from the environment, e.g. SERVER_ENGINE=epoll ./MT25190_Part_C.sh
+SERVER_ENGINE=${SERVER_ENGINE:-thread}
+
+# In-flight zero-copy buffers per connection (A3/A4/A8 --depth)
+# Sweep by re-running with e.g. ZC_DEPTH=4, 16, 64
+ZC_DEPTH=${ZC_DEPTH:-16}
+
+# Traffic pattern: "stream" (server pushes continuously) or "pingpong"
+# (client stamps a request, server reflects it; latency = true per-message RTT)
+RUN_MODE=${RUN_MODE:-stream}
+
+# Receive-side zero copy for the A3 client: ZC_RECV=1 maps the TCP receive
+# queue with TCP_ZEROCOPY_RECEIVE (--zc-recv) instead of copying with recv()
+ZC_RECV=${ZC_RECV:-0}
+
+# A5 in-kernel page-cache transfer: "sendfile" or "splice" (through a pipe)
+# CSV rows are labelled A5-sendfile / A5-splice
+A5_XFER=${A5_XFER:-sendfile}
+
+# A6 shared-memory ring: empty/full ring waiting, "futex" or "spin"
+# (spin needs a spare core per side). CSV rows are labelled A6-futex / A6-spin
+SHM_WAIT=${SHM_WAIT:-futex}
+
+# A7 UDP datagrams: copy strategy "two", "one" or "zero" (MSG_ZEROCOPY),
+# datagrams per sendmmsg()/recvmmsg() call, and UDP_GSO=1 for UDP_SEGMENT
+# super-packets on the server plus UDP_GRO on the client.
+# CSV rows are labelled e.g. A7-one / A7-zero-gso
+UDP_COPY=${UDP_COPY:-one}
+UDP_BATCH=${UDP_BATCH:-8}
+UDP_GSO=${UDP_GSO:-0}
+
+# A8 hybrid send policy: "static" (size thresholds HYBRID_THRESHOLDS, as
+# COPY_MAX:IOVEC_MAX frame bytes; empty = built-in table) or "calibrate"
+# (measured at server startup). HYBRID_MIN_SIZE=BYTES mixes frame sizes
+# between BYTES and the full frame. CSV rows are labelled e.g.
+# A8-static / A8-calibrate-mixed
+HYBRID_POLICY=${HYBRID_POLICY:-static}
+HYBRID_THRESHOLDS=${HYBRID_THRESHOLDS:-}
+HYBRID_MIN_SIZE=${HYBRID_MIN_SIZE:-}
+
+# Accept sharding (SERVER_ENGINE=reuseport): REUSEPORT_BPF=1 attaches the
+# CPU-steering program (--reuseport-bpf); the Engine column reads reuseport-bpf
+REUSEPORT_BPF=${REUSEPORT_BPF:-0}
+
+# Busy-poll receive for A1/A2/A3/A5/A8: BUSY_POLL=USEC spins in non-blocking
+# receives with SO_BUSY_POLL=USEC on the client (and on the server's request
+# reads with the thread engine). Needs a spare core per spinning thread
+BUSY_POLL=${BUSY_POLL:-off}
+
+# Hugepage-backed payload buffers for the A2/A3 servers (--hugepages): "off",
+# "huge" (MAP_HUGETLB, THP fallback; reserve with sysctl vm.nr_hugepages=N)
+# or "thp" (madvise). Compare DTLBMisses/ServerDTLBMisses across runs
+HUGEPAGES=${HUGEPAGES:-off}
+
+# A1 Message allocator (--alloc): "malloc" (nine mallocs) or "arena" (one
+# cache-line-aligned block); ALLOC_PER_SEND=1 builds a new Message for every
+# send. Recorded in the Alloc column (e.g. arena-per-send); compare
+# ServerL1Misses and throughput across runs
+ALLOC=${ALLOC:-malloc}
+ALLOC_PER_SEND=${ALLOC_PER_SEND:-0}
+
+# Thread placement for both server and client (--affinity): "none" (scheduler),
+# "compact", "scatter", "same-core-pairs", "cross-numa" or a CPU list such
+# as "0,2,4,6". The CSV records the policy and every server:client CPU pair
+AFFINITY=${AFFINITY:-none}
+
+# Payload integrity for A1/A2/A3/A5/A8: VERIFY=auto (or avx512|avx2|sse4.2|scalar)
+# seals every frame with a CRC32C on the server (--checksum) and recomputes it
+# on the client (--verify=KERNEL). Verify/VerifyCpb/TransportCpb/CrcErrors
+# record the kernel and its cost next to the transport's cycles per byte
+VERIFY=${VERIFY:-off}
+
+# Receiver workload for A1/A2/A3/A5/A8 clients (--consume): "none", "sum"
+# (vectorised streaming read), "random" (every cache line in random order)
+# or "copy" (copy-out into an application buffer). Run once per profile and
+# compare cache misses per copy model; Consume/ConsumeCpb record it
+CONSUME=${CONSUME:-none}
+
+# Live server counters for A1/A2/A3/A5/A8 (--stats): MT25190_StatsReader samples
+# the server every SERVER_STATS ms into results/*_server_stats.csv while the
+# client runs ("off" to disable). ServerGbps/ServerEagain/ServerPartial
+# summarise it, since the server's own totals are lost when it is killed
+SERVER_STATS=${SERVER_STATS:-500}
+
+# Client throughput time series (--timeseries, all parts): bytes and messages
+# per thread every TS_INTERVAL ms into results/*_timeseries.csv. The warm-up
+# is detected and dropped; WarmupS/SteadyGbps/SteadyMsgRate/SteadyCv record
+# the steady state next to the whole-run ThroughputGbps
+TS_INTERVAL=${TS_INTERVAL:-100}
+
+# In-process hardware counters on both sides (--hw-counters): every server and
+# client thread counts its own cycles, instructions, cache/LLC/dTLB misses and
+# context switches, split into user and kernel mode (0 disables). Per-thread
+# lines stay in the *_metrics.txt / *_server.txt logs; the CSV gets the sums
+HW_COUNTERS=${HW_COUNTERS:-1}
+
 RESULTS_DIR="results"
 SERVER_IP="127.0.0.1"  # PA02: Localhost for single-machine testing
-PERF_EVENTS="cpu-cycles,cache-misses,L1-dcache-load-misses,LLC-load-misses,context-switches"
+PERF_EVENTS="cpu-cycles,cache-misses,L1-dcache-load-misses,LLC-load-misses,dTLB-load-misses,context-switches"
+# The payload buffers live in the server: its dTLB and L1 misses are counted separately
+SERVER_PERF_EVENTS="dTLB-load-misses,L1-dcache-load-misses"
+
+# Compile all implementations
+echo "Compiling implementations..."
+make clean  # Also removes results/, so compile before creating it
+make all
+
+echo "Compilation complete."
+echo ""
 
 # Clean previous results and recreate directory
 # NOTE: results/ must exist before perf stat writes output files
@@ -34,8 +178,43 @@ mkdir -p ${RESULTS_DIR}
 
 # Create single consolidated CSV file with header
 # Added ThroughputGbps, LatencyUs, TotalBytes from client METRICS output for Part D plots
+# P50Us..MaxUs are tail latencies from the clients' per-message histograms
+# LostMsgs counts gaps in the frame sequence numbers (should stay 0 over TCP)
+# RxMappedBytes/RxCopiedBytes split A3 client receives into mmap()ed vs recv()-copied
+# ReorderedMsgs counts late datagrams (A7 UDP; always 0 over TCP)
+# BusyPollUs: SO_BUSY_POLL budget (off = blocking receives); CpuUsPerMsg: client CPU time per message
+# AcceptMs: time the epoll/reuseport engines took to accept all connections (0 otherwise)
+# DTLBMisses: client dTLB load misses; ServerDTLBMisses: the same for the server process
+# ServerL1Misses: L1-dcache-load-misses of the server process
+# Alloc: A1 Message allocator (malloc|arena, -per-send suffix; "-" for other parts)
+# Hugepages: HUGEPAGES mode of the A2/A3 server buffer pool (off for other parts)
+# Placement/CpuPairs: AFFINITY policy and server:client CPUs per pair (e.g. 0:1+2:3)
+# Verify: CRC32C kernel (off without VERIFY); VerifyCpb/TransportCpb: client cycles per
+# byte spent verifying vs receiving; CrcErrors: frames whose payload did not match
+# Consume: CONSUME profile of the client; ConsumeCpb: its cycles per payload byte
+# ServerGbps: server send rate while bytes moved; ServerEagain/ServerPartial: its
+# EAGAIN and short sends (from MT25190_StatsReader; 0 without SERVER_STATS)
+# WarmupS: seconds dropped as warm-up; SteadyGbps/SteadyMsgRate: client rates after it;
+# SteadyCv: coefficient of variation of the steady per-interval throughput
+# Client/Server Cycles/Instr User/Kernel: per-thread perf_event_open counts summed over
+# each side's threads; ServerCtxSwitches: the server threads' context switches
+# Trial: repetition of the cell (0 = discarded warm-up trial); one row per trial
+# ZcSends/ZcCopied: MSG_ZEROCOPY sends completed on the server and those the kernel
+# copied after all (SO_EE_CODE_ZEROCOPY_COPIED; A4: IORING_NOTIF_USAGE_ZC_COPIED);
+# ZcEffectivePct: share of their bytes really sent zero-copy; ZcCompletionUs/
+# ZcCompletionMaxUs: send -> completion time (A3/A8). "-" where nothing was sent zero-copy
 CONSOLIDATED_CSV="${RESULTS_DIR}/MT25190_Part_C_results.csv"
-echo "Implementation,MessageSize,Threads,CPUCycles,CacheMisses,L1Misses,LLCMisses,ContextSwitches,TimeElapsed,ThroughputGbps,LatencyUs,TotalBytes" > "${CONSOLIDATED_CSV}"
+# One row per cell: trials, mean/median/stddev and 95% CI of the steady-state
+# throughput, P99 latency and CPU per message (written after the last round)
+SUMMARY_CSV="${RESULTS_DIR}/MT25190_Part_C_summary.csv"
+# SEARCH=crossover only: one row per pair of implementations whose order flips
+# between two neighbouring sizes, with the log-interpolated crossover size
+# (Significant = the CI95s do not overlap on either side), and one row per
+# size band with the fastest implementation in it (BestGbps: its mean at the
+# band's largest measured size)
+CROSSOVER_CSV="${RESULTS_DIR}/MT25190_Part_C_crossover.csv"
+THRESHOLDS_CSV="${RESULTS_DIR}/MT25190_Part_C_thresholds.csv"
+echo "Implementation,MessageSize,Threads,CPUCycles,CacheMisses,L1Misses,LLCMisses,ContextSwitches,TimeElapsed,ThroughputGbps,LatencyUs,TotalBytes,Engine,ZcDepth,Mode,P50Us,P90Us,P99Us,P999Us,MaxUs,LostMsgs,RxMappedBytes,RxCopiedBytes,ReorderedMsgs,Placement,CpuPairs,AcceptMs,BusyPollUs,CpuUsPerMsg,DTLBMisses,ServerDTLBMisses,Hugepages,ServerL1Misses,Alloc,Verify,VerifyCpb,TransportCpb,CrcErrors,Consume,ConsumeCpb,ServerGbps,ServerEagain,ServerPartial,WarmupS,SteadyGbps,SteadyMsgRate,SteadyCv,ClientCyclesUser,ClientCyclesKernel,ClientInstrUser,ClientInstrKernel,ServerCyclesUser,ServerCyclesKernel,ServerInstrUser,ServerInstrKernel,ServerCtxSwitches,Trial,ZcSends,ZcCopied,ZcEffectivePct,ZcCompletionUs,ZcCompletionMaxUs" > "${CONSOLIDATED_CSV}"
 
 # FIX: Check perf permissions before running experiments
 PERF_PARANOID=$(cat /proc/sys/kernel/perf_event_paranoid 2>/dev/null || echo "unknown")
@@ -45,48 +224,296 @@ if [ "$PERF_PARANOID" != "-1" ] && [ "$PERF_PARANOID" != "unknown" ]; then
     echo ""
 fi
 
-# Compile all implementations
-echo "Compiling implementations..."
-make clean
-make all
+# port_listening: <impl> <port> - the server's endpoint is up (read from
+# /proc, so probing never takes one of the connections the server counts)
+port_listening() {
+    local hex
+    hex=$(printf ':%04X' "$2")
+    case "$1" in
+        A6) grep -q "@MT25190_shm_$2\$" /proc/net/unix ;;  # Abstract Unix socket
+        A7) awk -v p="$hex" 'FNR > 1 && substr($2, length($2) - 4) == p { f = 1 }
+                END { exit !f }' /proc/net/udp /proc/net/udp6 2>/dev/null ;;
+        *)  awk -v p="$hex" 'FNR > 1 && substr($2, length($2) - 4) == p && $4 == "0A" { f = 1 }
+                END { exit !f }' /proc/net/tcp /proc/net/tcp6 2>/dev/null ;;
+    esac
+}
 
-echo "Compilation complete."
-echo ""
+# wait_for_server: <impl> <port> <pid> - polls until the server listens;
+# fails if it exits first or READY_TIMEOUT passes
+wait_for_server() {
+    local polls=$((READY_TIMEOUT * 20))
+    for ((i = 0; i < polls; i++)); do
+        port_listening "$1" "$2" && return 0
+        kill -0 "$3" 2>/dev/null || return 1
+        sleep 0.05
+    done
+    return 1
+}
+
+# wait_for_port_free: <impl> <port> - the previous server's endpoint is gone
+wait_for_port_free() {
+    for ((i = 0; i < 100; i++)); do
+        port_listening "$1" "$2" || return 0
+        sleep 0.05
+    done
+}
+
+# cell_stats: <label> <msg_size> <threads> <column> [<fallback column>]
+# Prints "n mean median stddev ci_low ci_high ci_rel_pct" of one CSV column
+# over the cell's trials (warm-up trials excluded). The fallback column is
+# used for rows where the column is 0 (e.g. SteadyGbps -> ThroughputGbps)
+cell_stats() {
+    awk -F, -v label="$1" -v size="$2" -v threads="$3" -v col="$4" -v alt="${5:-}" '
+        NR == 1 { for (i = 1; i <= NF; i++) idx[$i] = i; next }
+        $1 == label && $2 == size && $3 == threads && $idx["Trial"] > 0 {
+            v = $idx[col] + 0
+            if (v == 0 && alt != "") v = $idx[alt] + 0
+            x[++n] = v; sum += v
+        }
+        END {
+            if (n == 0) { print "0 0 0 0 0 0 0"; exit }
+            # Two-sided 95% Student t critical values for 1..30 degrees of freedom
+            split("12.706 4.303 3.182 2.776 2.571 2.447 2.365 2.306 2.262 2.228 " \
+                  "2.201 2.179 2.160 2.145 2.131 2.120 2.110 2.101 2.093 2.086 " \
+                  "2.080 2.074 2.069 2.064 2.060 2.056 2.052 2.048 2.045 2.042", t, " ")
+            mean = sum / n
+            for (i = 1; i <= n; i++) ss += (x[i] - mean) ^ 2
+            sd = n > 1 ? sqrt(ss / (n - 1)) : 0
+            # Median: insertion sort, n is small
+            for (i = 2; i <= n; i++) {
+                v = x[i]
+                for (j = i - 1; j >= 1 && x[j] > v; j--) x[j + 1] = x[j]
+                x[j + 1] = v
+            }
+            median = n % 2 ? x[(n + 1) / 2] : (x[n / 2] + x[n / 2 + 1]) / 2
+            half = n > 1 ? (n - 1 <= 30 ? t[n - 1] : 1.96) * sd / sqrt(n) : 0
+            rel = mean != 0 ? 100 * half / mean : 0
+            printf "%d %.6f %.6f %.6f %.6f %.6f %.2f\n", n, mean, median, sd,
+                   mean - half, mean + half, (n > 1 ? rel : 100)
+        }' "${CONSOLIDATED_CSV}"
+}
 
 # Function to run experiment with perf
 run_experiment() {
-    local impl=$1      # A1, A2, A3
+    local impl=$1      # A1 .. A8
     local msg_size=$2
     local threads=$3
     local port=$4
+    local trial=$5     # 1..REPS, 0 = warm-up
     
     local server_bin="MT25190_Part_${impl}_Server"
     local client_bin="MT25190_Part_${impl}_Client"
-    local perf_file="${RESULTS_DIR}/${impl}_msg${msg_size}_t${threads}_perf.txt"
-    local metrics_file="${RESULTS_DIR}/${impl}_msg${msg_size}_t${threads}_metrics.txt"
+    # A1/A2/A3/A5/A8 are copy strategies of the unified server/client (--mode)
+    local transport=""
+    case "$impl" in
+        A1) transport="two-copy" ;;
+        A2) transport="one-copy" ;;
+        A3) transport="zero-copy" ;;
+        A5) transport="sendfile" ;;
+        A8) transport="hybrid" ;;
+    esac
+    if [ -n "$transport" ]; then
+        server_bin="MT25190_Server"
+        client_bin="MT25190_Client"
+    fi
+    local perf_file="${RESULTS_DIR}/${impl}_msg${msg_size}_t${threads}_r${trial}_perf.txt"
+    local metrics_file="${RESULTS_DIR}/${impl}_msg${msg_size}_t${threads}_r${trial}_metrics.txt"
+    local server_file="${RESULTS_DIR}/${impl}_msg${msg_size}_t${threads}_r${trial}_server.txt"
+    local server_perf_file="${RESULTS_DIR}/${impl}_msg${msg_size}_t${threads}_r${trial}_server_perf.txt"
+    local stats_file="${RESULTS_DIR}/${impl}_msg${msg_size}_t${threads}_r${trial}_server_stats.csv"
+    local stats_log="${RESULTS_DIR}/${impl}_msg${msg_size}_t${threads}_r${trial}_server_stats.txt"
+    local timeseries_file="${RESULTS_DIR}/${impl}_msg${msg_size}_t${threads}_r${trial}_timeseries.csv"
     
     # FIX: Ensure results directory exists before perf writes output
     mkdir -p "${RESULTS_DIR}"
     
-    echo "Running: ${impl} | MsgSize=${msg_size} | Threads=${threads} | Port=${port}"
+    # A4 is its own completion-based engine (io_uring), A1-A3 take --engine
+    local engine=${SERVER_ENGINE}
+    local server_flags="--engine=${SERVER_ENGINE}"
+    if [ "$SERVER_ENGINE" = "reuseport" ] && [ "$REUSEPORT_BPF" = "1" ]; then
+        engine="reuseport-bpf"
+        server_flags="${server_flags} --reuseport-bpf"
+    fi
+    if [ "$impl" = "A4" ]; then
+        engine="uring"
+        server_flags=""
+    fi
+    # A6 has no sockets on the data path: one ring per client thread
+    if [ "$impl" = "A6" ]; then
+        engine="shm"
+        server_flags=""
+    fi
+    if [ "$impl" = "A7" ]; then
+        engine="udp"
+        server_flags=""
+    fi
+    
+    # Ping-pong mode: both sides take --pingpong
+    local client_flags=""
+    if [ -n "$transport" ]; then
+        server_flags="${server_flags} --mode=${transport}"
+        client_flags="--mode=${transport}"
+    fi
+    if [ "$RUN_MODE" = "pingpong" ]; then
+        server_flags="${server_flags} --pingpong"
+        client_flags="${client_flags} --pingpong"
+    fi
+    
+    # Zero-copy implementations keep ZC_DEPTH buffers in flight per connection
+    local zc_depth=0
+    if [ "$impl" = "A3" ] || [ "$impl" = "A4" ] || [ "$impl" = "A8" ]; then
+        zc_depth=${ZC_DEPTH}
+        server_flags="${server_flags} --depth=${ZC_DEPTH}"
+    fi
+    if [ "$impl" = "A3" ] && [ "$ZC_RECV" = "1" ]; then
+        client_flags="${client_flags} --zc-recv"
+    fi
+    
+    # A5 sends the payload from a memfd with sendfile() or splice()
+    local label=${impl}
+    if [ "$impl" = "A5" ]; then
+        server_flags="${server_flags} --xfer=${A5_XFER}"
+        label="${impl}-${A5_XFER}"
+    fi
+    if [ "$impl" = "A6" ]; then
+        server_flags="${server_flags} --wait=${SHM_WAIT}"
+        client_flags="${client_flags} --wait=${SHM_WAIT}"
+        label="${impl}-${SHM_WAIT}"
+    fi
+    
+    # A8 picks copy/iovec/MSG_ZEROCOPY per frame from a static or calibrated table
+    if [ "$impl" = "A8" ]; then
+        label="${impl}-${HYBRID_POLICY}"
+        if [ "$HYBRID_POLICY" = "calibrate" ]; then
+            server_flags="${server_flags} --calibrate"
+        elif [ -n "$HYBRID_THRESHOLDS" ]; then
+            server_flags="${server_flags} --thresholds=${HYBRID_THRESHOLDS}"
+        fi
+        if [ -n "$HYBRID_MIN_SIZE" ]; then
+            server_flags="${server_flags} --min-size=${HYBRID_MIN_SIZE}"
+            label="${label}-mixed"
+        fi
+    fi
+    
+    # A7 sends datagrams in batches of UDP_BATCH with the UDP_COPY strategy
+    if [ "$impl" = "A7" ]; then
+        server_flags="${server_flags} --copy=${UDP_COPY} --batch=${UDP_BATCH}"
+        client_flags="${client_flags} --batch=${UDP_BATCH}"
+        label="${impl}-${UDP_COPY}"
+        if [ "$UDP_COPY" = "zero" ]; then
+            zc_depth=${ZC_DEPTH}
+            server_flags="${server_flags} --depth=${ZC_DEPTH}"
+        fi
+        if [ "$UDP_GSO" = "1" ]; then
+            server_flags="${server_flags} --gso"
+            client_flags="${client_flags} --gro"
+            label="${label}-gso"
+        fi
+    fi
+    
+    # Busy polling: TCP socket receive paths only (A4 reaps io_uring CQEs,
+    # A6 has its own --wait=spin, A7 is not covered)
+    local busy_poll=off
+    if [ "$BUSY_POLL" != "off" ] && { [ "$impl" = "A1" ] || [ "$impl" = "A2" ] || [ "$impl" = "A3" ] || [ "$impl" = "A5" ] || [ "$impl" = "A8" ]; }; then
+        busy_poll=${BUSY_POLL}
+        client_flags="${client_flags} --busy-poll=${BUSY_POLL}"
+        if [ "$SERVER_ENGINE" = "thread" ]; then
+            server_flags="${server_flags} --busy-poll=${BUSY_POLL}"
+        fi
+    fi
+    
+    # Hugepage buffer pool: only A2/A3 keep long-lived payload buffers
+    local hugepages=off
+    if [ "$HUGEPAGES" != "off" ] && { [ "$impl" = "A2" ] || [ "$impl" = "A3" ]; }; then
+        hugepages=${HUGEPAGES}
+        server_flags="${server_flags} --hugepages=${HUGEPAGES}"
+    fi
+    
+    # Message allocator: A1 builds its messages from the heap
+    local alloc=-
+    if [ "$impl" = "A1" ]; then
+        alloc=${ALLOC}
+        server_flags="${server_flags} --alloc=${ALLOC}"
+        if [ "$ALLOC_PER_SEND" = "1" ]; then
+            alloc="${alloc}-per-send"
+            server_flags="${server_flags} --alloc-per-send"
+        fi
+    fi
+    
+    # Integrity mode: the server seals frames, the client verifies them
+    if [ "$VERIFY" != "off" ] && [ -n "$transport" ]; then
+        server_flags="${server_flags} --checksum"
+        client_flags="${client_flags} --verify=${VERIFY}"
+    fi
+    local consume=none
+    if [ -n "$transport" ]; then
+        consume=${CONSUME}
+        client_flags="${client_flags} --consume=${CONSUME}"
+    fi
+    local live_stats=0
+    if [ "$SERVER_STATS" != "off" ] && [ -n "$transport" ]; then
+        live_stats=1
+        server_flags="${server_flags} --stats"
+    fi
+    
+    # Every client samples its own throughput over time
+    client_flags="${client_flags} --timeseries=${timeseries_file} --ts-interval=${TS_INTERVAL}"
+    if [ "$HW_COUNTERS" = "1" ]; then
+        server_flags="${server_flags} --hw-counters"
+        client_flags="${client_flags} --hw-counters"
+    fi
     
-    # Start server in background with: <port> <message_size> <num_threads>
+    # Both sides derive the same CPU pairs from the policy
+    if [ "$AFFINITY" != "none" ]; then
+        server_flags="${server_flags} --affinity=${AFFINITY}"
+        client_flags="${client_flags} --affinity=${AFFINITY}"
+    fi
+    
+    LAST_LABEL=${label}
+    echo "Running: ${impl} | MsgSize=${msg_size} | Threads=${threads} | Port=${port} | Engine=${engine} | Trial=${trial}"
+    
+    # Start server in background with: <port> <message_size> <num_threads> [flags]
     # PA02 requirement: Port must be passed explicitly
-    ./${server_bin} ${port} ${msg_size} ${threads} > /dev/null 2>&1 &
+    ./${server_bin} ${port} ${msg_size} ${threads} ${server_flags} > "${server_file}" 2>&1 &
     SERVER_PID=$!
-    sleep 1  # Let server initialize (quick test)
+    # Ready once it listens (A6: its Unix socket; A7: its UDP port is bound)
+    if ! wait_for_server ${impl} ${port} ${SERVER_PID}; then
+        echo "WARNING: ${impl} server not listening on ${port} within ${READY_TIMEOUT}s, trial skipped"
+        kill ${SERVER_PID} 2>/dev/null || true
+        wait ${SERVER_PID} 2>/dev/null || true
+        return 1
+    fi
+    
+    # Count the server's dTLB misses for the client's run (stops on SIGINT)
+    perf stat -e ${SERVER_PERF_EVENTS} -p ${SERVER_PID} -o "${server_perf_file}" > /dev/null 2>&1 &
+    local server_perf_pid=$!
+    
+    # Sample the server's shared-memory counters; exits once the server is gone
+    local stats_pid=""
+    if [ "$live_stats" = "1" ]; then
+        ./MT25190_StatsReader ${port} --interval=${SERVER_STATS} --csv="${stats_file}" \
+            > "${stats_log}" 2>&1 &
+        stats_pid=$!
+    fi
     
     # Run client with perf profiling: <server_ip> <port> <message_size> <num_threads> <duration>
     # PA02 requirement: All parameters passed explicitly for automation
     # NOTE: perf stat writes to stderr, client METRICS writes to stdout
     # FIX: Capture stdout to metrics file for application-level data
     perf stat -e ${PERF_EVENTS} \
-        ./${client_bin} ${SERVER_IP} ${port} ${msg_size} ${threads} ${DURATION} \
+        ./${client_bin} ${SERVER_IP} ${port} ${msg_size} ${threads} ${DURATION} ${client_flags} \
         > "${metrics_file}" 2> "${perf_file}"
     
+    # Stop the server-side counters before the server exits
+    kill -INT ${server_perf_pid} 2>/dev/null || true
+    wait ${server_perf_pid} 2>/dev/null || true
+    
     # Kill server
     kill ${SERVER_PID} 2>/dev/null || true
     wait ${SERVER_PID} 2>/dev/null || true
+    if [ -n "$stats_pid" ]; then
+        wait ${stats_pid} 2>/dev/null || true
+    fi
     
     # Parse perf output to CSV
     # NOTE: Only parse if perf output file was successfully created
@@ -94,12 +521,13 @@ run_experiment() {
     if [ -f "${perf_file}" ] && [ -s "${perf_file}" ]; then
         # FIX: Write directly to consolidated CSV (single file for all results)
         # Pass metrics file for application-level data extraction
-        parse_perf_to_csv ${perf_file} ${metrics_file} ${CONSOLIDATED_CSV} ${impl} ${msg_size} ${threads}
+        parse_perf_to_csv ${perf_file} ${metrics_file} ${CONSOLIDATED_CSV} ${label} ${msg_size} ${threads} ${engine} ${zc_depth} ${server_file} ${busy_poll} ${server_perf_file} ${hugepages} ${alloc} ${stats_log} ${trial}
     else
         echo "WARNING: Perf output file not created or empty: ${perf_file}"
     fi
     
-    sleep 1  # Cooldown between experiments (quick test)
+    # The next trial may reuse the port: wait until this server's endpoint is gone
+    wait_for_port_free ${impl} ${port}
 }
 
 # Parse perf output to CSV format
@@ -110,6 +538,15 @@ parse_perf_to_csv() {
     local impl=$4
     local msg_size=$5
     local threads=$6
+    local engine=$7
+    local zc_depth=$8
+    local server_file=$9
+    local busy_poll=${10}
+    local server_perf_file=${11}
+    local hugepages=${12}
+    local alloc=${13}
+    local stats_log=${14}
+    local trial=${15}
     
     # Extract metrics from perf output (handle hybrid CPU architectures)
     # Sum values from all CPU types (atom/core) and remove commas/angle brackets
@@ -117,6 +554,9 @@ parse_perf_to_csv() {
     cache_misses=$(grep -E "(cache-misses|cpu_atom/cache-misses|cpu_core/cache-misses)" ${perf_file} | awk '{print $1}' | grep -v '<' | tr -d ',' | awk '{sum+=$1} END {print sum}')
     llc_misses=$(grep -E "(LLC-load-misses|cpu_atom/LLC-load-misses|cpu_core/LLC-load-misses)" ${perf_file} | awk '{print $1}' | grep -v '<' | tr -d ',' | awk '{sum+=$1} END {print sum}')
     l1_misses=$(grep -E "(L1-dcache-load-misses|cpu_atom/L1-dcache-load-misses|cpu_core/L1-dcache-load-misses)" ${perf_file} | awk '{print $1}' | grep -v '<' | tr -d ',' | awk '{sum+=$1} END {print sum}')
+    dtlb_misses=$(grep -E "(dTLB-load-misses|cpu_atom/dTLB-load-misses|cpu_core/dTLB-load-misses)" ${perf_file} | awk '{print $1}' | grep -v '<' | tr -d ',' | awk '{sum+=$1} END {print sum}')
+    server_dtlb_misses=$(grep -E "dTLB-load-misses" ${server_perf_file} 2>/dev/null | awk '{print $1}' | grep -v '<' | tr -d ',' | awk '{sum+=$1} END {print sum}')
+    server_l1_misses=$(grep -E "L1-dcache-load-misses" ${server_perf_file} 2>/dev/null | awk '{print $1}' | grep -v '<' | tr -d ',' | awk '{sum+=$1} END {print sum}')
     ctx_switches=$(grep "context-switches" ${perf_file} | awk '{print $1}' | grep -v '<' | tr -d ',' | head -1)
     time_elapsed=$(grep "seconds time elapsed" ${perf_file} | awk '{print $1}' | head -1)
     
@@ -125,55 +565,391 @@ parse_perf_to_csv() {
     throughput_gbps=$(grep "METRICS" ${metrics_file} 2>/dev/null | sed -n 's/.*throughput_gbps=\([^ ]*\).*/\1/p' | head -1)
     latency_us=$(grep "METRICS" ${metrics_file} 2>/dev/null | sed -n 's/.*latency_us=\([^ ]*\).*/\1/p' | head -1)
     total_bytes=$(grep "METRICS" ${metrics_file} 2>/dev/null | sed -n 's/.*bytes=\([^ ]*\).*/\1/p' | head -1)
+    # Latency percentiles: METRICS ... p50_us=A p90_us=B p99_us=C p999_us=D max_us=E
+    p50_us=$(grep "METRICS" ${metrics_file} 2>/dev/null | sed -n 's/.*p50_us=\([^ ]*\).*/\1/p' | head -1)
+    p90_us=$(grep "METRICS" ${metrics_file} 2>/dev/null | sed -n 's/.*p90_us=\([^ ]*\).*/\1/p' | head -1)
+    p99_us=$(grep "METRICS" ${metrics_file} 2>/dev/null | sed -n 's/.*p99_us=\([^ ]*\).*/\1/p' | head -1)
+    p999_us=$(grep "METRICS" ${metrics_file} 2>/dev/null | sed -n 's/.*p999_us=\([^ ]*\).*/\1/p' | head -1)
+    max_us=$(grep "METRICS" ${metrics_file} 2>/dev/null | sed -n 's/.*max_us=\([^ ]*\).*/\1/p' | head -1)
+    lost_msgs=$(grep "METRICS" ${metrics_file} 2>/dev/null | sed -n 's/.*lost=\([^ ]*\).*/\1/p' | head -1)
+    rx_mapped=$(grep "METRICS" ${metrics_file} 2>/dev/null | sed -n 's/.*rx_mapped=\([^ ]*\).*/\1/p' | head -1)
+    rx_copied=$(grep "METRICS" ${metrics_file} 2>/dev/null | sed -n 's/.*rx_copied=\([^ ]*\).*/\1/p' | head -1)
+    reordered=$(grep "METRICS" ${metrics_file} 2>/dev/null | sed -n 's/.*reordered=\([^ ]*\).*/\1/p' | head -1)
+    placement=$(grep "METRICS" ${metrics_file} 2>/dev/null | sed -n 's/.*placement=\([^ ]*\).*/\1/p' | head -1)
+    cpu_pairs=$(grep "METRICS" ${metrics_file} 2>/dev/null | sed -n 's/.*cpus=\([^ ]*\).*/\1/p' | head -1)
+    cpu_us_per_msg=$(grep "METRICS" ${metrics_file} 2>/dev/null | sed -n 's/.*cpu_us_per_msg=\([^ ]*\).*/\1/p' | head -1)
+    # Payload verification: METRICS ... verify=K verify_cpb=V transport_cpb=T crc_errors=E
+    verify=$(grep "METRICS" ${metrics_file} 2>/dev/null | sed -n 's/.* verify=\([^ ]*\).*/\1/p' | head -1)
+    verify_cpb=$(grep "METRICS" ${metrics_file} 2>/dev/null | sed -n 's/.*verify_cpb=\([^ ]*\).*/\1/p' | head -1)
+    transport_cpb=$(grep "METRICS" ${metrics_file} 2>/dev/null | sed -n 's/.*transport_cpb=\([^ ]*\).*/\1/p' | head -1)
+    crc_errors=$(grep "METRICS" ${metrics_file} 2>/dev/null | sed -n 's/.*crc_errors=\([^ ]*\).*/\1/p' | head -1)
+    consume=$(grep "METRICS" ${metrics_file} 2>/dev/null | sed -n 's/.* consume=\([^ ]*\).*/\1/p' | head -1)
+    consume_cpb=$(grep "METRICS" ${metrics_file} 2>/dev/null | sed -n 's/.*consume_cpb=\([^ ]*\).*/\1/p' | head -1)
+    # Steady state: METRICS ... warmup_s=W steady_gbps=G steady_msg_rate=R steady_cv=C
+    warmup_s=$(grep "METRICS" ${metrics_file} 2>/dev/null | sed -n 's/.*warmup_s=\([^ ]*\).*/\1/p' | head -1)
+    steady_gbps=$(grep "METRICS" ${metrics_file} 2>/dev/null | sed -n 's/.*steady_gbps=\([^ ]*\).*/\1/p' | head -1)
+    steady_msg_rate=$(grep "METRICS" ${metrics_file} 2>/dev/null | sed -n 's/.*steady_msg_rate=\([^ ]*\).*/\1/p' | head -1)
+    steady_cv=$(grep "METRICS" ${metrics_file} 2>/dev/null | sed -n 's/.*steady_cv=\([^ ]*\).*/\1/p' | head -1)
+    # Hardware counters: METRICS / SERVER_METRICS ... hw_cycles_u=U hw_cycles_k=K ...
+    client_cycles_u=$(grep "^METRICS" ${metrics_file} 2>/dev/null | sed -n 's/.*hw_cycles_u=\([^ ]*\).*/\1/p' | head -1)
+    client_cycles_k=$(grep "^METRICS" ${metrics_file} 2>/dev/null | sed -n 's/.*hw_cycles_k=\([^ ]*\).*/\1/p' | head -1)
+    client_instr_u=$(grep "^METRICS" ${metrics_file} 2>/dev/null | sed -n 's/.*hw_instructions_u=\([^ ]*\).*/\1/p' | head -1)
+    client_instr_k=$(grep "^METRICS" ${metrics_file} 2>/dev/null | sed -n 's/.*hw_instructions_k=\([^ ]*\).*/\1/p' | head -1)
+    server_cycles_u=$(grep "SERVER_METRICS" ${server_file} 2>/dev/null | sed -n 's/.*hw_cycles_u=\([^ ]*\).*/\1/p' | head -1)
+    server_cycles_k=$(grep "SERVER_METRICS" ${server_file} 2>/dev/null | sed -n 's/.*hw_cycles_k=\([^ ]*\).*/\1/p' | head -1)
+    server_instr_u=$(grep "SERVER_METRICS" ${server_file} 2>/dev/null | sed -n 's/.*hw_instructions_u=\([^ ]*\).*/\1/p' | head -1)
+    server_instr_k=$(grep "SERVER_METRICS" ${server_file} 2>/dev/null | sed -n 's/.*hw_instructions_k=\([^ ]*\).*/\1/p' | head -1)
+    server_ctx=$(grep "SERVER_METRICS" ${server_file} 2>/dev/null | sed -n 's/.*hw_ctx_switches=\([^ ]*\).*/\1/p' | head -1)
+    # Zero-copy completions: SERVER_METRICS ... zc_sends=N zc_copied=C zc_effective_pct=P ...
+    # (A3/A8); A4 reports "(notifications: N, copied fallbacks: C)" per thread
+    zc_sends=$(grep "SERVER_METRICS" ${server_file} 2>/dev/null | sed -n 's/.*zc_sends=\([^ ]*\).*/\1/p' | head -1)
+    zc_copied=$(grep "SERVER_METRICS" ${server_file} 2>/dev/null | sed -n 's/.*zc_copied=\([^ ]*\).*/\1/p' | head -1)
+    zc_effective_pct=$(grep "SERVER_METRICS" ${server_file} 2>/dev/null | sed -n 's/.*zc_effective_pct=\([^ ]*\).*/\1/p' | head -1)
+    zc_completion_us=$(grep "SERVER_METRICS" ${server_file} 2>/dev/null | sed -n 's/.*zc_completion_us=\([^ ]*\).*/\1/p' | head -1)
+    zc_completion_max_us=$(grep "SERVER_METRICS" ${server_file} 2>/dev/null | sed -n 's/.*zc_completion_max_us=\([^ ]*\).*/\1/p' | head -1)
+    if [ -z "$zc_sends" ] && grep -q "copied fallbacks:" ${server_file} 2>/dev/null; then
+        zc_sends=$(sed -n 's/.*notifications: \([0-9]*\), copied fallbacks: .*/\1/p' ${server_file} | awk '{s += $1} END {print s + 0}')
+        zc_copied=$(sed -n 's/.*copied fallbacks: \([0-9]*\)).*/\1/p' ${server_file} | awk '{s += $1} END {print s + 0}')
+        zc_effective_pct=$(awk -v n="$zc_sends" -v c="$zc_copied" 'BEGIN { printf "%.1f", (n > 0 ? 100 * (n - c) / n : 0) }')
+    fi
+    # Stats reader: SERVER_STATS ... server_gbps=G ... eagain=E partial=P ...
+    server_gbps=$(grep "SERVER_STATS" ${stats_log} 2>/dev/null | sed -n 's/.*server_gbps=\([^ ]*\).*/\1/p' | head -1)
+    server_eagain=$(grep "SERVER_STATS" ${stats_log} 2>/dev/null | sed -n 's/.* eagain=\([^ ]*\).*/\1/p' | head -1)
+    server_partial=$(grep "SERVER_STATS" ${stats_log} 2>/dev/null | sed -n 's/.* partial=\([^ ]*\).*/\1/p' | head -1)
+    # Server log: "All N clients connected in X ms" (epoll and reuseport engines)
+    accept_ms=$(grep "clients connected in" ${server_file} 2>/dev/null | sed -n 's/.* in \([0-9.]*\) ms.*/\1/p' | head -1)
     
     # Handle missing or empty values
     cpu_cycles=${cpu_cycles:-0}
     cache_misses=${cache_misses:-0}
     l1_misses=${l1_misses:-0}
     llc_misses=${llc_misses:-0}
+    dtlb_misses=${dtlb_misses:-0}
+    server_dtlb_misses=${server_dtlb_misses:-0}
+    server_l1_misses=${server_l1_misses:-0}
     ctx_switches=${ctx_switches:-0}
     time_elapsed=${time_elapsed:-0}
     throughput_gbps=${throughput_gbps:-0}
     latency_us=${latency_us:-0}
     total_bytes=${total_bytes:-0}
+    p50_us=${p50_us:-0}
+    p90_us=${p90_us:-0}
+    p99_us=${p99_us:-0}
+    p999_us=${p999_us:-0}
+    max_us=${max_us:-0}
+    lost_msgs=${lost_msgs:-0}
+    rx_mapped=${rx_mapped:-0}
+    rx_copied=${rx_copied:-0}
+    reordered=${reordered:-0}
+    placement=${placement:-none}
+    cpu_pairs=${cpu_pairs:--}
+    accept_ms=${accept_ms:-0}
+    cpu_us_per_msg=${cpu_us_per_msg:-0}
+    verify=${verify:-off}
+    verify_cpb=${verify_cpb:-0}
+    transport_cpb=${transport_cpb:-0}
+    crc_errors=${crc_errors:-0}
+    consume=${consume:-none}
+    consume_cpb=${consume_cpb:-0}
+    server_gbps=${server_gbps:-0}
+    server_eagain=${server_eagain:-0}
+    server_partial=${server_partial:-0}
+    warmup_s=${warmup_s:-0}
+    steady_gbps=${steady_gbps:-0}
+    steady_msg_rate=${steady_msg_rate:-0}
+    steady_cv=${steady_cv:-0}
+    client_cycles_u=${client_cycles_u:-0}
+    client_cycles_k=${client_cycles_k:-0}
+    client_instr_u=${client_instr_u:-0}
+    client_instr_k=${client_instr_k:-0}
+    server_cycles_u=${server_cycles_u:-0}
+    server_cycles_k=${server_cycles_k:-0}
+    server_instr_u=${server_instr_u:-0}
+    server_instr_k=${server_instr_k:-0}
+    server_ctx=${server_ctx:-0}
+    zc_sends=${zc_sends:--}
+    zc_copied=${zc_copied:--}
+    zc_effective_pct=${zc_effective_pct:--}
+    zc_completion_us=${zc_completion_us:--}
+    zc_completion_max_us=${zc_completion_max_us:--}
+    if [ "$zc_sends" = "0" ]; then
+        zc_effective_pct=-
+        zc_completion_us=-
+        zc_completion_max_us=-
+    fi
     
     # FIX: Header already exists in consolidated CSV, just append data
     # Append data with application metrics
-    echo "${impl},${msg_size},${threads},${cpu_cycles},${cache_misses},${l1_misses},${llc_misses},${ctx_switches},${time_elapsed},${throughput_gbps},${latency_us},${total_bytes}" >> ${csv_file}
+    echo "${impl},${msg_size},${threads},${cpu_cycles},${cache_misses},${l1_misses},${llc_misses},${ctx_switches},${time_elapsed},${throughput_gbps},${latency_us},${total_bytes},${engine},${zc_depth},${RUN_MODE},${p50_us},${p90_us},${p99_us},${p999_us},${max_us},${lost_msgs},${rx_mapped},${rx_copied},${reordered},${placement},${cpu_pairs},${accept_ms},${busy_poll},${cpu_us_per_msg},${dtlb_misses},${server_dtlb_misses},${hugepages},${server_l1_misses},${alloc},${verify},${verify_cpb},${transport_cpb},${crc_errors},${consume},${consume_cpb},${server_gbps},${server_eagain},${server_partial},${warmup_s},${steady_gbps},${steady_msg_rate},${steady_cv},${client_cycles_u},${client_cycles_k},${client_instr_u},${client_instr_k},${server_cycles_u},${server_cycles_k},${server_instr_u},${server_instr_k},${server_ctx},${trial},${zc_sends},${zc_copied},${zc_effective_pct},${zc_completion_us},${zc_completion_max_us}" >> ${csv_file}
 }
 
-# Run experiments for all combinations
-for impl in A1 A2 A3; do
+# Collect the cells: "impl msg_size threads port"
+CELLS=()
+declare -A IMPL_PORT    # Implementation -> server port
+for impl in "${IMPLS[@]}"; do
+    # A4 (io_uring), A6 (one-way ring) and A7 (UDP) have no request/response path
+    if [ "$RUN_MODE" = "pingpong" ] && { [ "$impl" = "A4" ] || [ "$impl" = "A6" ] || [ "$impl" = "A7" ]; }; then
+        echo "Skipping ${impl} in pingpong mode"
+        continue
+    fi
+    
     # Set port based on implementation
     if [ "$impl" = "A1" ]; then
         port=8080
     elif [ "$impl" = "A2" ]; then
         port=8081
-    else
+    elif [ "$impl" = "A3" ]; then
         port=8082
+    elif [ "$impl" = "A4" ]; then
+        port=8083
+    elif [ "$impl" = "A5" ]; then
+        port=8084
+    elif [ "$impl" = "A6" ]; then
+        port=8085  # A6: names the Unix socket that hands out the rings
+    elif [ "$impl" = "A7" ]; then
+        port=8086  # A7: UDP
+    else
+        port=8087
     fi
-    
-    echo ""
-    echo "=== Testing Implementation ${impl} ==="
+    IMPL_PORT[$impl]=${port}
     
     for msg_size in "${MESSAGE_SIZES[@]}"; do
         for threads in "${THREAD_COUNTS[@]}"; do
-            run_experiment ${impl} ${msg_size} ${threads} ${port}
+            CELLS+=("${impl} ${msg_size} ${threads} ${port}")
         done
     done
 done
 
+# shuffled: the arguments, one per line, in random (or SEED-fixed) order
+shuffled() {
+    if [ -n "$SEED" ]; then
+        printf '%s\n' "$@" | shuf --random-source=<(yes "${SEED}-${round}")
+    else
+        printf '%s\n' "$@" | shuf
+    fi
+}
+
+declare -A CELL_LABEL   # Cell -> CSV Implementation label (e.g. A5-sendfile)
+declare -A CONVERGED    # Cell -> 1 once its confidence interval is narrow enough
+
+# run_cells: <cell>... - runs the cells round by round until each has REPS
+# trials or its CI95 reached CI_TARGET_PCT
+run_cells() {
+    local round pending order cell impl msg_size threads port n mean median sd lo hi rel
+    for ((round = 1; round <= REPS; round++)); do
+        pending=()
+        for cell in "$@"; do
+            [ -z "${CONVERGED[$cell]}" ] && pending+=("$cell")
+        done
+        if [ ${#pending[@]} -eq 0 ]; then
+            echo ""
+            echo "All cells converged after $((round - 1)) rounds"
+            return
+        fi
+    
+        echo ""
+        echo "=== Round ${round}/${REPS}: ${#pending[@]} cells ==="
+        mapfile -t order < <(shuffled "${pending[@]}")
+        for cell in "${order[@]}"; do
+            run_experiment ${cell} ${round} && CELL_LABEL[$cell]=${LAST_LABEL}
+        done
+    
+        # Early stop: the cell's CI95 is already within the target
+        [ "$round" -lt "$MIN_REPS" ] && continue
+        for cell in "${pending[@]}"; do
+            [ -z "${CELL_LABEL[$cell]}" ] && continue
+            read -r impl msg_size threads port <<< "${cell}"
+            read -r n mean median sd lo hi rel <<< "$(cell_stats ${CELL_LABEL[$cell]} ${msg_size} ${threads} SteadyGbps ThroughputGbps)"
+            if [ "$n" -ge "$MIN_REPS" ] && awk -v r="$rel" -v t="$CI_TARGET_PCT" 'BEGIN { exit !(r <= t) }'; then
+                CONVERGED[$cell]=1
+                echo "Converged: ${CELL_LABEL[$cell]} ${msg_size}B x${threads} after ${n} trials (+-${rel}%)"
+            fi
+        done
+    done
+}
+
+# cell_table: "threads msg_size label mean ci_low ci_high" per measured cell,
+# sorted by thread count and size
+cell_table() {
+    local cell impl msg_size threads port n mean median sd lo hi rel
+    for cell in "${CELLS[@]}"; do
+        [ -z "${CELL_LABEL[$cell]}" ] && continue
+        read -r impl msg_size threads port <<< "${cell}"
+        read -r n mean median sd lo hi rel <<< "$(cell_stats ${CELL_LABEL[$cell]} ${msg_size} ${threads} SteadyGbps ThroughputGbps)"
+        echo "${threads} ${msg_size} ${CELL_LABEL[$cell]} ${mean} ${lo} ${hi}"
+    done | sort -k1,1n -k2,2n -k3,3
+}
+
+# crossover_midpoints: reads cell_table, prints "threads msg_size" for the
+# geometric midpoint (a multiple of 8) of every pair of neighbouring sizes
+# whose ranking differs and which are more than CROSSOVER_RESOLUTION apart
+crossover_midpoints() {
+    awk -v res="${CROSSOVER_RESOLUTION}" '
+        $1 != t || $2 != s { flush(); t = $1; s = $2; r = "" }
+        { rank[++k] = sprintf("%020.6f %s", $4, $3) }
+        END { flush() }
+        # Ranking of the size just read: labels ordered by mean, fastest first
+        function flush(   i, j, x, f) {
+            if (k == 0) return
+            for (i = 2; i <= k; i++) {
+                x = rank[i]
+                for (j = i - 1; j >= 1 && rank[j] < x; j--) rank[j + 1] = rank[j]
+                rank[j + 1] = x
+            }
+            for (i = 1; i <= k; i++) { split(rank[i], f, " "); r = r ">" f[2] }
+            if (t == pt && r != pr && s > pt_s * res) {
+                m = int(sqrt(s * pt_s) / 8 + 0.5) * 8
+                if (m > pt_s && m < s) print t, m
+            }
+            pt = t; pt_s = s; pr = r; k = 0
+        }'
+}
+
+# crossover_tables: reads cell_table, writes CROSSOVER_CSV and THRESHOLDS_CSV
+crossover_tables() {
+    awk -v xfile="${CROSSOVER_CSV}" -v tfile="${THRESHOLDS_CSV}" '
+        {
+            if (!(($1, $2) in seen)) {
+                seen[$1, $2] = 1
+                if (!($1 in nsizes)) tl[++nt] = $1
+                size[$1, ++nsizes[$1]] = $2
+            }
+            if (!($3 in known)) { known[$3] = 1; impl[++ni] = $3 }
+            mean[$1, $2, $3] = $4; lo[$1, $2, $3] = $5; hi[$1, $2, $3] = $6
+            has[$1, $2, $3] = 1
+        }
+        # Log-interpolated size where x and y are equally fast between a and b
+        function cross(t, a, b, x, y,   da, db) {
+            da = mean[t, a, x] - mean[t, a, y]
+            db = mean[t, b, x] - mean[t, b, y]
+            if (da == db) return a
+            return int(exp(log(a) + da / (da - db) * (log(b) - log(a))) + 0.5)
+        }
+        END {
+            print "Threads,LowSize,HighSize,CrossoverSize,FasterBelow,FasterAbove,Significant" > xfile
+            print "Threads,FromSize,ToSize,Best,BestGbps" > tfile
+            for (ti = 1; ti <= nt; ti++) {
+                t = tl[ti]
+                for (k = 1; k <= nsizes[t]; k++) {
+                    s = size[t, k]; best[k] = ""
+                    for (i = 1; i <= ni; i++)
+                        if (has[t, s, impl[i]] && (best[k] == "" || mean[t, s, impl[i]] > mean[t, s, best[k]]))
+                            best[k] = impl[i]
+                }
+                # Every pair of implementations whose order flips between neighbours
+                for (k = 1; k < nsizes[t]; k++) {
+                    a = size[t, k]; b = size[t, k + 1]
+                    for (i = 1; i <= ni; i++) for (j = i + 1; j <= ni; j++) {
+                        x = impl[i]; y = impl[j]
+                        if (!has[t, a, x] || !has[t, a, y] || !has[t, b, x] || !has[t, b, y]) continue
+                        da = mean[t, a, x] - mean[t, a, y]; db = mean[t, b, x] - mean[t, b, y]
+                        if (da * db >= 0) continue
+                        below = da > 0 ? x : y; above = da > 0 ? y : x
+                        sig = lo[t, a, below] > hi[t, a, above] && lo[t, b, above] > hi[t, b, below]
+                        printf "%s,%d,%d,%d,%s,%s,%d\n", t, a, b, cross(t, a, b, x, y), below, above, sig > xfile
+                    }
+                }
+                # Bands of the fastest implementation, split at the crossovers
+                from = size[t, 1]
+                for (k = 2; k <= nsizes[t] + 1; k++) {
+                    if (k <= nsizes[t] && best[k] == best[k - 1]) continue
+                    to = k <= nsizes[t] ? cross(t, size[t, k - 1], size[t, k], best[k - 1], best[k]) : size[t, nsizes[t]]
+                    printf "%s,%d,%d,%s,%.6f\n", t, from, to, best[k - 1], mean[t, size[t, k - 1], best[k - 1]] > tfile
+                    from = to
+                }
+            }
+        }'
+}
+
+# crossover_search: measures the coarse grid, then refines around ranking
+# changes; new cells are measured together, in random order, like the grid
+crossover_search() {
+    local step new threads msg_size impl
+    run_cells "${CELLS[@]}"
+    for ((step = 1; step <= CROSSOVER_STEPS; step++)); do
+        new=()
+        while read -r threads msg_size; do
+            for impl in "${!IMPL_PORT[@]}"; do
+                new+=("${impl} ${msg_size} ${threads} ${IMPL_PORT[$impl]}")
+            done
+        done < <(cell_table | crossover_midpoints)
+        if [ ${#new[@]} -eq 0 ]; then
+            echo ""
+            echo "No ranking changes left to refine after $((step - 1)) step(s)"
+            break
+        fi
+        echo ""
+        echo "=== Crossover refinement ${step}/${CROSSOVER_STEPS}: ${#new[@]} new cells ==="
+        CELLS+=("${new[@]}")
+        run_cells "${new[@]}"
+    done
+    
+    cell_table | crossover_tables
+    mapfile -t CELLS < <(printf '%s\n' "${CELLS[@]}" | sort -k3,3n -k2,2n -k1,1)
+}
+
+echo ""
+echo "=== ${#CELLS[@]} cells, up to ${REPS} trials each (stop at +-${CI_TARGET_PCT}% CI95 after ${MIN_REPS}) ==="
+
+round=0
+if [ "$WARMUP_TRIALS" -gt 0 ] && [ ${#CELLS[@]} -gt 0 ]; then
+    echo ""
+    echo "=== Warm-up: ${WARMUP_TRIALS} discarded trial(s) ==="
+    mapfile -t order < <(shuffled "${CELLS[@]}")
+    for ((w = 0; w < WARMUP_TRIALS; w++)); do
+        run_experiment ${order[$((w % ${#order[@]}))]} 0
+    done
+fi
+
+if [ "$SEARCH" = "crossover" ]; then
+    crossover_search
+else
+    run_cells "${CELLS[@]}"
+fi
+
+# Per-cell summary: Gbps is the steady-state rate (warm-up dropped inside each
+# trial, ThroughputGbps when a client reported none)
+echo "Implementation,MessageSize,Threads,Trials,Converged,MeanGbps,MedianGbps,StdGbps,Ci95LowGbps,Ci95HighGbps,Ci95RelPct,MeanP99Us,MedianP99Us,Ci95LowP99Us,Ci95HighP99Us,MeanCpuUsPerMsg" > "${SUMMARY_CSV}"
+echo ""
+echo "=== Summary (95% confidence intervals) ==="
+printf "%-14s %6s %3s %6s %12s %12s %20s %10s\n" "Impl" "Size" "Thr" "Trials" \
+       "Mean Gbps" "Median Gbps" "CI95 Gbps" "P99 us"
+for cell in "${CELLS[@]}"; do
+    [ -z "${CELL_LABEL[$cell]}" ] && continue
+    read -r impl msg_size threads port <<< "${cell}"
+    label=${CELL_LABEL[$cell]}
+    read -r n mean median sd lo hi rel <<< "$(cell_stats ${label} ${msg_size} ${threads} SteadyGbps ThroughputGbps)"
+    read -r p_n p_mean p_median p_sd p_lo p_hi p_rel <<< "$(cell_stats ${label} ${msg_size} ${threads} P99Us)"
+    read -r c_n c_mean c_rest <<< "$(cell_stats ${label} ${msg_size} ${threads} CpuUsPerMsg)"
+    converged=${CONVERGED[$cell]:-0}
+    echo "${label},${msg_size},${threads},${n},${converged},${mean},${median},${sd},${lo},${hi},${rel},${p_mean},${p_median},${p_lo},${p_hi},${c_mean}" >> "${SUMMARY_CSV}"
+    printf "%-14s %6s %3s %6s %12.4f %12.4f %9.4f..%-9.4f %10.2f\n" "${label}" "${msg_size}" \
+           "${threads}" "${n}" "${mean}" "${median}" "${lo}" "${hi}" "${p_median}"
+done
+
 # FIX: No consolidation needed - already writing to single CSV file
 echo ""
 echo "=== Experiment Complete ==="
 echo "Results saved in ${RESULTS_DIR}/"
-echo "Consolidated results: ${CONSOLIDATED_CSV}"
+echo "Consolidated results: ${CONSOLIDATED_CSV} (one row per trial)"
+echo "Per-cell summary: ${SUMMARY_CSV}"
+if [ "$SEARCH" = "crossover" ]; then
+    echo ""
+    echo "=== Fastest implementation per size band ==="
+    tr ',' '\t' < "${THRESHOLDS_CSV}"
+    echo ""
+    echo "=== Crossovers ==="
+    tr ',' '\t' < "${CROSSOVER_CSV}"
+    echo ""
+    echo "Crossover table: ${CROSSOVER_CSV}"
+    echo "Size thresholds: ${THRESHOLDS_CSV}"
+fi
 echo ""
 echo "Key files generated:"
-ls -lh ${CONSOLIDATED_CSV}
+ls -lh ${CONSOLIDATED_CSV} ${SUMMARY_CSV}
 echo ""
 echo "Perf output files:"
-ls ${RESULTS_DIR}/*.txt | wc -l
+ls ${RESULTS_DIR}/*_perf.txt | grep -v _server_perf | wc -l
 echo "perf files in results/"
 echo ""
 echo "To generate plots, run:"
@@ -0,0 +1,87 @@
+/*
+ * Ping-pong (request/response) mode shared by the A1/A2/A3 clients and servers.
+ *
+ * Streaming mode measures how fast a server can push messages; its
+ * "latency" is just inverse throughput. In ping-pong mode (--pingpong on
+ * both sides) every message is a true round trip:
+ *
+ *   Client                                   Server
+ *   PingRequest{seq, send_ns} --- send() -->  recv() the 16-byte request
+ *   RTT = now - hdr.send_ns  <-- one frame (MT25190_Framing.h) whose header
+ *                                echoes seq/send_ns, sent with the server's
+ *                                copy strategy (send / sendmsg / MSG_ZEROCOPY)
+ *
+ * The response's frame header carries the request's seq and send_ns, so
+ * the client needs no per-request state to compute the RTT.
+ */
+
+#ifndef MT25190_PINGPONG_H
+#define MT25190_PINGPONG_H
+
+#include <stdint.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+#include "MT25190_Histogram.h"   // monotonic_ns()
+#include "MT25190_BusyPoll.h"    // recv_spin()
+
+typedef struct {
+    uint64_t seq;       // Request number on this connection
+    uint64_t send_ns;   // Client CLOCK_MONOTONIC timestamp at send
+} PingRequest;
+
+/*
+ * pingpong_socket_setup: Disables Nagle on a ping-pong connection
+ * Request/response traffic must not wait for ACKs: with Nagle, A1's eight
+ * field-sized send() calls would stall behind the peer's delayed ACK and
+ * the RTT would measure the 40ms ACK timer instead of the copy path.
+ */
+static inline void pingpong_socket_setup(int sockfd) {
+    int one = 1;
+    setsockopt(sockfd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+/*
+ * send_ping_request: Sends the whole request (client side)
+ * Returns 0 on success, -1 with errno set.
+ */
+static inline int send_ping_request(int sockfd, const PingRequest *req) {
+    const char *p = (const char*)req;
+    size_t left = sizeof(*req);
+    while (left > 0) {
+        ssize_t n = send(sockfd, p, left, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        p += n;
+        left -= (size_t)n;
+    }
+    return 0;
+}
+
+/*
+ * recv_ping_request: Reads one whole request into 'dst' (server side)
+ * 'spin' polls with non-blocking recv() instead of sleeping (--busy-poll).
+ * Returns 1 on success, 0 when the client closed the connection, -1 on error.
+ */
+static inline int recv_ping_request(int sockfd, void *dst, int spin) {
+    char *p = (char*)dst;
+    size_t left = sizeof(PingRequest);
+    while (left > 0) {
+        ssize_t n = recv_spin(sockfd, p, left, 0, spin);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        if (n == 0) return 0;
+        p += n;
+        left -= (size_t)n;
+    }
+    return 1;
+}
+
+#endif /* MT25190_PINGPONG_H */
@@ -0,0 +1,477 @@
+/*
+ * Unified TCP server: one binary for every copy strategy (--mode)
+ *
+ * Socket setup, argument parsing, signal handling, the thread / epoll /
+ * reuseport engines, ping-pong and per-connection statistics live here;
+ * how one message is put on the wire comes from the selected
+ * ServerTransport (MT25190_Transport.h). Every strategy is therefore
+ * driven and measured by exactly the same code.
+ *
+ * The MT25190_Part_A{1,2,3,5}_Server binaries are this program built with
+ * a different DEFAULT_MODE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <errno.h>
+#include <signal.h>
+#include <getopt.h>
+#include <time.h>
+
+#include "MT25190_Transport.h"
+#include "MT25190_Checksum.h"
+#include "MT25190_EventLoop.h"
+#include "MT25190_PingPong.h"
+#include "MT25190_BusyPoll.h"
+#include "MT25190_Framing.h"
+#include "MT25190_Affinity.h"
+#include "MT25190_ServerStats.h"
+#include "MT25190_HwCounters.h"
+
+#ifndef DEFAULT_MODE
+#define DEFAULT_MODE "two-copy"
+#endif
+
+#define MAX_CLIENTS 100
+#define HW_REPORT_WAIT_MS 1000  // Sender threads to exit before --hw-counters reports
+#define HANDLER_EXIT_WAIT_MS 3000   // Handlers to close (zero-copy drains up to 1 s) at shutdown
+
+/* Global configuration */
+int message_size = 1024;        // Size of each message field
+int num_threads = 4;            // Number of client threads to expect
+int pingpong = 0;               // 1: one response per client request (--pingpong)
+int busy_poll_usec = -1;        // >= 0: spin-receive requests, SO_BUSY_POLL budget (--busy-poll)
+int frame_checksum = 0;         // 1: seal every frame with its payload CRC32C (--checksum)
+volatile sig_atomic_t running = 1;  // Server running flag (sig_atomic_t for signal safety)
+
+static const ServerTransport *transport;    // Selected copy strategy (--mode)
+
+/*
+ * Thread engine: handlers that have not closed their connection yet.
+ * Counted before pthread_create(), so shutdown cannot miss one that has
+ * not started; the last one to leave signals handlers_done.
+ */
+static int live_handlers = 0;
+static pthread_mutex_t handlers_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t handlers_done = PTHREAD_COND_INITIALIZER;
+
+static void handler_exit(void) {
+    pthread_mutex_lock(&handlers_lock);
+    if (--live_handlers == 0) pthread_cond_broadcast(&handlers_done);
+    pthread_mutex_unlock(&handlers_lock);
+}
+
+/*
+ * wait_for_handlers: Waits (at most timeout_ms) until every handler has
+ * closed its connection, so their per-connection totals are complete.
+ * Returns the number still running.
+ */
+static int wait_for_handlers(int timeout_ms) {
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+    pthread_mutex_lock(&handlers_lock);
+    while (live_handlers > 0 &&
+           pthread_cond_timedwait(&handlers_done, &handlers_lock, &deadline) == 0) {}
+    int left = live_handlers;
+    pthread_mutex_unlock(&handlers_lock);
+    return left;
+}
+
+/* Signal handler for graceful shutdown */
+void signal_handler(int signum) {
+    (void)signum;  // Suppress unused warning
+    printf("\nReceived shutdown signal. Stopping server...\n");
+    running = 0;
+}
+
+/*
+ * client_handler: Thread function to handle each client connection
+ * Each client is handled by a separate pthread; the transport only
+ * supplies the connection state and the send of one message.
+ */
+void* client_handler(void *arg) {
+    int client_sock = *(int*)arg;
+    free(arg);  // Free the allocated socket descriptor
+    affinity_pin_next();    // Before allocating: buffers land on this CPU's node
+    hwc_thread_begin();     // Counted until the thread exits (--hw-counters)
+
+    printf("[Thread %lu] Client connected\n", pthread_self());
+
+    void *state = transport->ops.conn_open(client_sock);
+    if (!state) {
+        close(client_sock);
+        handler_exit();
+        return NULL;
+    }
+
+    if (pingpong) pingpong_socket_setup(client_sock);
+    if (busy_poll_usec >= 0) busy_poll_setup(client_sock, busy_poll_usec);
+
+    // Send messages repeatedly until connection closes or error
+    int messages_sent = 0;
+    uint64_t cpu_start = thread_cpu_ns();
+    while (running) {
+        // Reserve send buffers first, so waiting for them never counts
+        // against the reply or its timestamp
+        if (transport->prepare_message && transport->prepare_message(client_sock, state) < 0) {
+            break;
+        }
+
+        // Ping-pong: wait for the request and echo its seq/timestamp in the
+        // frame header; streaming: stamp our own sequence and send time
+        uint64_t seq = (uint64_t)messages_sent;
+        uint64_t send_ns;
+        if (pingpong) {
+            PingRequest req;
+            int r = recv_ping_request(client_sock, &req, busy_poll_usec >= 0);
+            if (r <= 0) {
+                if (r < 0) perror("request recv error");
+                printf("[Thread %lu] Client disconnected\n", pthread_self());
+                break;
+            }
+            seq = req.seq;
+            send_ns = req.send_ns;
+        } else {
+            send_ns = monotonic_ns();
+        }
+
+        if (transport->send_message(client_sock, state, seq, send_ns) < 0) {
+            if (errno == EPIPE || errno == ECONNRESET || errno == EINTR) {
+                printf("[Thread %lu] Client disconnected\n", pthread_self());
+                break;
+            }
+            perror(transport->send_error);
+            break;
+        }
+
+        messages_sent++;
+        stats_message();
+    }
+
+    printf("[Thread %lu] Total messages sent: %d\n", pthread_self(), messages_sent);
+    printf("[Thread %lu] CPU per message: %.3f us\n", pthread_self(),
+           messages_sent ? (thread_cpu_ns() - cpu_start) / 1e3 / messages_sent : 0.0);
+    if (transport->conn_report) transport->conn_report(state);
+
+    // Cleanup
+    transport->ops.conn_close(client_sock, state);
+    close(client_sock);
+    handler_exit();
+
+    return NULL;
+}
+
+/*
+ * report_server_metrics: One SERVER_METRICS line at shutdown with the
+ * sender threads' hardware counters (--hw-counters; per-thread lines
+ * first, once the threads have exited: thread-engine handlers leave when
+ * their client disconnects or 'running' drops) and the strategy's own
+ * totals (zero-copy completions, added as each connection closes, so the
+ * caller has waited for the handlers)
+ */
+static void report_server_metrics(int hw_counters) {
+    char hw[1024] = "";
+    char extra[512] = "";
+    if (hw_counters) {
+        hwc_wait_threads(HW_REPORT_WAIT_MS);
+        hwc_report("server", NULL);
+        hwc_format_metrics(hw, sizeof(hw));
+    }
+    if (transport->format_metrics) transport->format_metrics(extra, sizeof(extra));
+    if (!hw[0] && !extra[0]) return;
+    printf("SERVER_METRICS %s%s%s\n", hw, hw[0] && extra[0] ? " " : "", extra);
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s <port> <message_size> <num_threads>\n"
+                    "       [--mode=%s]\n"
+                    "       [--engine=thread|epoll|reuseport] [--workers=N] [--reuseport-bpf]\n"
+                    "       [--pingpong] [--busy-poll[=USEC]] [--affinity=POLICY] [--checksum]\n"
+                    "       [--stats] [--hw-counters]\n"
+                    "       %s\n",
+            prog, transport_mode_list(), transport->usage ? transport->usage : "");
+}
+
+/*
+ * Main server function
+ */
+int main(int argc, char *argv[]) {
+    int server_sock, client_sock;
+    struct sockaddr_in server_addr, client_addr;
+    socklen_t client_len = sizeof(client_addr);
+    pthread_t thread_id;
+
+    // Register signal handlers for graceful shutdown
+    signal(SIGINT, signal_handler);
+    signal(SIGTERM, signal_handler);
+    signal(SIGPIPE, SIG_IGN);   // sendfile()/splice() have no MSG_NOSIGNAL; EPIPE ends a connection
+
+    // The strategy decides which extra flags exist, so find it first
+    const char *mode = scan_mode_option(argc, argv);
+    if (!mode) mode = DEFAULT_MODE;
+    transport = find_server_transport(mode);
+    if (!transport) {
+        fprintf(stderr, "Unknown mode '%s' (expected %s)\n", mode, transport_mode_list());
+        exit(EXIT_FAILURE);
+    }
+
+    // Optional flags (may appear anywhere): --mode=STRATEGY (see MT25190_Transport.h)
+    // --engine=thread|epoll|reuseport --workers=N
+    // --reuseport-bpf (steer connections to the listener of the SYN's CPU)
+    // --pingpong (reflect one response per client request)
+    // --busy-poll[=USEC] (spin on requests instead of sleeping in recv())
+    // --affinity=POLICY (pin threads to CPUs, see MT25190_Affinity.h)
+    // --checksum (payload CRC32C in every frame header for client --verify)
+    // --stats (live per-thread counters in shared memory, see MT25190_ServerStats.h)
+    // --hw-counters (per-thread perf_event_open counters, see MT25190_HwCounters.h)
+    // plus the strategy's own flags (ServerTransport.options)
+    int engine = ENGINE_THREAD;
+    int num_workers = default_worker_count();
+    int reuseport_bpf = 0;
+    int live_stats = 0;
+    int hw_counters = 0;
+    static const struct option common_options[] = {
+        {"mode",    required_argument, 0, 'm'},
+        {"engine",  required_argument, 0, 'e'},
+        {"workers", required_argument, 0, 'w'},
+        {"reuseport-bpf", no_argument, 0, 'R'},
+        {"pingpong", no_argument,      0, 'p'},
+        {"busy-poll", optional_argument, 0, 'B'},
+        {"affinity", required_argument, 0, 'a'},
+        {"checksum", no_argument,      0, 'c'},
+        {"stats",   no_argument,       0, 'S'},
+        {"hw-counters", no_argument,   0, 'K'},
+        {0, 0, 0, 0}
+    };
+    const struct option *long_options = merge_options(common_options, transport->options);
+    int opt_char;
+    while ((opt_char = getopt_long(argc, argv, "", long_options, NULL)) != -1) {
+        switch (opt_char) {
+        case 'm':
+            break;  // Resolved above
+        case 'e':
+            engine = parse_engine(optarg);
+            if (engine < 0) {
+                fprintf(stderr, "Unknown engine '%s' (expected thread|epoll|reuseport)\n", optarg);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'w':
+            num_workers = atoi(optarg);
+            break;
+        case 'R':
+            reuseport_bpf = 1;
+            break;
+        case 'p':
+            pingpong = 1;
+            break;
+        case 'B':
+            busy_poll_usec = parse_busy_poll(optarg);
+            if (busy_poll_usec < 0) {
+                fprintf(stderr, "Invalid --busy-poll budget '%s' (microseconds)\n", optarg);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'a':
+            if (affinity_configure(optarg, AFFINITY_SERVER) < 0) exit(EXIT_FAILURE);
+            break;
+        case 'c':
+            frame_checksum = 1;
+            break;
+        case 'S':
+            live_stats = 1;
+            break;
+        case 'K':
+            hw_counters = 1;
+            break;
+        case '?':
+            usage(argv[0]);
+            exit(EXIT_FAILURE);
+        default:
+            if (!transport->parse_option || transport->parse_option(opt_char, optarg) < 0) {
+                usage(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        }
+    }
+
+    // Parse positional arguments: <port> <message_size> <num_threads>
+    // PA02 requirement: Port must be passed explicitly for automation
+    int port = transport->default_port;
+    if (argc > optind) {
+        port = atoi(argv[optind]);
+    }
+    if (argc > optind + 1) {
+        message_size = atoi(argv[optind + 1]);
+    }
+    if (argc > optind + 2) {
+        num_threads = atoi(argv[optind + 2]);
+    }
+
+    if (pingpong && engine != ENGINE_THREAD) {
+        fprintf(stderr, "--pingpong requires --engine=thread\n");
+        exit(EXIT_FAILURE);
+    }
+    if (reuseport_bpf && engine != ENGINE_REUSEPORT) {
+        fprintf(stderr, "--reuseport-bpf requires --engine=reuseport\n");
+        exit(EXIT_FAILURE);
+    }
+    if (busy_poll_usec >= 0 && engine != ENGINE_THREAD) {
+        fprintf(stderr, "--busy-poll requires --engine=thread\n");
+        exit(EXIT_FAILURE);
+    }
+    // Field 1 carries the frame header, so it must fit in one field
+    if (message_size < (int)sizeof(FrameHeader)) {
+        fprintf(stderr, "message_size must be >= %zu (frame header)\n", sizeof(FrameHeader));
+        exit(EXIT_FAILURE);
+    }
+
+    printf("=== PA02 Part %s: %s Server ===\n", transport->part, transport->title);
+    printf("Roll Number: MT25190\n");
+    printf("Port: %d\n", port);
+    printf("Transport: %s\n", transport->name);
+    printf("Message size: %d bytes per field\n", message_size);
+    printf("Expected threads: %d\n", num_threads);
+    printf("Engine: %s\n", engine_name(engine));
+    printf("Mode: %s\n", pingpong ? "ping-pong (request/response)" : "streaming");
+    if (frame_checksum) printf("Checksum: payload CRC32C per frame (%s)\n", crc32c_kernel());
+    if (live_stats) {
+        if (stats_create(port, transport->name, (size_t)message_size * NUM_FIELDS) < 0) {
+            perror("Stats segment creation failed");
+            exit(EXIT_FAILURE);
+        }
+        atexit(stats_destroy);
+        char name[64];
+        stats_name(name, sizeof(name), port);
+        printf("Stats: live counters in /dev/shm%s (MT25190_StatsReader %d)\n", name, port);
+    }
+    if (hw_counters && hwc_enable() < 0) hw_counters = 0;
+    if (transport->describe) transport->describe();
+    printf("\n");
+
+    if (transport->setup && transport->setup() < 0) exit(EXIT_FAILURE);
+
+    // Create TCP socket
+    server_sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (server_sock < 0) {
+        perror("Socket creation failed");
+        exit(EXIT_FAILURE);
+    }
+
+    // Set socket options to reuse address
+    int opt = 1;
+    if (setsockopt(server_sock, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0) {
+        perror("setsockopt failed");
+        exit(EXIT_FAILURE);
+    }
+    // Reuseport engine: the workers' listeners join this socket's group
+    if (engine == ENGINE_REUSEPORT &&
+        setsockopt(server_sock, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) < 0) {
+        perror("setsockopt SO_REUSEPORT failed");
+        exit(EXIT_FAILURE);
+    }
+
+    // Configure server address
+    memset(&server_addr, 0, sizeof(server_addr));
+    server_addr.sin_family = AF_INET;
+    server_addr.sin_addr.s_addr = INADDR_ANY;
+    server_addr.sin_port = htons(port);
+
+    // Bind socket to address
+    if (bind(server_sock, (struct sockaddr*)&server_addr, sizeof(server_addr)) < 0) {
+        perror("Bind failed");
+        exit(EXIT_FAILURE);
+    }
+
+    // Listen for connections
+    if (listen(server_sock, MAX_CLIENTS) < 0) {
+        perror("Listen failed");
+        exit(EXIT_FAILURE);
+    }
+
+    printf("Server listening on port %d...\n", port);
+
+    // Event-loop engine: N epoll workers instead of one thread per client
+    // (reuseport: each worker also accepts on its own listener)
+    if (engine != ENGINE_THREAD) {
+        EventLoopOps ops = transport->ops;
+        ops.message_bytes = (size_t)message_size * NUM_FIELDS;
+        int rc = engine == ENGINE_REUSEPORT
+                     ? event_loop_run_reuseport(server_sock, num_threads, num_workers,
+                                                reuseport_bpf, &ops, &running)
+                     : event_loop_run(server_sock, num_threads, num_workers, &ops, &running);
+        close(server_sock);
+        if (transport->teardown) transport->teardown();
+        report_server_metrics(hw_counters);
+        return rc == 0 ? 0 : EXIT_FAILURE;
+    }
+
+    printf("Waiting for %d client connections...\n\n", num_threads);
+
+    // Accept client connections and spawn threads
+    int connected_clients = 0;
+    while (connected_clients < num_threads) {
+        client_sock = accept(server_sock, (struct sockaddr*)&client_addr, &client_len);
+        if (client_sock < 0) {
+            perror("Accept failed");
+            continue;
+        }
+
+        printf("Accepted connection %d from %s:%d\n",
+               connected_clients + 1,
+               inet_ntoa(client_addr.sin_addr),
+               ntohs(client_addr.sin_port));
+
+        // Allocate memory for socket descriptor to pass to thread
+        int *sock_ptr = (int*)malloc(sizeof(int));
+        *sock_ptr = client_sock;
+
+        // Create thread to handle client
+        pthread_mutex_lock(&handlers_lock);
+        live_handlers++;
+        pthread_mutex_unlock(&handlers_lock);
+        if (pthread_create(&thread_id, NULL, client_handler, sock_ptr) != 0) {
+            perror("Thread creation failed");
+            free(sock_ptr);
+            close(client_sock);
+            handler_exit();
+            continue;
+        }
+
+        // Detach thread so resources are freed automatically
+        pthread_detach(thread_id);
+
+        connected_clients++;
+    }
+
+    printf("\nAll %d clients connected. Press Ctrl+C to stop.\n", num_threads);
+
+    // Keep server running
+    while (running) {
+        sleep(1);
+    }
+
+    close(server_sock);
+    // Handlers may still be sending from shared strategy state (the A5
+    // payload file) and have not added their totals yet
+    int left = wait_for_handlers(HANDLER_EXIT_WAIT_MS);
+    if (left > 0) {
+        fprintf(stderr, "%d connection handlers still running: totals are partial\n", left);
+    } else if (transport->teardown) {
+        transport->teardown();
+    }
+    report_server_metrics(hw_counters);
+    return 0;
+}
@@ -0,0 +1,128 @@
+/*
+ * Shared-memory server counters. See MT25190_ServerStats.h.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+#include "MT25190_ServerStats.h"
+
+ServerStatsShm *server_stats = NULL;
+__thread ServerCounters *stats_tls = NULL;
+
+static size_t stats_map_size;
+static char stats_shm_name[64];
+
+/* Threads beyond STATS_MAX_SLOTS count into a private, unreported slot */
+static __thread ServerCounters overflow_slot;
+
+void stats_name(char *buf, size_t len, int port) {
+    snprintf(buf, len, "/MT25190_stats_%d", port);
+}
+
+static size_t segment_size(uint32_t slots) {
+    return sizeof(ServerStatsShm) + (size_t)slots * sizeof(ServerCounters);
+}
+
+int stats_create(int port, const char *mode, size_t message_bytes) {
+    stats_name(stats_shm_name, sizeof(stats_shm_name), port);
+    shm_unlink(stats_shm_name);     // Left behind by a killed server
+    int fd = shm_open(stats_shm_name, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) return -1;
+
+    stats_map_size = segment_size(STATS_MAX_SLOTS);
+    // ftruncate() zero-fills: every slot starts unclaimed with zero counts
+    if (ftruncate(fd, (off_t)stats_map_size) < 0) {
+        close(fd);
+        shm_unlink(stats_shm_name);
+        return -1;
+    }
+    void *base = mmap(NULL, stats_map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        shm_unlink(stats_shm_name);
+        return -1;
+    }
+
+    ServerStatsShm *shm = (ServerStatsShm*)base;
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    shm->version = STATS_VERSION;
+    shm->max_slots = STATS_MAX_SLOTS;
+    shm->pid = (int32_t)getpid();
+    shm->message_bytes = (uint32_t)message_bytes;
+    shm->start_ns = (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+    snprintf(shm->mode, sizeof(shm->mode), "%s", mode);
+    // Magic last: a reader that sees it sees a complete header
+    __atomic_store_n(&shm->magic, STATS_MAGIC, __ATOMIC_RELEASE);
+    server_stats = shm;
+    return 0;
+}
+
+void stats_destroy(void) {
+    if (!server_stats) return;
+    // Only the name goes: detached sender threads may still be counting
+    // while the process exits, and readers keep their own mapping for a
+    // final sample. The pages are freed with the last mapping.
+    shm_unlink(stats_shm_name);
+}
+
+ServerCounters* stats_claim(void) {
+    ServerStatsShm *shm = server_stats;
+    uint32_t idx = shm ? __atomic_fetch_add(&shm->used, 1, __ATOMIC_RELAXED) : STATS_MAX_SLOTS;
+    if (idx >= STATS_MAX_SLOTS) {
+        if (shm && idx == STATS_MAX_SLOTS) {
+            fprintf(stderr, "stats: more than %d sending threads, extra ones not reported\n",
+                    STATS_MAX_SLOTS);
+        }
+        stats_tls = &overflow_slot;
+        return stats_tls;
+    }
+    ServerCounters *c = &shm->slots[idx];
+    __atomic_store_n(&c->tid, (uint64_t)syscall(SYS_gettid), __ATOMIC_RELEASE);
+    stats_tls = c;
+    return c;
+}
+
+const ServerStatsShm* stats_attach(int port, size_t *map_size) {
+    char name[64];
+    stats_name(name, sizeof(name), port);
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) return NULL;
+
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        close(fd);
+        return NULL;
+    }
+    if ((size_t)st.st_size < sizeof(ServerStatsShm)) {
+        close(fd);
+        errno = EPROTO;     // Not sized yet by the server
+        return NULL;
+    }
+    void *base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return NULL;
+
+    const ServerStatsShm *shm = (const ServerStatsShm*)base;
+    if (__atomic_load_n(&shm->magic, __ATOMIC_ACQUIRE) != STATS_MAGIC ||
+        shm->version != STATS_VERSION ||
+        segment_size(shm->max_slots) > (size_t)st.st_size) {
+        munmap(base, (size_t)st.st_size);
+        errno = EPROTO;
+        return NULL;
+    }
+    *map_size = (size_t)st.st_size;
+    return shm;
+}
+
+void stats_detach(const ServerStatsShm *shm, size_t map_size) {
+    if (shm) munmap((void*)shm, map_size);
+}
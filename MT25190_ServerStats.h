@@ -0,0 +1,130 @@
+/*
+ * Live server-side counters in a POSIX shared-memory segment (--stats).
+ *
+ * Server threads only report when they exit, and the Part C script stops
+ * the server with a signal, so its view of a run was never collected.
+ * With --stats every sending thread owns one cache-line-sized slot in
+ * "/MT25190_stats_<port>" and bumps its counters after each send syscall;
+ * MT25190_StatsReader maps the segment read-only and samples it while the
+ * test runs:
+ *
+ *   +-----------------+-----------+-----------+-----------+---
+ *   | header          | slot 0    | slot 1    | slot 2    | ...
+ *   +-----------------+-----------+-----------+-----------+---
+ *   |<- cache line -> |<- line -> |<- line -> |<- line -> |
+ *
+ * Each slot has exactly one writer (the thread that claimed it), which
+ * updates it with relaxed atomic stores and never a locked instruction,
+ * so counting costs a few plain stores to a line no other thread writes.
+ * Readers see every counter as a monotonically increasing 64-bit value
+ * and difference two samples for rates.
+ */
+
+#ifndef MT25190_SERVERSTATS_H
+#define MT25190_SERVERSTATS_H
+
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#define STATS_CACHELINE 64
+#define STATS_MAX_SLOTS 256
+#define STATS_MAGIC 0x4D543235u     // "MT25"
+#define STATS_VERSION 1
+
+/* One sending thread's counters (one cache line, single writer) */
+typedef struct {
+    _Alignas(STATS_CACHELINE) uint64_t tid;     // Kernel thread id, 0 while unclaimed
+    uint64_t bytes;             // Bytes the kernel accepted
+    uint64_t sends;             // Send syscalls that accepted bytes
+    uint64_t messages;          // Whole messages (8 fields) sent
+    uint64_t eagain;            // Sends refused with EAGAIN (socket buffer full)
+    uint64_t partial;           // Sends that accepted less than asked
+    uint64_t zc_completions;    // MSG_ZEROCOPY sends completed (error-queue ranges)
+    uint64_t zc_copied;         // ... of which the kernel copied after all
+} ServerCounters;
+
+/* Segment header; slots follow on the next cache line */
+typedef struct {
+    _Alignas(STATS_CACHELINE) uint32_t magic;
+    uint32_t version;
+    uint32_t max_slots;
+    uint32_t used;              // Slots claimed so far (atomic)
+    int32_t pid;                // Server process, for the reader's liveness check
+    uint32_t message_bytes;     // Bytes per message (8 fields)
+    uint64_t start_ns;          // CLOCK_MONOTONIC at creation
+    char mode[24];              // --mode of the server
+    ServerCounters slots[];
+} ServerStatsShm;
+
+/* The server's segment; NULL unless --stats is on */
+extern ServerStatsShm *server_stats;
+
+/*
+ * stats_create: Creates (replacing a stale one) and maps the segment for
+ * 'port'. Returns 0 on success, -1 with errno set.
+ */
+int stats_create(int port, const char *mode, size_t message_bytes);
+
+/* stats_destroy: Unlinks the server's segment (it stays mapped until exit) */
+void stats_destroy(void);
+
+/*
+ * stats_attach: Maps the segment of 'port' read-only (reader side).
+ * Returns it, or NULL with errno set. stats_detach releases it.
+ */
+const ServerStatsShm* stats_attach(int port, size_t *map_size);
+void stats_detach(const ServerStatsShm *shm, size_t map_size);
+
+/* stats_name: "/MT25190_stats_<port>" into buf */
+void stats_name(char *buf, size_t len, int port);
+
+/* This thread's slot, claimed on first use (stats_claim) */
+extern __thread ServerCounters *stats_tls;
+ServerCounters* stats_claim(void);
+
+static inline ServerCounters* stats_self(void) {
+    ServerCounters *c = stats_tls;
+    return c ? c : stats_claim();
+}
+
+/* stats_add: Single-writer increment, visible to readers without tearing */
+static inline void stats_add(uint64_t *counter, uint64_t n) {
+    __atomic_store_n(counter, *counter + n, __ATOMIC_RELAXED);
+}
+
+/*
+ * stats_sent: Accounts one send syscall that was asked to send 'want'
+ * bytes and returned 'ret'; returns 'ret' with errno preserved, so it
+ * wraps the call in place: n = stats_sent(send(fd, p, len, 0), len).
+ */
+static inline ssize_t stats_sent(ssize_t ret, size_t want) {
+    if (!server_stats) return ret;
+    int saved = errno;
+    ServerCounters *c = stats_self();
+    if (ret > 0) {
+        stats_add(&c->bytes, (uint64_t)ret);
+        stats_add(&c->sends, 1);
+        if ((size_t)ret < want) stats_add(&c->partial, 1);
+    } else if (ret < 0 && (saved == EAGAIN || saved == EWOULDBLOCK)) {
+        stats_add(&c->eagain, 1);
+    }
+    errno = saved;
+    return ret;
+}
+
+/* stats_message: One whole message left this thread */
+static inline void stats_message(void) {
+    if (server_stats) stats_add(&stats_self()->messages, 1);
+}
+
+/* stats_zerocopy: 'done' MSG_ZEROCOPY sends completed, 'copied' of them copied */
+static inline void stats_zerocopy(uint64_t done, uint64_t copied) {
+    if (!server_stats) return;
+    ServerCounters *c = stats_self();
+    stats_add(&c->zc_completions, done);
+    if (copied) stats_add(&c->zc_copied, copied);
+}
+
+#endif /* MT25190_SERVERSTATS_H */
@@ -0,0 +1,303 @@
+/*
+ * Shared-memory SPSC ring (memfd + futex). See MT25190_ShmRing.h.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <limits.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/un.h>
+#include <linux/futex.h>
+
+#include "MT25190_ShmRing.h"
+
+static inline void cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+/* Shared (not FUTEX_PRIVATE) ops: the waiter and waker are different processes */
+static int futex_wait(uint32_t *word, uint32_t expected, int timeout_ms) {
+    struct timespec ts = { timeout_ms / 1000, (long)(timeout_ms % 1000) * 1000000L };
+    return (int)syscall(SYS_futex, word, FUTEX_WAIT, expected, &ts, NULL, 0);
+}
+
+static void futex_wake(uint32_t *word, int count) {
+    syscall(SYS_futex, word, FUTEX_WAKE, count, NULL, NULL, 0);
+}
+
+static long elapsed_ms(const struct timespec *start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) * 1000L + (now.tv_nsec - start->tv_nsec) / 1000000L;
+}
+
+static size_t header_bytes(void) {
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    return (sizeof(ShmRingHeader) + page - 1) & ~(page - 1);
+}
+
+static inline char* slot_at(const ShmRing *r, uint32_t index) {
+    return r->slot_base + (size_t)(index & r->mask) * r->hdr->slot_stride;
+}
+
+/*
+ * ring_wait: Waits until *word moves away from 'seen', the ring closes, or
+ * 'timeout_ms' expires
+ * The waiter publishes *waiting before re-checking *word, and the other
+ * side publishes *word before checking *waiting (both with a full fence),
+ * so at least one of them sees the other's store and no wakeup is lost.
+ */
+static void ring_wait(ShmRing *r, uint32_t *word, uint32_t *waiting, uint32_t seen,
+                      int timeout_ms) {
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (long i = 0; ; i++) {
+        if (__atomic_load_n(word, __ATOMIC_ACQUIRE) != seen || shm_ring_closed(r)) return;
+        if (r->wait_mode == SHM_WAIT_FUTEX && i >= SHM_SPIN_LIMIT) break;
+        if ((i & 1023) == 1023 && elapsed_ms(&start) >= timeout_ms) return;
+        cpu_relax();
+    }
+
+    __atomic_store_n(waiting, 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(word, __ATOMIC_ACQUIRE) == seen && !shm_ring_closed(r)) {
+        // Returns at once (EAGAIN) if *word already changed
+        if (futex_wait(word, seen, timeout_ms) == 0 || errno == ETIMEDOUT) r->sleeps++;
+    }
+    __atomic_store_n(waiting, 0, __ATOMIC_RELAXED);
+}
+
+/* ring_notify: Wakes the peer after 'word' was advanced, if it is asleep */
+static void ring_notify(ShmRing *r, uint32_t *word, uint32_t *waiting) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(waiting, __ATOMIC_RELAXED)) {
+        futex_wake(word, 1);
+        r->wakes++;
+    }
+}
+
+int shm_ring_create(ShmRing *r, uint32_t slots, uint32_t slot_size, int wait_mode) {
+    memset(r, 0, sizeof(*r));
+    uint32_t n = 2;
+    while (n < slots) n <<= 1;
+    uint32_t stride = (slot_size + SHM_CACHELINE - 1) & ~(uint32_t)(SHM_CACHELINE - 1);
+
+    r->fd = memfd_create("MT25190_ring", MFD_CLOEXEC);
+    if (r->fd < 0) return -1;
+    r->map_size = header_bytes() + (size_t)n * stride;
+    if (ftruncate(r->fd, (off_t)r->map_size) < 0) {
+        close(r->fd);
+        return -1;
+    }
+
+    // ftruncate() zero-fills: head = tail = closed = 0
+    void *base = mmap(NULL, r->map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      r->fd, 0);
+    if (base == MAP_FAILED) {
+        close(r->fd);
+        return -1;
+    }
+    r->hdr = (ShmRingHeader*)base;
+    r->hdr->slots = n;
+    r->hdr->slot_size = slot_size;
+    r->hdr->slot_stride = stride;
+    r->slot_base = (char*)base + header_bytes();
+    r->mask = n - 1;
+    r->wait_mode = wait_mode;
+    return 0;
+}
+
+int shm_ring_attach(ShmRing *r, int fd, int wait_mode) {
+    struct stat st;
+    memset(r, 0, sizeof(*r));
+    r->fd = fd;
+    if (fstat(fd, &st) < 0) goto fail;
+    r->map_size = (size_t)st.st_size;
+    if (r->map_size < header_bytes()) {
+        errno = EINVAL;
+        goto fail;
+    }
+
+    void *base = mmap(NULL, r->map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      fd, 0);
+    if (base == MAP_FAILED) goto fail;
+    r->hdr = (ShmRingHeader*)base;
+
+    // Geometry comes from the creator; reject anything that overruns the map
+    uint32_t n = r->hdr->slots;
+    if (n < 2 || (n & (n - 1)) != 0 || r->hdr->slot_stride < r->hdr->slot_size ||
+        header_bytes() + (size_t)n * r->hdr->slot_stride > r->map_size) {
+        munmap(base, r->map_size);
+        errno = EINVAL;
+        goto fail;
+    }
+    r->slot_base = (char*)base + header_bytes();
+    r->mask = n - 1;
+    r->local = __atomic_load_n(&r->hdr->tail, __ATOMIC_ACQUIRE);
+    r->wait_mode = wait_mode;
+    return 0;
+
+fail:
+    close(fd);
+    r->fd = -1;
+    return -1;
+}
+
+void shm_ring_detach(ShmRing *r) {
+    if (r->hdr) munmap(r->hdr, r->map_size);
+    if (r->fd >= 0) close(r->fd);
+    r->hdr = NULL;
+    r->fd = -1;
+}
+
+void* shm_ring_acquire(ShmRing *r, int timeout_ms) {
+    ShmRingHeader *h = r->hdr;
+    uint32_t tail = __atomic_load_n(&h->tail, __ATOMIC_ACQUIRE);
+    if (r->local - tail > r->mask) {
+        // Full: every slot is published and not yet released
+        ring_wait(r, &h->tail, &h->prod_waiting, tail, timeout_ms);
+        tail = __atomic_load_n(&h->tail, __ATOMIC_ACQUIRE);
+        if (r->local - tail > r->mask) return NULL;
+    }
+    if (shm_ring_closed(r)) return NULL;
+    return slot_at(r, r->local);
+}
+
+void shm_ring_publish(ShmRing *r) {
+    r->local++;
+    __atomic_store_n(&r->hdr->head, r->local, __ATOMIC_RELEASE);
+    ring_notify(r, &r->hdr->head, &r->hdr->cons_waiting);
+}
+
+void* shm_ring_peek(ShmRing *r, int timeout_ms) {
+    ShmRingHeader *h = r->hdr;
+    uint32_t head = __atomic_load_n(&h->head, __ATOMIC_ACQUIRE);
+    if (head == r->local) {
+        // Empty: wait for the producer to publish
+        ring_wait(r, &h->head, &h->cons_waiting, head, timeout_ms);
+        head = __atomic_load_n(&h->head, __ATOMIC_ACQUIRE);
+        if (head == r->local) return NULL;
+    }
+    return slot_at(r, r->local);
+}
+
+void shm_ring_release(ShmRing *r) {
+    r->local++;
+    __atomic_store_n(&r->hdr->tail, r->local, __ATOMIC_RELEASE);
+    ring_notify(r, &r->hdr->tail, &r->hdr->prod_waiting);
+}
+
+void shm_ring_close(ShmRing *r) {
+    __atomic_store_n(&r->hdr->closed, 1, __ATOMIC_RELEASE);
+    futex_wake(&r->hdr->head, INT_MAX);
+    futex_wake(&r->hdr->tail, INT_MAX);
+}
+
+uint32_t shm_ring_default_slots(uint32_t slot_size) {
+    size_t per_ring = SHM_RING_BYTES / (slot_size ? slot_size : 1);
+    uint32_t n = 2;
+    while (n < SHM_RING_MAX_SLOTS && (size_t)n * 2 <= per_ring) n <<= 1;
+    return n;
+}
+
+/* Abstract socket address (leading NUL: no file on disk, gone with the socket) */
+static socklen_t shm_address(int port, struct sockaddr_un *addr) {
+    memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+    int len = snprintf(addr->sun_path + 1, sizeof(addr->sun_path) - 1, "MT25190_shm_%d", port);
+    return (socklen_t)(offsetof(struct sockaddr_un, sun_path) + 1 + len);
+}
+
+int shm_listen(int port, int backlog) {
+    struct sockaddr_un addr;
+    socklen_t len = shm_address(port, &addr);
+    int sock = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (sock < 0) return -1;
+    if (bind(sock, (struct sockaddr*)&addr, len) < 0 || listen(sock, backlog) < 0) {
+        close(sock);
+        return -1;
+    }
+    return sock;
+}
+
+int shm_connect(int port) {
+    struct sockaddr_un addr;
+    socklen_t len = shm_address(port, &addr);
+    int sock = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (sock < 0) return -1;
+    if (connect(sock, (struct sockaddr*)&addr, len) < 0) {
+        close(sock);
+        return -1;
+    }
+    return sock;
+}
+
+int shm_send_fd(int sockfd, int fd) {
+    char byte = 0;
+    struct iovec iov = { .iov_base = &byte, .iov_len = 1 };
+    union {
+        struct cmsghdr align;
+        char buf[CMSG_SPACE(sizeof(int))];
+    } control;
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    memset(&control, 0, sizeof(control));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buf;
+    msg.msg_controllen = sizeof(control.buf);
+
+    struct cmsghdr *cm = CMSG_FIRSTHDR(&msg);
+    cm->cmsg_level = SOL_SOCKET;
+    cm->cmsg_type = SCM_RIGHTS;
+    cm->cmsg_len = CMSG_LEN(sizeof(int));
+    memcpy(CMSG_DATA(cm), &fd, sizeof(int));
+
+    return sendmsg(sockfd, &msg, MSG_NOSIGNAL) == 1 ? 0 : -1;
+}
+
+int shm_recv_fd(int sockfd) {
+    char byte;
+    struct iovec iov = { .iov_base = &byte, .iov_len = 1 };
+    union {
+        struct cmsghdr align;
+        char buf[CMSG_SPACE(sizeof(int))];
+    } control;
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buf;
+    msg.msg_controllen = sizeof(control.buf);
+
+    ssize_t n = recvmsg(sockfd, &msg, MSG_CMSG_CLOEXEC);
+    if (n <= 0) {
+        if (n == 0) errno = ECONNRESET;
+        return -1;
+    }
+    struct cmsghdr *cm = CMSG_FIRSTHDR(&msg);
+    if (!cm || cm->cmsg_level != SOL_SOCKET || cm->cmsg_type != SCM_RIGHTS) {
+        errno = EPROTO;
+        return -1;
+    }
+    int fd;
+    memcpy(&fd, CMSG_DATA(cm), sizeof(int));
+    return fd;
+}
+
+int parse_wait_mode(const char *name) {
+    if (strcmp(name, "futex") == 0) return SHM_WAIT_FUTEX;
+    if (strcmp(name, "spin") == 0) return SHM_WAIT_SPIN;
+    return -1;
+}
@@ -0,0 +1,126 @@
+/*
+ * Shared-memory single-producer/single-consumer ring used by A6.
+ *
+ * One ring per server/client thread pair, living in a memfd that both
+ * processes mmap(); no socket carries any message data:
+ *
+ *   +------------------+------------------+----------------+--------+--------+---
+ *   | head, prod_wait  | tail, cons_wait  | slots, closed  | slot 0 | slot 1 | ...
+ *   +------------------+------------------+----------------+--------+--------+---
+ *   |<- cache line ->  |<- cache line ->  |<- cache line ->|<- page-aligned slots
+ *
+ *   producer (server): acquire free slot -> write frame -> publish (head++)
+ *   consumer (client): peek head != tail -> read frame  -> release (tail++)
+ *
+ * head is only written by the producer and tail only by the consumer, each
+ * on its own cache line, so the two sides never write the same line.
+ * An empty/full ring is waited on either by spinning (SHM_WAIT_SPIN) or by
+ * a short spin followed by FUTEX_WAIT on the index word (SHM_WAIT_FUTEX);
+ * the other side issues FUTEX_WAKE only when the waiter flagged itself.
+ *
+ * The memfd is handed to the client over an abstract Unix socket named
+ * after the port (SCM_RIGHTS), which is the only use of a socket.
+ */
+
+#ifndef MT25190_SHMRING_H
+#define MT25190_SHMRING_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define SHM_CACHELINE 64
+#define SHM_RING_BYTES (4 * 1024 * 1024)   // Default payload bytes per ring
+#define SHM_RING_MAX_SLOTS 256
+#define SHM_SPIN_LIMIT 2048                 // Polls before FUTEX_WAIT
+
+/* How an empty (consumer) or full (producer) ring is waited on */
+typedef enum {
+    SHM_WAIT_FUTEX = 0,     // Spin briefly, then sleep in FUTEX_WAIT
+    SHM_WAIT_SPIN  = 1      // Busy-poll only (needs a core per side)
+} ShmWaitMode;
+
+/* Shared header at offset 0 of the memfd */
+typedef struct {
+    _Alignas(SHM_CACHELINE) uint32_t head;  // Slots published (producer-owned)
+    uint32_t prod_waiting;                  // Producer sleeps on 'tail'
+    _Alignas(SHM_CACHELINE) uint32_t tail;  // Slots released (consumer-owned)
+    uint32_t cons_waiting;                  // Consumer sleeps on 'head'
+    _Alignas(SHM_CACHELINE) uint32_t slots; // Power of two, fixed at creation
+    uint32_t slot_size;                     // Bytes per slot (one frame)
+    uint32_t slot_stride;                   // slot_size rounded to a cache line
+    uint32_t closed;                        // Either side stopped
+} ShmRingHeader;
+
+/* Process-local view of a ring */
+typedef struct {
+    ShmRingHeader *hdr;
+    char *slot_base;        // First slot (page-aligned)
+    size_t map_size;
+    int fd;
+    uint32_t mask;          // slots - 1
+    uint32_t local;         // Producer: next head; consumer: next tail
+    int wait_mode;
+    long sleeps;            // FUTEX_WAIT calls that actually slept
+    long wakes;             // FUTEX_WAKE calls issued
+} ShmRing;
+
+/*
+ * shm_ring_create: Creates a memfd holding 'slots' slots of 'slot_size'
+ * bytes ('slots' is rounded up to a power of two) and maps it.
+ * Returns 0 on success, -1 with errno set on failure.
+ */
+int shm_ring_create(ShmRing *r, uint32_t slots, uint32_t slot_size, int wait_mode);
+
+/*
+ * shm_ring_attach: Maps a ring received from the creator; the geometry is
+ * read from the shared header. Takes ownership of 'fd'.
+ * Returns 0 on success, -1 with errno set on failure.
+ */
+int shm_ring_attach(ShmRing *r, int fd, int wait_mode);
+
+void shm_ring_detach(ShmRing *r);
+
+/*
+ * shm_ring_acquire: Producer side. Returns the next free slot, or NULL if
+ * none freed up within 'timeout_ms' or the ring was closed.
+ */
+void* shm_ring_acquire(ShmRing *r, int timeout_ms);
+
+/* shm_ring_publish: Producer side. Hands the acquired slot to the consumer. */
+void shm_ring_publish(ShmRing *r);
+
+/*
+ * shm_ring_peek: Consumer side. Returns the oldest published slot, or NULL
+ * if nothing arrived within 'timeout_ms' or the ring was closed.
+ */
+void* shm_ring_peek(ShmRing *r, int timeout_ms);
+
+/* shm_ring_release: Consumer side. Returns the peeked slot to the producer. */
+void shm_ring_release(ShmRing *r);
+
+/* shm_ring_close: Marks the ring closed and wakes the peer */
+void shm_ring_close(ShmRing *r);
+
+static inline int shm_ring_closed(const ShmRing *r) {
+    return __atomic_load_n(&r->hdr->closed, __ATOMIC_ACQUIRE) != 0;
+}
+
+/*
+ * shm_ring_default_slots: Slot count for one ring, keeping it near
+ * SHM_RING_BYTES so large messages do not multiply the memfd size
+ */
+uint32_t shm_ring_default_slots(uint32_t slot_size);
+
+/*
+ * Ring handoff over the abstract Unix socket "@MT25190_shm_<port>".
+ * shm_listen/shm_connect return a socket or -1; shm_send_fd returns 0/-1;
+ * shm_recv_fd returns the received descriptor or -1.
+ */
+int shm_listen(int port, int backlog);
+int shm_connect(int port);
+int shm_send_fd(int sockfd, int fd);
+int shm_recv_fd(int sockfd);
+
+int parse_wait_mode(const char *name);
+
+#endif /* MT25190_SHMRING_H */
@@ -0,0 +1,275 @@
+/*
+ * Live reader for the server's shared-memory counters (server --stats)
+ *
+ * Maps "/MT25190_stats_<port>" read-only and samples it every --interval
+ * milliseconds while a test runs, printing the server-side rates of the
+ * last interval: send throughput, messages, send syscalls, EAGAINs,
+ * partial sends and MSG_ZEROCOPY completions / copied fallbacks. The
+ * server is never stopped or signalled; its sender threads keep counting
+ * into their own cache lines (see MT25190_ServerStats.h).
+ *
+ * Stops after --count samples, on SIGINT/SIGTERM, or when the server
+ * process is gone, and prints one SERVER_STATS summary line for scripts.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <signal.h>
+#include <time.h>
+#include <getopt.h>
+#include <errno.h>
+
+#include "MT25190_ServerStats.h"
+#include "MT25190_Histogram.h"   // monotonic_ns()
+
+#define DEFAULT_INTERVAL_MS 1000
+#define DEFAULT_WAIT_MS 5000        // How long to wait for the server to create the segment
+#define ATTACH_RETRY_MS 50
+
+static volatile sig_atomic_t running = 1;
+
+static void signal_handler(int signum) {
+    (void)signum;
+    running = 0;
+}
+
+/* Sum of (or one thread's) counters at one instant */
+typedef struct {
+    uint64_t bytes, sends, messages, eagain, partial, zc_completions, zc_copied;
+} Sample;
+
+static void read_slot(const ServerCounters *c, Sample *s) {
+    s->bytes = __atomic_load_n(&c->bytes, __ATOMIC_RELAXED);
+    s->sends = __atomic_load_n(&c->sends, __ATOMIC_RELAXED);
+    s->messages = __atomic_load_n(&c->messages, __ATOMIC_RELAXED);
+    s->eagain = __atomic_load_n(&c->eagain, __ATOMIC_RELAXED);
+    s->partial = __atomic_load_n(&c->partial, __ATOMIC_RELAXED);
+    s->zc_completions = __atomic_load_n(&c->zc_completions, __ATOMIC_RELAXED);
+    s->zc_copied = __atomic_load_n(&c->zc_copied, __ATOMIC_RELAXED);
+}
+
+static void add_sample(Sample *total, const Sample *s) {
+    total->bytes += s->bytes;
+    total->sends += s->sends;
+    total->messages += s->messages;
+    total->eagain += s->eagain;
+    total->partial += s->partial;
+    total->zc_completions += s->zc_completions;
+    total->zc_copied += s->zc_copied;
+}
+
+static uint32_t claimed_slots(const ServerStatsShm *shm) {
+    uint32_t used = __atomic_load_n(&shm->used, __ATOMIC_RELAXED);
+    return used < shm->max_slots ? used : shm->max_slots;
+}
+
+/* server_alive: The process that created the segment still exists */
+static int server_alive(const ServerStatsShm *shm) {
+    return kill((pid_t)shm->pid, 0) == 0 || errno == EPERM;
+}
+
+/*
+ * print_rates: One output row of interval rates: "total" (tid 0) or one
+ * thread. Text columns on stdout, or a CSV row when 'csv' is open.
+ */
+static void print_rates(FILE *csv, double t, uint64_t tid, const Sample *now,
+                        const Sample *prev, double dt) {
+    double gbps = (now->bytes - prev->bytes) * 8.0 / (dt * 1e9);
+    double msgs = (now->messages - prev->messages) / dt;
+    double sends = (now->sends - prev->sends) / dt;
+    double eagain = (now->eagain - prev->eagain) / dt;
+    double partial = (now->partial - prev->partial) / dt;
+    double zc_done = (now->zc_completions - prev->zc_completions) / dt;
+    double zc_copied = (now->zc_copied - prev->zc_copied) / dt;
+    if (csv) {
+        fprintf(csv, "%.3f,%lu,%.6f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f\n", t, (unsigned long)tid,
+                gbps, msgs, sends, eagain, partial, zc_done, zc_copied);
+        return;
+    }
+    char who[32];
+    if (tid) snprintf(who, sizeof(who), "tid %lu", (unsigned long)tid);
+    else snprintf(who, sizeof(who), "total");
+    printf("[%8.3fs] %-10s %8.3f Gbps %10.0f msg/s %10.0f send/s %9.0f eagain/s "
+           "%9.0f partial/s", t, who, gbps, msgs, sends, eagain, partial);
+    if (now->zc_completions) printf(" %9.0f zc/s %9.0f copied/s", zc_done, zc_copied);
+    printf("\n");
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s <port> [--interval=MS] [--count=N] [--wait=MS]\n"
+                    "       [--per-thread] [--csv=FILE]\n", prog);
+}
+
+int main(int argc, char *argv[]) {
+    // Optional flags (may appear anywhere): --interval=MS (sampling period)
+    // --count=N (stop after N samples, 0 = until the server exits)
+    // --wait=MS (how long to wait for the server's segment to appear)
+    // --per-thread (one row per sender thread as well as the total)
+    // --csv=FILE (rows as CSV in FILE instead of text on stdout)
+    int interval_ms = DEFAULT_INTERVAL_MS;
+    long count = 0;
+    int wait_ms = DEFAULT_WAIT_MS;
+    int per_thread = 0;
+    const char *csv_path = NULL;
+    static const struct option long_options[] = {
+        {"interval",   required_argument, 0, 'i'},
+        {"count",      required_argument, 0, 'n'},
+        {"wait",       required_argument, 0, 'w'},
+        {"per-thread", no_argument,       0, 't'},
+        {"csv",        required_argument, 0, 'o'},
+        {0, 0, 0, 0}
+    };
+    int opt_char;
+    while ((opt_char = getopt_long(argc, argv, "", long_options, NULL)) != -1) {
+        switch (opt_char) {
+        case 'i':
+            interval_ms = atoi(optarg);
+            break;
+        case 'n':
+            count = atol(optarg);
+            break;
+        case 'w':
+            wait_ms = atoi(optarg);
+            break;
+        case 't':
+            per_thread = 1;
+            break;
+        case 'o':
+            csv_path = optarg;
+            break;
+        default:
+            usage(argv[0]);
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (argc <= optind || interval_ms <= 0) {
+        usage(argv[0]);
+        exit(EXIT_FAILURE);
+    }
+    int port = atoi(argv[optind]);
+
+    signal(SIGINT, signal_handler);
+    signal(SIGTERM, signal_handler);
+
+    // The server creates the segment once its arguments are parsed, which
+    // may be after we start: retry for up to --wait ms
+    size_t map_size = 0;
+    const ServerStatsShm *shm = NULL;
+    for (int waited = 0; running; waited += ATTACH_RETRY_MS) {
+        shm = stats_attach(port, &map_size);
+        if (shm || waited >= wait_ms || (errno != ENOENT && errno != EPROTO)) break;
+        usleep(ATTACH_RETRY_MS * 1000);
+    }
+    if (!shm) {
+        char name[64];
+        stats_name(name, sizeof(name), port);
+        fprintf(stderr, "Cannot attach %s: %s (server started with --stats?)\n",
+                name, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+
+    FILE *csv = NULL;
+    if (csv_path) {
+        csv = fopen(csv_path, "w");
+        if (!csv) {
+            perror("CSV open failed");
+            exit(EXIT_FAILURE);
+        }
+        fprintf(csv, "time_s,tid,gbps,msgs_per_s,sends_per_s,eagain_per_s,partial_per_s,"
+                     "zc_completions_per_s,zc_copied_per_s\n");
+    }
+
+    printf("=== PA02 Server Stats Reader ===\n");
+    printf("Roll Number: MT25190\n");
+    printf("Server: pid %d, port %d, mode %s, %u bytes per message\n",
+           shm->pid, port, shm->mode, shm->message_bytes);
+    printf("Interval: %d ms%s\n\n", interval_ms, csv ? "" : " (rates over the last interval)");
+    fflush(stdout);
+
+    Sample *prev = calloc(shm->max_slots, sizeof(Sample));
+    Sample *now = calloc(shm->max_slots, sizeof(Sample));
+    if (!prev || !now) {
+        perror("Sample allocation failed");
+        exit(EXIT_FAILURE);
+    }
+
+    // Active window: from the last sample before any byte was sent to the
+    // last sample in which bytes still moved, so the accept phase and the
+    // idle tail after the clients finished do not dilute server_gbps
+    Sample total_prev = {0}, total_now = {0}, total_start = {0};
+    uint64_t start_ns = monotonic_ns();
+    uint64_t prev_ns = start_ns, window_start_ns = start_ns, window_end_ns = start_ns;
+    uint64_t window_bytes = 0;
+    uint32_t slots = claimed_slots(shm);
+    for (uint32_t i = 0; i < slots; i++) {
+        read_slot(&shm->slots[i], &prev[i]);
+        add_sample(&total_prev, &prev[i]);
+    }
+    total_start = total_prev;
+
+    long samples = 0;
+    struct timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    while (running && (count == 0 || samples < count)) {
+        next.tv_nsec += (long)(interval_ms % 1000) * 1000000L;
+        next.tv_sec += interval_ms / 1000 + next.tv_nsec / 1000000000L;
+        next.tv_nsec %= 1000000000L;
+        if (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL) != 0 && !running) break;
+        int alive = server_alive(shm);
+
+        uint64_t now_ns = monotonic_ns();
+        double dt = (now_ns - prev_ns) / 1e9;
+        double t = (now_ns - start_ns) / 1e9;
+        slots = claimed_slots(shm);
+        memset(&total_now, 0, sizeof(total_now));
+        for (uint32_t i = 0; i < slots; i++) {
+            read_slot(&shm->slots[i], &now[i]);
+            add_sample(&total_now, &now[i]);
+        }
+
+        print_rates(csv, t, 0, &total_now, &total_prev, dt);
+        if (per_thread) {
+            for (uint32_t i = 0; i < slots; i++) {
+                uint64_t tid = __atomic_load_n(&shm->slots[i].tid, __ATOMIC_ACQUIRE);
+                if (tid) print_rates(csv, t, tid, &now[i], &prev[i], dt);
+            }
+        }
+        if (!csv) fflush(stdout);
+
+        if (total_now.bytes == total_start.bytes) {
+            window_start_ns = now_ns;
+        } else if (total_now.bytes != total_prev.bytes) {
+            window_end_ns = now_ns;
+            window_bytes = total_now.bytes - total_start.bytes;
+        }
+
+        memcpy(prev, now, slots * sizeof(Sample));
+        total_prev = total_now;
+        prev_ns = now_ns;
+        samples++;
+        if (!alive) {
+            printf("Server (pid %d) exited\n", shm->pid);
+            break;
+        }
+    }
+
+    double window_s = window_end_ns > window_start_ns
+                    ? (window_end_ns - window_start_ns) / 1e9 : 0.0;
+    double server_gbps = window_s > 0 ? window_bytes * 8.0 / (window_s * 1e9) : 0.0;
+    // PA02 requirement: Output parseable metrics for script collection
+    printf("SERVER_STATS samples=%ld active_s=%.3f server_gbps=%.6f bytes=%lu messages=%lu "
+           "sends=%lu eagain=%lu partial=%lu zc_completions=%lu zc_copied=%lu threads=%u\n",
+           samples, window_s, server_gbps, (unsigned long)total_prev.bytes,
+           (unsigned long)total_prev.messages, (unsigned long)total_prev.sends,
+           (unsigned long)total_prev.eagain, (unsigned long)total_prev.partial,
+           (unsigned long)total_prev.zc_completions, (unsigned long)total_prev.zc_copied,
+           slots);
+
+    if (csv) fclose(csv);
+    free(prev);
+    free(now);
+    stats_detach(shm, map_size);
+    return 0;
+}
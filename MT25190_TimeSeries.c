@@ -0,0 +1,231 @@
+/*
+ * Client throughput time series. See MT25190_TimeSeries.h.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "MT25190_TimeSeries.h"
+#include "MT25190_Histogram.h"   // monotonic_ns()
+
+/* One snapshot of every thread's totals */
+typedef struct {
+    uint64_t bytes;
+    uint64_t messages;
+} TsValue;
+
+static TsCounter *counters;
+static int ts_threads;
+static int ts_interval_ms;
+static const char *ts_path;
+
+static uint64_t *sample_ns;         // Sample times
+static TsValue *sample_values;      // [sample * ts_threads + thread]
+static int num_samples, cap_samples;
+
+static pthread_t sampler;
+static pthread_mutex_t stop_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t stop_cond;
+static int stopping;
+
+/* take_sample: Appends a snapshot of all counters (sampler thread only) */
+static void take_sample(void) {
+    if (num_samples == cap_samples) {
+        int cap = cap_samples ? cap_samples * 2 : 256;
+        uint64_t *ns = realloc(sample_ns, cap * sizeof(uint64_t));
+        if (ns) sample_ns = ns;
+        TsValue *values = realloc(sample_values, (size_t)cap * ts_threads * sizeof(TsValue));
+        if (values) sample_values = values;
+        if (!ns || !values) return;     // Keep the samples taken so far
+        cap_samples = cap;
+    }
+    TsValue *row = &sample_values[(size_t)num_samples * ts_threads];
+    for (int i = 0; i < ts_threads; i++) {
+        row[i].bytes = __atomic_load_n(&counters[i].bytes, __ATOMIC_RELAXED);
+        row[i].messages = __atomic_load_n(&counters[i].messages, __ATOMIC_RELAXED);
+    }
+    sample_ns[num_samples++] = monotonic_ns();
+}
+
+static void* sampler_main(void *arg) {
+    (void)arg;
+    struct timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    pthread_mutex_lock(&stop_lock);
+    take_sample();
+    while (!stopping) {
+        next.tv_nsec += (long)(ts_interval_ms % 1000) * 1000000L;
+        next.tv_sec += ts_interval_ms / 1000 + next.tv_nsec / 1000000000L;
+        next.tv_nsec %= 1000000000L;
+        // Sleeps to the interval boundary, or until the run stops
+        int rc = 0;
+        while (!stopping && rc != ETIMEDOUT) {
+            rc = pthread_cond_timedwait(&stop_cond, &stop_lock, &next);
+        }
+        if (!stopping) take_sample();
+    }
+    take_sample();      // Final, partial interval
+    pthread_mutex_unlock(&stop_lock);
+    return NULL;
+}
+
+int timeseries_start(const char *path, int interval_ms, int num_threads) {
+    ts_path = path;
+    ts_interval_ms = interval_ms > 0 ? interval_ms : TS_DEFAULT_INTERVAL_MS;
+    ts_threads = num_threads;
+    counters = aligned_alloc(TS_CACHELINE, (size_t)num_threads * sizeof(TsCounter));
+    if (!counters) {
+        perror("Time-series counter allocation failed");
+        return -1;
+    }
+    memset(counters, 0, (size_t)num_threads * sizeof(TsCounter));
+
+    // The deadlines above are CLOCK_MONOTONIC, like the sample times
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&stop_cond, &attr);
+    pthread_condattr_destroy(&attr);
+
+    if (pthread_create(&sampler, NULL, sampler_main, NULL) != 0) {
+        perror("Sampler thread creation failed");
+        free(counters);
+        counters = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+TsCounter* timeseries_counter(int index) {
+    return &counters[index];
+}
+
+/* Totals of all threads at sample 's' */
+static TsValue sample_total(int s) {
+    TsValue total = {0, 0};
+    for (int i = 0; i < ts_threads; i++) {
+        total.bytes += sample_values[(size_t)s * ts_threads + i].bytes;
+        total.messages += sample_values[(size_t)s * ts_threads + i].messages;
+    }
+    return total;
+}
+
+static int compare_double(const void *a, const void *b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/*
+ * write_csv: One row per interval and thread plus an "all" row, tagged
+ * with the phase it was assigned to
+ */
+static void write_csv(const double *rates, int warm, int end) {
+    FILE *f = fopen(ts_path, "w");
+    if (!f) {
+        perror("Time-series file open failed");
+        return;
+    }
+    fprintf(f, "time_s,thread,bytes,messages,gbps,msgs_per_s,phase\n");
+    for (int k = 0; k + 1 < num_samples; k++) {
+        double t = (sample_ns[k + 1] - sample_ns[0]) / 1e9;
+        double dt = (sample_ns[k + 1] - sample_ns[k]) / 1e9;
+        const char *phase = k < warm ? "warmup" : k <= end ? "steady" : "tail";
+        for (int i = 0; i < ts_threads; i++) {
+            const TsValue *a = &sample_values[(size_t)k * ts_threads + i];
+            const TsValue *b = &sample_values[(size_t)(k + 1) * ts_threads + i];
+            uint64_t bytes = b->bytes - a->bytes, msgs = b->messages - a->messages;
+            fprintf(f, "%.3f,%d,%lu,%lu,%.6f,%.1f,%s\n", t, i + 1, (unsigned long)bytes,
+                    (unsigned long)msgs, bytes * 8.0 / (dt * 1e9), msgs / dt, phase);
+        }
+        TsValue a = sample_total(k), b = sample_total(k + 1);
+        fprintf(f, "%.3f,all,%lu,%lu,%.6f,%.1f,%s\n", t, (unsigned long)(b.bytes - a.bytes),
+                (unsigned long)(b.messages - a.messages), rates[k] * 8.0 / 1e9,
+                (b.messages - a.messages) / dt, phase);
+    }
+    fclose(f);
+}
+
+void timeseries_stop(TsSummary *out) {
+    memset(out, 0, sizeof(*out));
+    if (!counters) return;
+    pthread_mutex_lock(&stop_lock);
+    stopping = 1;
+    pthread_cond_signal(&stop_cond);
+    pthread_mutex_unlock(&stop_lock);
+    pthread_join(sampler, NULL);
+
+    int n = num_samples - 1;    // Intervals
+    double *rates = n > 0 ? calloc(n, sizeof(double)) : NULL;
+    double *sorted = n > 0 ? calloc(n, sizeof(double)) : NULL;
+    int first = -1, last = -1;
+    for (int k = 0; rates && sorted && k < n; k++) {
+        double dt = (sample_ns[k + 1] - sample_ns[k]) / 1e9;
+        uint64_t bytes = sample_total(k + 1).bytes - sample_total(k).bytes;
+        rates[k] = dt > 0 ? bytes / dt : 0.0;  // Bytes per second
+        if (bytes) {
+            if (first < 0) first = k;
+            last = k;
+        }
+    }
+    out->samples = n > 0 ? n : 0;
+    if (first < 0) {
+        if (rates && ts_path) write_csv(rates, n, n - 1);
+        free(rates);
+        free(sorted);
+        return;
+    }
+
+    // The last interval with data was cut short by the end of the run
+    int end = last - first >= 2 ? last - 1 : last;
+    int m = end - first + 1;
+    int warm = first;
+    if (m >= 4) {
+        int half = first + m / 2;
+        int count = end - half + 1;
+        memcpy(sorted, rates + half, count * sizeof(double));
+        qsort(sorted, count, sizeof(double), compare_double);
+        double reference = count % 2 ? sorted[count / 2]
+                                     : (sorted[count / 2 - 1] + sorted[count / 2]) / 2;
+        int window = (TS_STEADY_WINDOW_MS + ts_interval_ms - 1) / ts_interval_ms;
+        warm = half;
+        for (int i = first; i < half; i++) {
+            double sum = 0;
+            int w = 0;
+            for (int j = i; j <= end && w < window; j++, w++) sum += rates[j];
+            if (fabs(sum / w - reference) <= TS_TOLERANCE * reference) {
+                warm = i;
+                break;
+            }
+        }
+    }
+
+    uint64_t bytes = sample_total(end + 1).bytes - sample_total(warm).bytes;
+    uint64_t msgs = sample_total(end + 1).messages - sample_total(warm).messages;
+    double span = (sample_ns[end + 1] - sample_ns[warm]) / 1e9;
+    double mean = 0, var = 0;
+    for (int k = warm; k <= end; k++) mean += rates[k];
+    mean /= end - warm + 1;
+    for (int k = warm; k <= end; k++) var += (rates[k] - mean) * (rates[k] - mean);
+    var /= end - warm + 1;
+
+    out->warmup_samples = warm;
+    out->steady_samples = end - warm + 1;
+    out->warmup_s = (sample_ns[warm] - sample_ns[0]) / 1e9;
+    out->steady_gbps = span > 0 ? bytes * 8.0 / (span * 1e9) : 0.0;
+    out->steady_msgs_per_s = span > 0 ? msgs / span : 0.0;
+    out->steady_cv = mean > 0 ? sqrt(var) / mean : 0.0;
+
+    if (ts_path) write_csv(rates, warm, end);
+    free(rates);
+    free(sorted);
+}
+
+void timeseries_format_metrics(const TsSummary *s, char *buf, size_t len) {
+    snprintf(buf, len, "warmup_s=%.2f steady_gbps=%.6f steady_msg_rate=%.1f steady_cv=%.3f",
+             s->warmup_s, s->steady_gbps, s->steady_msgs_per_s, s->steady_cv);
+}
@@ -0,0 +1,81 @@
+/*
+ * Per-interval throughput time series shared by all clients.
+ *
+ * A run's single aggregate (bytes / run_duration) averages in connection
+ * setup, TCP slow start and allocator warm-up, which for small messages
+ * is a visible share of a 30 s run. Each client thread instead bumps its
+ * own cache-line-padded counter after every message, and a sampler thread
+ * snapshots all counters every --interval milliseconds:
+ *
+ *   receive threads:  ts_record(counter, bytes)  (two relaxed stores)
+ *   sampler thread:   every interval, read all counters -> one sample row
+ *
+ * When the run ends the warm-up is detected from the samples and dropped
+ * (see timeseries_stop), and the rest gives the steady-state averages for
+ * the METRICS line. With --timeseries=FILE every sample is also written
+ * out, per thread and in total, after the run, so no file I/O happens
+ * while measuring.
+ */
+
+#ifndef MT25190_TIMESERIES_H
+#define MT25190_TIMESERIES_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define TS_CACHELINE 64
+#define TS_DEFAULT_INTERVAL_MS 100
+#define TS_TOLERANCE 0.10           // Steady: window mean within 10% of the reference rate
+#define TS_STEADY_WINDOW_MS 500     // ... over at least this many milliseconds of samples
+
+/* One receive thread's running totals (single writer, own cache line) */
+typedef struct {
+    _Alignas(TS_CACHELINE) uint64_t bytes;
+    uint64_t messages;
+} TsCounter;
+
+/* Steady-state summary of a run */
+typedef struct {
+    int samples;                // Intervals recorded (with data)
+    int warmup_samples;         // Leading intervals discarded as warm-up
+    int steady_samples;         // Intervals averaged
+    double warmup_s;            // Time from the first sample to the steady window
+    double steady_gbps;         // Throughput over the steady window
+    double steady_msgs_per_s;
+    double steady_cv;           // Coefficient of variation of the steady interval rates
+} TsSummary;
+
+/*
+ * timeseries_start: Allocates 'num_threads' counters and starts the
+ * sampler thread. 'path' (may be NULL) receives the samples as CSV when
+ * the run ends. Returns 0 on success, -1 on failure.
+ */
+int timeseries_start(const char *path, int interval_ms, int num_threads);
+
+/* timeseries_counter: Counter of thread 'index' (0-based) */
+TsCounter* timeseries_counter(int index);
+
+/* ts_record: One message of 'bytes' received (hot path) */
+static inline void ts_record(TsCounter *c, uint64_t bytes) {
+    __atomic_store_n(&c->bytes, c->bytes + bytes, __ATOMIC_RELAXED);
+    __atomic_store_n(&c->messages, c->messages + 1, __ATOMIC_RELAXED);
+}
+
+/*
+ * timeseries_stop: Takes a final sample, stops the sampler, finds the
+ * warm-up and fills 'out'; writes the CSV if a path was given. Call after
+ * every receive thread has been joined.
+ *
+ * Warm-up detection: intervals before the first byte and the last interval
+ * (cut short by the end of the run) never count. The reference rate is the
+ * median interval rate of the second half of the remaining samples; the
+ * warm-up ends at the first interval from which the mean rate of the next
+ * TS_STEADY_WINDOW_MS is within TS_TOLERANCE of it, and at the latest
+ * half-way through the run.
+ */
+void timeseries_stop(TsSummary *out);
+
+/* timeseries_format_metrics: "warmup_s=.. steady_gbps=.. steady_msg_rate=.. steady_cv=.." */
+void timeseries_format_metrics(const TsSummary *s, char *buf, size_t len);
+
+#endif /* MT25190_TIMESERIES_H */
@@ -0,0 +1,154 @@
+/*
+ * Strategy tables and the shared recv() receive path.
+ * See MT25190_Transport.h.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/socket.h>
+
+#include "MT25190_Transport.h"
+#include "MT25190_BusyPoll.h"
+#include "MT25190_Checksum.h"
+
+static const ServerTransport *const server_transports[] = {
+    &two_copy_server, &one_copy_server, &zero_copy_server, &sendfile_server, &hybrid_server
+};
+
+static const ClientTransport *const client_transports[] = {
+    &two_copy_client, &one_copy_client, &zero_copy_client, &sendfile_client, &hybrid_client
+};
+
+#define NUM_TRANSPORTS (sizeof(server_transports) / sizeof(server_transports[0]))
+
+const ServerTransport* find_server_transport(const char *name) {
+    for (size_t i = 0; i < NUM_TRANSPORTS; i++) {
+        if (strcmp(server_transports[i]->name, name) == 0) return server_transports[i];
+    }
+    return NULL;
+}
+
+const ClientTransport* find_client_transport(const char *name) {
+    for (size_t i = 0; i < NUM_TRANSPORTS; i++) {
+        if (strcmp(client_transports[i]->name, name) == 0) return client_transports[i];
+    }
+    return NULL;
+}
+
+const char* transport_mode_list(void) {
+    static char list[128];
+    if (!list[0]) {
+        size_t used = 0;
+        for (size_t i = 0; i < NUM_TRANSPORTS && used < sizeof(list); i++) {
+            used += (size_t)snprintf(list + used, sizeof(list) - used, "%s%s",
+                                     i ? "|" : "", server_transports[i]->name);
+        }
+    }
+    return list;
+}
+
+const char* scan_mode_option(int argc, char *argv[]) {
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--mode=", 7) == 0) return argv[i] + 7;
+        if (strcmp(argv[i], "--mode") == 0 && i + 1 < argc) return argv[i + 1];
+    }
+    return NULL;
+}
+
+#define MAX_OPTIONS 32
+
+const struct option* merge_options(const struct option *common, const struct option *extra) {
+    static struct option merged[MAX_OPTIONS];
+    int n = 0;
+    for (const struct option *o = common; o->name && n < MAX_OPTIONS - 1; o++) merged[n++] = *o;
+    for (const struct option *o = extra; o && o->name && n < MAX_OPTIONS - 1; o++) merged[n++] = *o;
+    memset(&merged[n], 0, sizeof(merged[n]));
+    return merged;
+}
+
+/*
+ * recv_copy_frame: Receives one whole frame using the TWO-COPY model
+ *
+ * RECEIVE PATH - TWO COPIES:
+ * 1. COPY 1: NIC → Kernel
+ *    - NIC receives packet from network
+ *    - DMA controller copies packet data to kernel ring buffer (sk_buff)
+ *    - Interrupt notifies kernel of new data
+ *
+ * 2. COPY 2: Kernel → User
+ *    - recv() syscall copies data from kernel socket buffer to user-space buffer
+ *    - This requires CPU involvement and context switch
+ *    - Data is copied from kernel memory to user-provided buffer
+ */
+ssize_t recv_copy_frame(int sockfd, void *state, FrameAssembler *fa) {
+    char *buffer = (char*)state;
+    while (1) {
+        // recv() triggers COPY 2: Kernel socket buffer → User buffer
+        // Bytes land at their final offset in the frame; recv never reads
+        // past the current frame once its header has arrived
+        ssize_t bytes_received = recv_spin(sockfd, buffer + fa->filled, frame_want(fa), 0,
+                                           busy_poll_usec >= 0);
+
+        if (bytes_received < 0) {
+            if (errno == EINTR) continue;  // Interrupted, retry
+            return -1;  // Error
+        }
+        if (bytes_received == 0) {
+            return 0;  // Connection closed
+        }
+
+        int r = frame_received(fa, buffer, (size_t)bytes_received);
+        if (r == FRAME_COMPLETE) return 1;
+        if (r == FRAME_INVALID) {
+            errno = EPROTO;     // Stream desynchronised (e.g. message_size mismatch)
+            return -1;
+        }
+    }
+}
+
+void* recv_copy_open(int sockfd, size_t frame_bytes) {
+    (void)sockfd;
+    // Receive buffer in user space (one whole frame)
+    char *buffer = aligned_alloc(4096, (frame_bytes + 4095) & ~(size_t)4095);
+    if (!buffer) perror("Buffer allocation failed");
+    return buffer;
+}
+
+int recv_copy_visit_payload(void *state, const FrameAssembler *fa, PayloadSink sink, void *ctx) {
+    char *buffer = (char*)state;
+    sink(ctx, 0, buffer + sizeof(FrameHeader), frame_header(fa)->length - sizeof(FrameHeader));
+    return 1;
+}
+
+void fields_visit_payload(char *const fields[], size_t field_size, size_t length,
+                          PayloadSink sink, void *ctx) {
+    size_t offset = sizeof(FrameHeader);
+    for (int i = 0; offset < length; i++) {
+        size_t end = (size_t)(i + 1) * field_size;
+        if (end > length) end = length;
+        if (offset < end) {
+            sink(ctx, offset - sizeof(FrameHeader), fields[i] + (offset - (size_t)i * field_size),
+                 end - offset);
+            offset = end;
+        }
+    }
+}
+
+/* crc_sink: PayloadSink chaining a CRC32C over the pieces */
+static void crc_sink(void *ctx, size_t offset, const void *data, size_t len) {
+    (void)offset;
+    uint32_t *crc = (uint32_t*)ctx;
+    *crc = crc32c(*crc, data, len);
+}
+
+uint32_t fields_payload_crc(char *const fields[], size_t field_size, size_t length) {
+    uint32_t crc = 0;
+    fields_visit_payload(fields, field_size, length, crc_sink, &crc);
+    return crc;
+}
+
+void recv_copy_close(void *state) {
+    free(state);
+}
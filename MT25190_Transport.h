@@ -0,0 +1,214 @@
+/*
+ * Pluggable copy strategies for the unified TCP server and client.
+ *
+ * MT25190_Server.c and MT25190_Client.c own everything that is the same
+ * for every strategy: argument parsing, socket setup, signal handling,
+ * the thread/epoll/reuseport engines, ping-pong, busy polling, placement,
+ * per-message statistics and the METRICS line. A strategy only supplies
+ * how one message leaves the server and how one frame enters the client:
+ *
+ *   --mode       server send path                     client receive path
+ *   two-copy     send() per field (A1)                recv() into one buffer
+ *   one-copy     sendmsg() over 8 iovecs (A2)         recvmsg() into 8 buffers
+ *   zero-copy    MSG_ZEROCOPY from pinned ring (A3)   recv() or --zc-recv mmap
+ *   sendfile     sendfile()/splice() from memfd (A5)  recv() into one buffer
+ *   hybrid       copy, iovec or MSG_ZEROCOPY chosen   recv() of the header, then
+ *                per message by size (A8)             the rest of the frame
+ *
+ * A new strategy is one MT25190_Transport_*.c file defining a
+ * ServerTransport and a ClientTransport, plus an entry in the tables in
+ * MT25190_Transport.c; it is then measured by exactly the same code as
+ * the others.
+ */
+
+#ifndef MT25190_TRANSPORT_H
+#define MT25190_TRANSPORT_H
+
+#include <signal.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <getopt.h>
+#include <sys/types.h>
+
+#include "MT25190_EventLoop.h"
+#include "MT25190_Framing.h"
+#include "MT25190_Histogram.h"   // monotonic_ns()
+
+#define NUM_FIELDS 8
+
+/* Shared run configuration, defined by the server and client mains */
+extern int message_size;                // Bytes per field
+extern int pingpong;                    // One response per client request (--pingpong)
+extern int busy_poll_usec;              // >= 0: spin-receive, SO_BUSY_POLL budget (--busy-poll)
+extern int frame_checksum;              // Server: seal payload CRC32C (--checksum); client: verify (--verify)
+extern volatile sig_atomic_t running;   // Cleared on shutdown / end of run
+
+typedef struct {
+    const char *name;           // --mode value
+    const char *part;           // Assignment part ("A1") for banners and CSV labels
+    const char *title;          // "Two-Copy"
+    int default_port;
+
+    /* Mode-specific flags: getopt_long table (zero-terminated) and handler */
+    const struct option *options;
+    int (*parse_option)(int opt_char, const char *arg);     // 0 ok, -1 invalid
+    const char *usage;          // "[--depth=K]" for the usage line
+
+    /* Optional: process-wide setup after parsing / teardown at exit */
+    int (*setup)(void);
+    void (*teardown)(void);
+
+    /* Optional: mode-specific banner lines */
+    void (*describe)(void);
+
+    /*
+     * Per-connection state and resumable sends for the epoll engines;
+     * conn_open/conn_close are also used by the thread engine.
+     * message_bytes is filled in by the server.
+     */
+    EventLoopOps ops;
+
+    /*
+     * Optional: called before waiting for the next ping-pong request, so
+     * a strategy can reserve a send buffer without holding up the reply
+     * (zero-copy waits for a ring slot here). Returns -1 to stop.
+     */
+    int (*prepare_message)(int sockfd, void *state);
+
+    /*
+     * Thread engine: stamps (seq, send_ns) into the frame header and sends
+     * one whole message on a blocking socket. Returns the bytes sent, or
+     * -1 with errno set.
+     */
+    int (*send_message)(int sockfd, void *state, uint64_t seq, uint64_t send_ns);
+    const char *send_error;     // perror() prefix for failed sends
+
+    /* Optional: extra per-connection statistics line (thread engine) */
+    void (*conn_report)(void *state);
+
+    /*
+     * Optional: process totals appended to the SERVER_METRICS line at
+     * shutdown, as "key=value" fields. Returns the formatted length.
+     */
+    int (*format_metrics)(char *buf, size_t len);
+} ServerTransport;
+
+typedef struct {
+    const char *name;           // --mode value (same names as the server)
+    const char *part;
+    const char *title;
+    int default_port;
+
+    const struct option *options;
+    int (*parse_option)(int opt_char, const char *arg);
+    const char *usage;
+
+    void (*describe)(void);
+
+    /* Per-connection receive buffers for one frame of 'frame_bytes'. NULL on failure */
+    void *(*conn_open)(int sockfd, size_t frame_bytes);
+
+    /*
+     * Receives until one whole frame is in (header in frame_header(fa)).
+     * Returns 1 when complete, 0 if the server closed, -1 on error.
+     */
+    ssize_t (*receive_frame)(int sockfd, void *state, FrameAssembler *fa);
+
+    /*
+     * Optional: bytes that were mapped (not copied) / copied into user
+     * space. Returns 0 (or is NULL) when everything received was copied.
+     */
+    int (*rx_counters)(void *state, long *mapped, long *copied);
+
+    /*
+     * --verify / --consume: hands the payload of the frame just completed
+     * to 'sink' where it was received, piece by piece in stream order.
+     * Returns 0 without calling it when the payload was already delivered
+     * to fa->sink while it was parsed in place (frame_consume()).
+     */
+    int (*visit_payload)(void *state, const FrameAssembler *fa, PayloadSink sink, void *ctx);
+
+    void (*conn_close)(void *state);
+} ClientTransport;
+
+/*
+ * find_server_transport / find_client_transport: Strategy for a --mode
+ * name, or NULL. transport_mode_list: "two-copy|one-copy|..." for usage.
+ */
+const ServerTransport* find_server_transport(const char *name);
+const ClientTransport* find_client_transport(const char *name);
+const char* transport_mode_list(void);
+
+/*
+ * scan_mode_option: Finds "--mode=NAME" / "--mode NAME" in argv before
+ * getopt_long runs, so the selected strategy's flags can be registered.
+ * Returns NULL when absent.
+ */
+const char* scan_mode_option(int argc, char *argv[]);
+
+/*
+ * merge_options: getopt_long table of 'common' followed by the strategy's
+ * 'extra' flags (may be NULL). Static storage: call once per process.
+ */
+const struct option* merge_options(const struct option *common, const struct option *extra);
+
+/*
+ * Plain recv() receive path shared by the two-copy, zero-copy and sendfile
+ * clients: one frame-sized buffer, bytes land at their final offset.
+ */
+void* recv_copy_open(int sockfd, size_t frame_bytes);
+ssize_t recv_copy_frame(int sockfd, void *state, FrameAssembler *fa);
+int recv_copy_visit_payload(void *state, const FrameAssembler *fa, PayloadSink sink, void *ctx);
+void recv_copy_close(void *state);
+
+/*
+ * fields_visit_payload: Passes the payload of a frame of 'length' bytes
+ * laid out over buffers of 'field_size' bytes (header at the start of
+ * fields[0]) to 'sink', one piece per buffer.
+ * fields_payload_crc: Its CRC32C, for servers sealing frames.
+ */
+void fields_visit_payload(char *const fields[], size_t field_size, size_t length,
+                          PayloadSink sink, void *ctx);
+uint32_t fields_payload_crc(char *const fields[], size_t field_size, size_t length);
+
+/*
+ * MSG_ZEROCOPY ring of 'depth' pinned send buffers of 'size' bytes
+ * (MT25190_Transport_ZeroCopy.c), shared with strategies that send only
+ * some of their messages with MSG_ZEROCOPY.
+ *
+ * zc_ring_open: Enables SO_ZEROCOPY (copying fallback without it) and
+ * allocates the ring. NULL on failure.
+ * zc_ring_claim: Buffer of a slot no in-flight send references, kept for
+ * the current message until it is sent (repeat calls return the same one).
+ * 'block' = 1 waits for completions, NULL only on shutdown (errno EINTR);
+ * 'block' = 0 returns NULL with errno ENOBUFS when every slot is busy.
+ * zc_ring_send: Sends the first 'len' bytes of the claimed slot on a
+ * blocking socket. Returns the bytes sent, or -1 with errno set.
+ * zc_ring_send_from: One send of bytes [offset, len) of the claimed slot
+ * (epoll engine); the slot is released once byte 'len' is out.
+ * zc_ring_drain: Harvests error-queue completions without blocking.
+ * zc_ring_close: Waits (bounded) for outstanding completions and frees.
+ * zc_ring_format: One-line summary of the completions (sends, bytes,
+ * copied fallbacks, effective zero-copy share, completion latency).
+ * zc_format_metrics: The same totals over every closed ring, as
+ * SERVER_METRICS "key=value" fields; zc_reset_metrics drops them (after
+ * a startup self-benchmark).
+ */
+typedef struct ZeroCopyRing ZeroCopyRing;
+ZeroCopyRing* zc_ring_open(int sockfd, size_t size, int depth);
+char* zc_ring_claim(int sockfd, ZeroCopyRing *ring, int block);
+int zc_ring_send(int sockfd, ZeroCopyRing *ring, size_t len);
+ssize_t zc_ring_send_from(int sockfd, ZeroCopyRing *ring, size_t offset, size_t len);
+void zc_ring_drain(int sockfd, ZeroCopyRing *ring);
+void zc_ring_close(int sockfd, ZeroCopyRing *ring);
+int zc_ring_format(const ZeroCopyRing *ring, char *buf, size_t len);
+int zc_format_metrics(char *buf, size_t len);
+void zc_reset_metrics(void);
+
+/* Strategies (MT25190_Transport_*.c) */
+extern const ServerTransport two_copy_server, one_copy_server, zero_copy_server, sendfile_server,
+                             hybrid_server;
+extern const ClientTransport two_copy_client, one_copy_client, zero_copy_client, sendfile_client,
+                             hybrid_client;
+
+#endif /* MT25190_TRANSPORT_H */
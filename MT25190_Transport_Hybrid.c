@@ -0,0 +1,584 @@
+/*
+ * HYBRID strategy (--mode=hybrid, Part A8)
+ * Server: picks the send path per message from its size
+ *
+ *   frame bytes          path                                  (as in)
+ *   <= copy_max          send() from one contiguous buffer     A1
+ *   <= iovec_max         sendmsg() over the 8 field buffers    A2
+ *   larger               MSG_ZEROCOPY from the pinned ring     A3
+ *
+ * Small frames are copied: MSG_ZEROCOPY pins the pages and costs an
+ * error-queue completion per send, which outweighs copying a few KB.
+ *
+ * The size table is static (--thresholds=COPY_MAX:IOVEC_MAX, in frame
+ * bytes) or measured at startup (--calibrate[=MS]): copy and iovec stream
+ * each power-of-two frame size over a loopback connection for MS
+ * milliseconds and the faster one takes that size, unless the path of
+ * the size below is within CALIBRATE_MARGIN of it. Zero-copy is not
+ * measured: loopback always falls back to a deferred copy, so it would
+ * never win there. Frames above the static IOVEC_MAX keep MSG_ZEROCOPY.
+ *
+ * --min-size=BYTES mixes message sizes: every frame gets a length drawn
+ * log-uniformly between BYTES and the full frame (8 * message_size), so
+ * one connection exercises all three paths.
+ *
+ * Client: recv() copy that reads the frame header first, since frames
+ * are no longer all the same length
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <errno.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "MT25190_Transport.h"
+#include "MT25190_BusyPoll.h"
+#include "MT25190_Checksum.h"
+#include "MT25190_ServerStats.h"
+
+#define DEFAULT_COPY_MAX 4096       // Frames up to 4 KB: plain copy
+#define DEFAULT_IOVEC_MAX 16384     // Up to 16 KB: iovec; MSG_ZEROCOPY beyond
+#define DEFAULT_HYBRID_DEPTH 16     // Pinned zero-copy slots per connection
+#define DEFAULT_CALIBRATE_MS 20     // Per frame size and path
+#define CALIBRATE_MIN_BYTES 64
+#define CALIBRATE_MARGIN 0.10       // A new path must beat the previous size's by 10%
+#define MAX_POLICY 32
+
+enum { PATH_COPY, PATH_IOVEC, PATH_ZEROCOPY, NUM_PATHS };
+static const char *const path_names[NUM_PATHS] = { "copy", "iovec", "zerocopy" };
+
+/* Send policy: the first entry whose 'upto' covers the frame length wins */
+typedef struct {
+    size_t upto;            // Largest frame (bytes) of this entry; SIZE_MAX for the last
+    int path;               // PATH_*
+} PolicyEntry;
+
+static PolicyEntry policy[MAX_POLICY] = {
+    { DEFAULT_COPY_MAX, PATH_COPY },
+    { DEFAULT_IOVEC_MAX, PATH_IOVEC },
+    { SIZE_MAX, PATH_ZEROCOPY },
+};
+static int policy_len = 3;
+static int calibrate_ms = 0;        // > 0: measure the table at startup (--calibrate)
+static size_t min_frame = 0;        // > 0: log-uniform frame sizes from here (--min-size)
+static int hybrid_depth = DEFAULT_HYBRID_DEPTH;
+
+static size_t max_frame_bytes(void) {
+    return (size_t)message_size * NUM_FIELDS;
+}
+
+static int choose_path(size_t len) {
+    for (int i = 0; i < policy_len; i++) {
+        if (len <= policy[i].upto) return policy[i].path;
+    }
+    return PATH_ZEROCOPY;
+}
+
+/*
+ * Per-connection state: one buffer set per path, all holding a full frame
+ */
+typedef struct {
+    char *flat;                     // Contiguous frame (copy path)
+    char *fields[NUM_FIELDS];       // message_size bytes each (iovec path)
+    ZeroCopyRing *ring;             // Pinned slots (zero-copy path)
+    uint32_t rng;                   // xorshift32 state for --min-size
+    size_t len;                     // Current message: frame bytes (0 = none chosen yet)
+    int path;                       // Current message: PATH_*
+    uint64_t seq;                   // Current message: sequence number (epoll engine)
+    long messages[NUM_PATHS];
+    long long bytes[NUM_PATHS];
+} HybridConn;
+
+/* next_length: Frame bytes of the next message */
+static size_t next_length(HybridConn *c) {
+    size_t max = max_frame_bytes();
+    if (min_frame == 0 || min_frame >= max) return max;
+    c->rng ^= c->rng << 13;
+    c->rng ^= c->rng >> 17;
+    c->rng ^= c->rng << 5;
+    double u = c->rng / 4294967296.0;
+    size_t len = (size_t)exp(log((double)min_frame) + u * (log((double)max) - log((double)min_frame)));
+    return len < min_frame ? min_frame : len > max ? max : len;
+}
+
+/* pick_message: Chooses the next message's length and send path */
+static void pick_message(HybridConn *c) {
+    c->len = next_length(c);
+    c->path = choose_path(c->len);
+    c->messages[c->path]++;
+    c->bytes[c->path] += (long long)c->len;
+}
+
+/*
+ * stamp_frame: Header (and --checksum seal) of the current message at
+ * 'frame'. The payload CRC depends on the length, so it is computed per
+ * message here rather than once per buffer.
+ */
+static void stamp_frame(HybridConn *c, char *frame, uint64_t seq, uint64_t send_ns) {
+    frame_stamp(frame, (uint32_t)c->len, seq, send_ns);
+    if (!frame_checksum) return;
+    uint32_t crc = c->path == PATH_IOVEC
+                 ? fields_payload_crc(c->fields, (size_t)message_size, c->len)
+                 : crc32c(0, frame + sizeof(FrameHeader), c->len - sizeof(FrameHeader));
+    frame_seal(frame, crc);
+}
+
+/*
+ * fields_view: iovecs over bytes [offset, len) of the frame scattered
+ * across the field buffers. Returns the number of entries.
+ */
+static int fields_view(HybridConn *c, size_t offset, size_t len, struct iovec *iov) {
+    int n = 0;
+    for (int i = 0; i < NUM_FIELDS && offset < len; i++) {
+        size_t start = (size_t)i * message_size;
+        size_t end = start + message_size < len ? start + message_size : len;
+        if (offset >= end) continue;
+        iov[n].iov_base = c->fields[i] + (offset - start);
+        iov[n].iov_len = end - offset;
+        n++;
+        offset = end;
+    }
+    return n;
+}
+
+/*
+ * send_path_from: One send syscall for bytes [offset, len) of the current
+ * message on its path. The zero-copy slot must already be claimed.
+ */
+static ssize_t send_path_from(int sockfd, HybridConn *c, size_t offset) {
+    size_t want = c->len - offset;
+    if (c->path == PATH_COPY) {
+        return stats_sent(send(sockfd, c->flat + offset, want, 0), want);   // USER → KERNEL copy
+    }
+    if (c->path == PATH_IOVEC) {
+        struct iovec iov[NUM_FIELDS];
+        struct msghdr msgh;
+        memset(&msgh, 0, sizeof(msgh));
+        msgh.msg_iov = iov;
+        msgh.msg_iovlen = fields_view(c, offset, c->len, iov);
+        return stats_sent(sendmsg(sockfd, &msgh, 0), want);
+    }
+    return zc_ring_send_from(sockfd, c->ring, offset, c->len);
+}
+
+/*
+ * prepare_hybrid: Chooses the next message and, for MSG_ZEROCOPY, claims
+ * its pinned slot before the request arrives or the send time is taken
+ */
+static int prepare_hybrid(int sockfd, void *state) {
+    HybridConn *c = (HybridConn*)state;
+    if (c->len == 0) pick_message(c);
+    if (c->path == PATH_ZEROCOPY && !zc_ring_claim(sockfd, c->ring, 1)) return -1;
+    return 0;
+}
+
+/*
+ * send_message_hybrid: Sends one whole message on the path its size
+ * selects (blocking socket, thread engine)
+ */
+static int send_message_hybrid(int sockfd, void *state, uint64_t seq, uint64_t send_ns) {
+    HybridConn *c = (HybridConn*)state;
+    if (prepare_hybrid(sockfd, c) < 0) return -1;
+    size_t len = c->len;
+    int ret;
+
+    if (c->path == PATH_ZEROCOPY) {
+        // The claimed slot is no longer referenced by the kernel
+        stamp_frame(c, zc_ring_claim(sockfd, c->ring, 1), seq, send_ns);
+        ret = zc_ring_send(sockfd, c->ring, len);
+    } else {
+        stamp_frame(c, c->path == PATH_COPY ? c->flat : c->fields[0], seq, send_ns);
+        size_t offset = 0;
+        ret = 0;
+        while (offset < len) {
+            ssize_t sent = send_path_from(sockfd, c, offset);
+            if (sent < 0) {
+                if (errno == EINTR && running) continue;
+                ret = -1;
+                break;
+            }
+            offset += (size_t)sent;
+        }
+        if (ret == 0) ret = (int)offset;
+    }
+    c->len = 0;     // The next call chooses a new message
+    return ret;
+}
+
+/*
+ * begin_message_hybrid: Chooses message 'seq' for the epoll engine; copy
+ * and iovec frames are stamped now, a zero-copy frame once send_from
+ * claimed its slot
+ */
+static void begin_message_hybrid(void *state, uint64_t seq) {
+    HybridConn *c = (HybridConn*)state;
+    pick_message(c);
+    c->seq = seq;
+    if (c->path != PATH_ZEROCOPY) {
+        stamp_frame(c, c->path == PATH_COPY ? c->flat : c->fields[0], seq, monotonic_ns());
+    }
+}
+
+/*
+ * send_from_hybrid: Resumable send for the epoll engine. Returns ENOBUFS
+ * while every zero-copy slot is in flight, so the event loop waits for
+ * error-queue completions.
+ */
+static ssize_t send_from_hybrid(int sockfd, void *state, size_t offset) {
+    HybridConn *c = (HybridConn*)state;
+    if (c->path == PATH_ZEROCOPY && offset == 0) {
+        char *frame = zc_ring_claim(sockfd, c->ring, 0);
+        if (!frame) return -1;
+        stamp_frame(c, frame, c->seq, monotonic_ns());
+    }
+    return send_path_from(sockfd, c, offset);
+}
+
+static size_t message_length_hybrid(void *state) {
+    return ((HybridConn*)state)->len;
+}
+
+static void conn_close_hybrid(int sockfd, void *state) {
+    HybridConn *c = (HybridConn*)state;
+    if (!c) return;
+    if (c->ring) zc_ring_close(sockfd, c->ring);
+    for (int i = 0; i < NUM_FIELDS; i++) free(c->fields[i]);
+    free(c->flat);
+    free(c);
+}
+
+static void* conn_open_hybrid(int sockfd) {
+    size_t max = max_frame_bytes();
+    HybridConn *c = calloc(1, sizeof(HybridConn));
+    if (!c) {
+        perror("Failed to allocate hybrid connection");
+        return NULL;
+    }
+    c->rng = (uint32_t)sockfd * 2654435761u | 1;
+    c->flat = aligned_alloc(4096, (max + 4095) & ~(size_t)4095);
+    int ok = c->flat != NULL;
+    for (int i = 0; ok && i < NUM_FIELDS; i++) {
+        c->fields[i] = aligned_alloc(4096, ((size_t)message_size + 4095) & ~(size_t)4095);
+        ok = c->fields[i] != NULL;
+        if (ok) memset(c->fields[i], 'A' + i, message_size);
+    }
+    if (ok) {
+        memset(c->flat, 'C', max);
+        c->ring = zc_ring_open(sockfd, max, hybrid_depth);
+        ok = c->ring != NULL;
+    }
+    if (!ok) {
+        perror("Failed to allocate hybrid send buffers");
+        conn_close_hybrid(sockfd, c);
+        return NULL;
+    }
+    return c;
+}
+
+static void drain_errqueue_hybrid(int sockfd, void *state) {
+    zc_ring_drain(sockfd, ((HybridConn*)state)->ring);
+}
+
+static void conn_report_hybrid(void *state) {
+    HybridConn *c = (HybridConn*)state;
+    char summary[256];
+    zc_ring_format(c->ring, summary, sizeof(summary));
+    printf("[Thread %lu] Paths: copy %ld msgs (%.1f MB), iovec %ld (%.1f MB), "
+           "zerocopy %ld (%.1f MB)\n", pthread_self(),
+           c->messages[PATH_COPY], c->bytes[PATH_COPY] / 1e6,
+           c->messages[PATH_IOVEC], c->bytes[PATH_IOVEC] / 1e6,
+           c->messages[PATH_ZEROCOPY], c->bytes[PATH_ZEROCOPY] / 1e6);
+    printf("[Thread %lu] Zero-copy path: %s\n", pthread_self(), summary);
+}
+
+/* print_policy: One line per size range of the send policy */
+static void print_policy(void) {
+    size_t from = 0;
+    for (int i = 0; i < policy_len; i++) {
+        if (policy[i].upto == SIZE_MAX) {
+            printf("  frames >= %zu B: %s\n", from, path_names[policy[i].path]);
+        } else {
+            printf("  frames %zu..%zu B: %s\n", from, policy[i].upto, path_names[policy[i].path]);
+        }
+        from = policy[i].upto + 1;
+    }
+}
+
+/* calibration_drain: Reads and discards the calibration stream until EOF */
+static void* calibration_drain(void *arg) {
+    int fd = *(int*)arg;
+    size_t len = max_frame_bytes();
+    char *buf = malloc(len);
+    if (buf) {
+        while (recv(fd, buf, len, 0) > 0) {}
+        free(buf);
+    }
+    return NULL;
+}
+
+/*
+ * calibration_pair: Loopback TCP connection; returns the sending end and
+ * the receiving end in *rx, or -1
+ */
+static int calibration_pair(int *rx) {
+    struct sockaddr_in addr;
+    socklen_t addr_len = sizeof(addr);
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+
+    int ls = socket(AF_INET, SOCK_STREAM, 0);
+    if (ls < 0) return -1;
+    int tx = -1;
+    if (bind(ls, (struct sockaddr*)&addr, sizeof(addr)) == 0 && listen(ls, 1) == 0 &&
+        getsockname(ls, (struct sockaddr*)&addr, &addr_len) == 0) {
+        tx = socket(AF_INET, SOCK_STREAM, 0);
+        if (tx >= 0 && (connect(tx, (struct sockaddr*)&addr, sizeof(addr)) < 0 ||
+                        (*rx = accept(ls, NULL, NULL)) < 0)) {
+            close(tx);
+            tx = -1;
+        }
+    }
+    close(ls);
+    return tx;
+}
+
+/* time_path: Gbps that 'path' sustains with frames of 'len' bytes for calibrate_ms */
+static double time_path(int sockfd, HybridConn *c, int path, size_t len) {
+    uint64_t start = monotonic_ns();
+    uint64_t end = start + (uint64_t)calibrate_ms * 1000000ull;
+    uint64_t now, seq = 0;
+    double bytes = 0;
+    do {
+        c->len = len;       // Forced: prepare_hybrid keeps a chosen message
+        c->path = path;
+        if (send_message_hybrid(sockfd, c, seq++, monotonic_ns()) < 0) return 0;
+        bytes += (double)len;
+        now = monotonic_ns();
+    } while (now < end);
+    return bytes * 8.0 / (double)(now - start);
+}
+
+/*
+ * static_zerocopy_from: Largest frame the static table keeps off the
+ * zero-copy path (IOVEC_MAX); calibration leaves larger frames on it
+ */
+static size_t static_zerocopy_from(void) {
+    size_t from = 0;
+    for (int i = 0; i < policy_len; i++) {
+        if (policy[i].path == PATH_ZEROCOPY) return from;
+        from = policy[i].upto;
+    }
+    return SIZE_MAX;
+}
+
+/*
+ * calibrate_policy: Streams every power-of-two frame size (64 B up to the
+ * full frame) on the copy and iovec paths over loopback and keeps the
+ * faster one per size. Loopback zero-copy sends are always copied on
+ * delivery (SO_EE_CODE_ZEROCOPY_COPIED), so a loopback measurement only
+ * shows its pinning and completion overhead: frames above the static
+ * IOVEC_MAX stay on MSG_ZEROCOPY instead of being timed. The calibration
+ * traffic stays out of the live counters and the zero-copy totals.
+ */
+static int calibrate_policy(void) {
+    int rx = -1;
+    int tx = calibration_pair(&rx);
+    if (tx < 0) {
+        perror("Calibration connection failed");
+        return -1;
+    }
+    pthread_t drain;
+    if (pthread_create(&drain, NULL, calibration_drain, &rx) != 0) {
+        perror("Calibration thread creation failed");
+        close(tx);
+        close(rx);
+        return -1;
+    }
+    ServerStatsShm *saved_stats = server_stats;
+    server_stats = NULL;
+
+    HybridConn *c = conn_open_hybrid(tx);
+    size_t max = max_frame_bytes();
+    size_t zerocopy_from = static_zerocopy_from();
+    int n = 0;
+    printf("Calibrating send paths (%d ms per size and path):\n", calibrate_ms);
+    printf("  zerocopy is not measured on loopback (always copied on delivery): "
+           "frames > %zu B keep it from the static table\n", zerocopy_from);
+    for (size_t len = CALIBRATE_MIN_BYTES < max ? CALIBRATE_MIN_BYTES : max; c; len *= 2) {
+        if (len > max) len = max;
+        int best;
+        if (len > zerocopy_from) {
+            best = PATH_ZEROCOPY;
+            printf("  %8zu B: -> %s (static)\n", len, path_names[best]);
+            // The measured range below reaches exactly up to IOVEC_MAX
+            if (n > 0 && policy[n - 1].path != best) policy[n - 1].upto = zerocopy_from;
+        } else {
+            double gbps[PATH_ZEROCOPY];
+            best = PATH_COPY;
+            for (int path = 0; path < PATH_ZEROCOPY; path++) {
+                gbps[path] = time_path(tx, c, path, len);
+                if (gbps[path] > gbps[best]) best = path;
+            }
+            // Within the margin the previous range continues: no flapping on noise
+            if (n > 0 && gbps[policy[n - 1].path] * (1.0 + CALIBRATE_MARGIN) >= gbps[best]) {
+                best = policy[n - 1].path;
+            }
+            printf("  %8zu B: copy %.2f, iovec %.2f Gbps -> %s\n", len,
+                   gbps[PATH_COPY], gbps[PATH_IOVEC], path_names[best]);
+        }
+        if (n > 0 && policy[n - 1].path == best) {
+            policy[n - 1].upto = len;
+        } else if (n < MAX_POLICY) {
+            policy[n].upto = len;
+            policy[n].path = best;
+            n++;
+        }
+        if (len == max) break;
+    }
+    conn_close_hybrid(tx, c);
+    shutdown(tx, SHUT_WR);
+    pthread_join(drain, NULL);
+    close(tx);
+    close(rx);
+    server_stats = saved_stats;
+    zc_reset_metrics();
+
+    if (!c || n == 0 || !running) return -1;    // Failed or interrupted by shutdown
+    policy[n - 1].upto = SIZE_MAX;
+    policy_len = n;
+    printf("Calibrated send policy:\n");
+    print_policy();
+    printf("\n");
+    return 0;
+}
+
+static int setup_hybrid(void) {
+    return calibrate_ms > 0 ? calibrate_policy() : 0;
+}
+
+/* parse_thresholds: "COPY_MAX:IOVEC_MAX" (frame bytes) into the static table */
+static int parse_thresholds(const char *arg) {
+    char *end;
+    unsigned long long copy_max = strtoull(arg, &end, 10);
+    if (*end != ':') return -1;
+    unsigned long long iovec_max = strtoull(end + 1, &end, 10);
+    if (*end || iovec_max < copy_max) return -1;
+    policy[0] = (PolicyEntry){ (size_t)copy_max, PATH_COPY };
+    policy[1] = (PolicyEntry){ (size_t)iovec_max, PATH_IOVEC };
+    policy[2] = (PolicyEntry){ SIZE_MAX, PATH_ZEROCOPY };
+    policy_len = 3;
+    return 0;
+}
+
+static const struct option hybrid_server_options[] = {
+    {"thresholds", required_argument, 0, 't'},
+    {"calibrate",  optional_argument, 0, 'C'},
+    {"min-size",   required_argument, 0, 'n'},
+    {"depth",      required_argument, 0, 'd'},
+    {0, 0, 0, 0}
+};
+
+static int parse_hybrid_server_option(int opt_char, const char *arg) {
+    switch (opt_char) {
+    case 't':
+        return parse_thresholds(arg);
+    case 'C':
+        calibrate_ms = arg ? atoi(arg) : DEFAULT_CALIBRATE_MS;
+        return calibrate_ms > 0 ? 0 : -1;
+    case 'n':
+        min_frame = (size_t)atol(arg);
+        if (min_frame && min_frame < sizeof(FrameHeader)) min_frame = sizeof(FrameHeader);
+        return 0;
+    case 'd':
+        hybrid_depth = atoi(arg);
+        if (hybrid_depth < 1) hybrid_depth = 1;
+        return 0;
+    }
+    return -1;
+}
+
+static void describe_hybrid_server(void) {
+    if (min_frame && min_frame < max_frame_bytes()) {
+        printf("Frame sizes: log-uniform %zu..%zu bytes per message\n", min_frame, max_frame_bytes());
+    }
+    printf("Zero-copy path: %d in-flight buffers per connection\n", hybrid_depth);
+    if (calibrate_ms > 0) {
+        printf("Send policy: calibrated at startup\n");
+    } else {
+        printf("Send policy (static):\n");
+        print_policy();
+    }
+}
+
+const ServerTransport hybrid_server = {
+    .name = "hybrid",
+    .part = "A8",
+    .title = "Hybrid",
+    .default_port = 8087,
+    .options = hybrid_server_options,
+    .parse_option = parse_hybrid_server_option,
+    .usage = "[--thresholds=COPY_MAX:IOVEC_MAX | --calibrate[=MS]] [--min-size=BYTES] [--depth=K]",
+    .setup = setup_hybrid,
+    .describe = describe_hybrid_server,
+    .ops = {
+        .conn_open = conn_open_hybrid,
+        .send_from = send_from_hybrid,
+        .begin_message = begin_message_hybrid,
+        .drain_errqueue = drain_errqueue_hybrid,
+        .conn_close = conn_close_hybrid,
+        .message_length = message_length_hybrid,
+    },
+    .prepare_message = prepare_hybrid,
+    .send_message = send_message_hybrid,
+    .send_error = "hybrid send error",
+    .conn_report = conn_report_hybrid,
+    .format_metrics = zc_format_metrics,
+};
+
+/*
+ * receive_frame_hybrid: recv() copy of one frame of any length up to the
+ * buffer size. Reads stop at the end of the header until it is known, so
+ * a short frame never pulls in the start of the next one.
+ */
+static ssize_t receive_frame_hybrid(int sockfd, void *state, FrameAssembler *fa) {
+    char *buffer = (char*)state;
+    while (1) {
+        size_t want = fa->length ? frame_want(fa) : sizeof(FrameHeader) - fa->filled;
+        ssize_t bytes_received = recv_spin(sockfd, buffer + fa->filled, want, 0,
+                                           busy_poll_usec >= 0);
+        if (bytes_received < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        if (bytes_received == 0) return 0;
+
+        int r = frame_received(fa, buffer, (size_t)bytes_received);
+        if (r == FRAME_COMPLETE) return 1;
+        if (r == FRAME_INVALID) {
+            errno = EPROTO;     // Stream desynchronised (e.g. message_size mismatch)
+            return -1;
+        }
+    }
+}
+
+const ClientTransport hybrid_client = {
+    .name = "hybrid",
+    .part = "A8",
+    .title = "Hybrid",
+    .default_port = 8087,
+    .conn_open = recv_copy_open,
+    .receive_frame = receive_frame_hybrid,
+    .visit_payload = recv_copy_visit_payload,
+    .conn_close = recv_copy_close,
+};
@@ -0,0 +1,360 @@
+/*
+ * ONE-COPY strategy (--mode=one-copy, formerly Part A2)
+ * Server: sendmsg() with iovec - demonstrates the ONE-COPY model:
+ * ELIMINATED: User space → Kernel space copy (using pre-registered buffers & scatter-gather)
+ * REMAINING: Kernel space → NIC (DMA still required)
+ * 
+ * KEY OPTIMIZATION:
+ * - Uses struct iovec for scatter-gather I/O
+ * - Buffers are pre-registered and reused
+ * - Kernel can directly DMA from these buffers without intermediate copy
+ *
+ * Client: recvmsg() with iovec scattering into 8 field buffers
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <getopt.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include "MT25190_Transport.h"
+#include "MT25190_BusyPoll.h"
+#include "MT25190_BufferPool.h"
+#include "MT25190_ServerStats.h"
+
+#define FIELD_ALIGN 4096
+
+/*
+ * Message structure using pre-registered buffers
+ * These buffers are allocated once and reused, allowing
+ * the kernel to reference them directly without copying
+ */
+typedef struct {
+    char *fields[NUM_FIELDS];  // Pre-allocated buffers
+    struct iovec iov[NUM_FIELDS];  // iovec array for scatter-gather I/O
+    size_t field_size;
+    uint32_t crc;                  // --checksum: payload CRC32C (buffers never change)
+} MessageOneCopy;
+
+/*
+ * allocate_message_onecopy: Allocates pre-registered buffers
+ * 
+ * WHY THIS ENABLES ONE-COPY:
+ * - Buffers are allocated once and page-aligned (can be optimized further)
+ * - Kernel can set up direct DMA descriptors pointing to these buffers
+ * - No need to copy from user buffer to kernel buffer (eliminates COPY 1)
+ * - Kernel directly DMAs from user-space buffers to NIC (only COPY 2 remains)
+ */
+static MessageOneCopy* allocate_message_onecopy(int field_size) {
+    MessageOneCopy *msg = (MessageOneCopy*)malloc(sizeof(MessageOneCopy));
+    if (!msg) {
+        perror("Failed to allocate message structure");
+        return NULL;
+    }
+    
+    msg->field_size = field_size;
+    
+    // Allocate each field as a pre-registered buffer
+    // (--hugepages: carved from the shared 2 MB-page pool, fewer dTLB entries)
+    for (int i = 0; i < NUM_FIELDS; i++) {
+        // Allocate page-aligned memory for better DMA performance
+        // Note: For true zero-copy, these would need to be pinned pages
+        msg->fields[i] = (char*)pool_alloc(field_size, FIELD_ALIGN);
+        if (!msg->fields[i]) {
+            perror("Failed to allocate field buffer");
+            // Cleanup previously allocated fields
+            for (int j = 0; j < i; j++) {
+                pool_free(msg->fields[j], field_size, FIELD_ALIGN);
+            }
+            free(msg);
+            return NULL;
+        }
+        
+        // Initialize with test data
+        memset(msg->fields[i], 'A' + i, field_size - 1);
+        msg->fields[i][field_size - 1] = '\0';
+        
+        // Set up iovec structure for this field
+        // iovec allows kernel to gather data from multiple buffers
+        // without copying them into a single contiguous buffer
+        msg->iov[i].iov_base = msg->fields[i];
+        msg->iov[i].iov_len = field_size;
+    }
+    if (frame_checksum) {
+        msg->crc = fields_payload_crc(msg->fields, field_size, msg->field_size * NUM_FIELDS);
+    }
+    
+    return msg;
+}
+
+/*
+ * free_message_onecopy: Frees pre-registered buffers
+ */
+static void free_message_onecopy(MessageOneCopy *msg) {
+    if (msg) {
+        for (int i = 0; i < NUM_FIELDS; i++) {
+            pool_free(msg->fields[i], msg->field_size, FIELD_ALIGN);
+        }
+        free(msg);
+    }
+}
+
+/*
+ * send_message_onecopy: Sends message using ONE-COPY model via sendmsg()
+ * 
+ * ONE-COPY ARCHITECTURE:
+ * ----------------------
+ * Traditional send() (TWO-COPY):
+ *   User Buffer → [COPY 1] → Kernel Socket Buffer → [COPY 2 via DMA] → NIC
+ * 
+ * sendmsg() with iovec (ONE-COPY):
+ *   User Pre-registered Buffer → [ELIMINATED] → [COPY via DMA] → NIC
+ * 
+ * HOW IT WORKS:
+ * 1. iovec array describes multiple non-contiguous buffers
+ * 2. sendmsg() uses scatter-gather I/O: kernel builds a descriptor list
+ * 3. NIC's DMA engine reads directly from user buffers using descriptor list
+ * 4. No intermediate copy to kernel buffer needed (COPY 1 eliminated)
+ * 5. Only DMA transfer to NIC remains (COPY 2: Kernel/User → NIC)
+ * 
+ * KERNEL BEHAVIOR:
+ * - tcp_sendmsg() references user pages instead of copying
+ * - sk_buff points directly to user memory (if pages are pinned)
+ * - DMA descriptors set up to read from original user buffers
+ */
+static int send_message_onecopy(int sockfd, void *state, uint64_t seq, uint64_t send_ns) {
+    MessageOneCopy *msg = (MessageOneCopy*)state;
+    frame_stamp(msg->fields[0], (uint32_t)message_size * NUM_FIELDS, seq, send_ns);
+    if (frame_checksum) frame_seal(msg->fields[0], msg->crc);
+    
+    struct msghdr msgh;
+    memset(&msgh, 0, sizeof(msgh));
+    
+    // Set up message header for sendmsg()
+    // iov points to our pre-registered buffer array
+    // iovlen indicates number of buffers to send
+    msgh.msg_iov = msg->iov;
+    msgh.msg_iovlen = NUM_FIELDS;
+    msgh.msg_control = NULL;
+    msgh.msg_controllen = 0;
+    
+    // sendmsg() with iovec - enables ONE-COPY transmission
+    // Kernel sets up scatter-gather DMA without copying data
+    ssize_t sent = stats_sent(sendmsg(sockfd, &msgh, 0), (size_t)message_size * NUM_FIELDS);
+    
+    if (sent < 0) {
+        return -1;
+    }
+    
+    return sent;
+}
+
+/*
+ * send_from_onecopy: Resumable ONE-COPY send for the epoll engine
+ * Builds an iovec view of the unsent tail (skipping 'offset' bytes) over the
+ * same pre-registered buffers, so a partial sendmsg() resumes without copying.
+ */
+static ssize_t send_from_onecopy(int sockfd, void *state, size_t offset) {
+    MessageOneCopy *msg = (MessageOneCopy*)state;
+    struct iovec iov[NUM_FIELDS];
+    int idx = (int)(offset / message_size);
+    size_t within = offset % message_size;
+    int iovcnt = 0;
+    
+    for (int i = idx; i < NUM_FIELDS; i++) {
+        iov[iovcnt] = msg->iov[i];
+        if (i == idx) {
+            iov[iovcnt].iov_base = (char*)iov[iovcnt].iov_base + within;
+            iov[iovcnt].iov_len -= within;
+        }
+        iovcnt++;
+    }
+    
+    struct msghdr msgh;
+    memset(&msgh, 0, sizeof(msgh));
+    msgh.msg_iov = iov;
+    msgh.msg_iovlen = iovcnt;
+    return stats_sent(sendmsg(sockfd, &msgh, 0), (size_t)message_size * NUM_FIELDS - offset);
+}
+
+/*
+ * begin_message_onecopy: Stamps the frame header into the first registered
+ * buffer before the first byte of message 'seq' is sent
+ */
+static void begin_message_onecopy(void *state, uint64_t seq) {
+    MessageOneCopy *msg = (MessageOneCopy*)state;
+    frame_stamp(msg->fields[0], (uint32_t)message_size * NUM_FIELDS, seq, monotonic_ns());
+    if (frame_checksum) frame_seal(msg->fields[0], msg->crc);
+}
+
+static void* conn_open_onecopy(int sockfd) {
+    (void)sockfd;
+    return allocate_message_onecopy(message_size);
+}
+
+static void conn_close_onecopy(int sockfd, void *state) {
+    (void)sockfd;
+    free_message_onecopy((MessageOneCopy*)state);
+}
+
+static const struct option onecopy_server_options[] = {
+    {"hugepages", optional_argument, 0, 'H'},
+    {0, 0, 0, 0}
+};
+
+static int parse_onecopy_option(int opt_char, const char *arg) {
+    if (opt_char != 'H') return -1;
+    return buffer_pool_configure(arg);
+}
+
+static void describe_onecopy(void) {
+    printf("Hugepage buffer pool: %s\n", buffer_pool_name());
+    printf("\nONE-COPY OPTIMIZATION:\n");
+    printf("- Using sendmsg() with struct iovec\n");
+    printf("- Pre-registered buffers eliminate User→Kernel copy\n");
+    printf("- Only Kernel→NIC DMA copy remains\n");
+}
+
+const ServerTransport one_copy_server = {
+    .name = "one-copy",
+    .part = "A2",
+    .title = "One-Copy",
+    .default_port = 8081,
+    .options = onecopy_server_options,
+    .parse_option = parse_onecopy_option,
+    .usage = "[--hugepages[=huge|thp|off]]",
+    .describe = describe_onecopy,
+    .ops = {
+        .conn_open = conn_open_onecopy,
+        .send_from = send_from_onecopy,
+        .begin_message = begin_message_onecopy,
+        .conn_close = conn_close_onecopy,
+    },
+    .send_message = send_message_onecopy,
+    .send_error = "sendmsg error",
+};
+
+/* Client: pre-registered field buffers and their iovecs */
+typedef struct {
+    char *buffers[NUM_FIELDS];
+    struct iovec iov[NUM_FIELDS];
+} OneCopyReceiver;
+
+/*
+ * receive_message_onecopy: Uses recvmsg() with iovec for ONE-COPY receive
+ * Kernel DMAs directly into pre-registered user buffers
+ */
+static ssize_t receive_message_onecopy(int sockfd, struct iovec *iov, int iovcnt) {
+    struct msghdr msgh;
+    memset(&msgh, 0, sizeof(msgh));
+    
+    msgh.msg_iov = iov;
+    msgh.msg_iovlen = iovcnt;
+    
+    ssize_t received = recvmsg_spin(sockfd, &msgh, 0, busy_poll_usec >= 0);
+    return received;
+}
+
+/*
+ * build_iov_view: iovec view of bytes [offset, offset + len) of the frame
+ * scattered over 'iov', so a partial recvmsg() resumes in place.
+ * Returns the number of entries written to 'view'.
+ */
+static int build_iov_view(const struct iovec *iov, int iovcnt, size_t offset, size_t len,
+                          struct iovec *view) {
+    int n = 0;
+    for (int i = 0; i < iovcnt && len > 0; i++) {
+        if (offset >= iov[i].iov_len) {
+            offset -= iov[i].iov_len;
+            continue;
+        }
+        size_t take = iov[i].iov_len - offset;
+        if (take > len) take = len;
+        view[n].iov_base = (char*)iov[i].iov_base + offset;
+        view[n].iov_len = take;
+        n++;
+        len -= take;
+        offset = 0;
+    }
+    return n;
+}
+
+/*
+ * receive_frame_onecopy: recvmsg() until one whole frame has arrived
+ * Each recvmsg() scatters into the field buffers at the frame's current
+ * offset (no staging copy) and never reads past the end of the frame once
+ * its header is known. The header lands in the first field buffer.
+ */
+static ssize_t receive_frame_onecopy(int sockfd, void *state, FrameAssembler *fa) {
+    const struct iovec *iov = ((OneCopyReceiver*)state)->iov;
+    struct iovec view[NUM_FIELDS];
+    
+    while (1) {
+        int viewcnt = build_iov_view(iov, NUM_FIELDS, fa->filled, frame_want(fa), view);
+        ssize_t received = receive_message_onecopy(sockfd, view, viewcnt);
+        if (received < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        if (received == 0) return 0;
+        
+        int r = frame_received(fa, iov[0].iov_base, (size_t)received);
+        if (r == FRAME_COMPLETE) return 1;
+        if (r == FRAME_INVALID) {
+            errno = EPROTO;     // Stream desynchronised (e.g. message_size mismatch)
+            return -1;
+        }
+    }
+}
+
+/* visit_payload_onecopy: The payload scattered over the field buffers */
+static int visit_payload_onecopy(void *state, const FrameAssembler *fa, PayloadSink sink,
+                                 void *ctx) {
+    fields_visit_payload(((OneCopyReceiver*)state)->buffers, message_size,
+                         frame_header(fa)->length, sink, ctx);
+    return 1;
+}
+
+static void receiver_close_onecopy(void *state) {
+    OneCopyReceiver *rx = (OneCopyReceiver*)state;
+    for (int i = 0; i < NUM_FIELDS; i++) {
+        free(rx->buffers[i]);
+    }
+    free(rx);
+}
+
+/* receiver_open_onecopy: Allocates pre-registered buffers for ONE-COPY receive */
+static void* receiver_open_onecopy(int sockfd, size_t frame_bytes) {
+    (void)sockfd;
+    (void)frame_bytes;      // NUM_FIELDS buffers of message_size
+    OneCopyReceiver *rx = calloc(1, sizeof(OneCopyReceiver));
+    if (!rx) {
+        perror("Failed to allocate buffer");
+        return NULL;
+    }
+    for (int i = 0; i < NUM_FIELDS; i++) {
+        rx->buffers[i] = (char*)aligned_alloc(4096, ((size_t)message_size + 4095) & ~(size_t)4095);
+        if (!rx->buffers[i]) {
+            perror("Failed to allocate buffer");
+            receiver_close_onecopy(rx);
+            return NULL;
+        }
+        rx->iov[i].iov_base = rx->buffers[i];
+        rx->iov[i].iov_len = message_size;
+    }
+    return rx;
+}
+
+const ClientTransport one_copy_client = {
+    .name = "one-copy",
+    .part = "A2",
+    .title = "One-Copy",
+    .default_port = 8081,
+    .conn_open = receiver_open_onecopy,
+    .receive_frame = receive_frame_onecopy,
+    .visit_payload = visit_payload_onecopy,
+    .conn_close = receiver_close_onecopy,
+};
@@ -0,0 +1,262 @@
+/*
+ * SENDFILE strategy (--mode=sendfile, formerly Part A5)
+ * Server: file-backed messages with sendfile() / splice()
+ *
+ * The 8-field payload lives in a memfd (anonymous tmpfs file) or in a
+ * regular file, and is transferred from the page cache inside the kernel:
+ *
+ *   sendfile:  page cache --------------------------------> socket
+ *   splice:    page cache --> pipe (page refs) -----------> socket
+ *
+ *   User memory only holds the 32-byte frame header, sent with MSG_MORE
+ *   so it coalesces with the payload that follows.
+ *
+ * Unlike MSG_ZEROCOPY there is no completion queue: the page cache owns
+ * the pages, and the payload is never rewritten while the server runs.
+ *
+ * Client: the ordinary recv() copy (same as two-copy), so differences
+ * against the other modes isolate the send-side primitive.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/sendfile.h>
+#include <sys/mman.h>
+
+#include "MT25190_Transport.h"
+#include "MT25190_Checksum.h"
+#include "MT25190_ServerStats.h"
+
+/* In-kernel transfer primitive (--xfer) */
+typedef enum {
+    XFER_SENDFILE = 0,      // sendfile(file -> socket)
+    XFER_SPLICE   = 1       // splice(file -> pipe), splice(pipe -> socket)
+} TransferMode;
+
+static int xfer_mode = XFER_SENDFILE;
+static const char *payload_path = NULL;    // --file=PATH: regular file instead of memfd
+static int payload_fd = -1;                // Shared read-only payload (one frame)
+static size_t message_bytes;               // NUM_FIELDS * message_size
+static uint32_t payload_crc;               // --checksum: CRC32C of the file's payload bytes
+
+/* Per-connection send state */
+typedef struct {
+    FrameHeader header;     // Stamped per message, the only user-space bytes sent
+    int pipefd[2];          // splice mode: file -> pipe -> socket
+    size_t pipe_bytes;      // Payload bytes already moved into the pipe
+} FileConnection;
+
+/*
+ * create_payload: Writes the 8 fields ('A'..'H') into a memfd or file
+ * Bytes [0, sizeof(FrameHeader)) are never sent from the file: every
+ * message sends its own header from user memory instead.
+ * The payload CRC32C is accumulated on the way (payload_crc).
+ * Returns the file descriptor, or -1 on failure.
+ */
+static int create_payload(const char *path, size_t field_size) {
+    int fd = path ? open(path, O_RDWR | O_CREAT | O_TRUNC, 0600)
+                  : memfd_create("MT25190_payload", 0);
+    if (fd < 0) {
+        perror(path ? "open payload file failed" : "memfd_create failed");
+        return -1;
+    }
+
+    char *field = malloc(field_size);
+    if (!field) {
+        perror("Failed to allocate field");
+        close(fd);
+        return -1;
+    }
+    payload_crc = 0;
+    for (int i = 0; i < NUM_FIELDS; i++) {
+        memset(field, 'A' + i, field_size - 1);
+        field[field_size - 1] = '\0';
+        size_t skip = i == 0 ? sizeof(FrameHeader) : 0;
+        payload_crc = crc32c(payload_crc, field + skip, field_size - skip);
+        if (pwrite(fd, field, field_size, (off_t)(i * field_size)) != (ssize_t)field_size) {
+            perror("Failed to write payload");
+            free(field);
+            close(fd);
+            return -1;
+        }
+    }
+    free(field);
+    return fd;
+}
+
+/*
+ * send_from_file: Sends the rest of the current message from 'offset'
+ * Header bytes come from user memory, payload bytes straight from the page
+ * cache. Works for blocking (thread engine) and non-blocking (epoll)
+ * sockets: in splice mode, bytes that reached the pipe but not the socket
+ * stay there and go out first on the next call.
+ */
+static ssize_t send_from_file(int sockfd, void *state, size_t offset) {
+    FileConnection *c = (FileConnection*)state;
+
+    if (offset < sizeof(FrameHeader)) {
+        size_t want = sizeof(FrameHeader) - offset;
+        return stats_sent(send(sockfd, (char*)&c->header + offset, want, MSG_MORE | MSG_NOSIGNAL),
+                          want);
+    }
+
+    if (xfer_mode == XFER_SENDFILE) {
+        off_t pos = (off_t)offset;
+        return stats_sent(sendfile(sockfd, payload_fd, &pos, message_bytes - offset),
+                          message_bytes - offset);
+    }
+
+    // splice: page references move file -> pipe -> socket, no data copy
+    if (c->pipe_bytes == 0) {
+        loff_t pos = (loff_t)offset;
+        ssize_t n = splice(payload_fd, &pos, c->pipefd[1], NULL, message_bytes - offset,
+                           SPLICE_F_MOVE);
+        if (n <= 0) {
+            if (n == 0) errno = EIO;    // Payload file shorter than a message
+            return -1;
+        }
+        c->pipe_bytes = (size_t)n;
+    }
+    // SPLICE_F_MORE only while the pipe does not hold the message's tail,
+    // otherwise the last segment would wait for the TCP cork timer
+    unsigned int flags = SPLICE_F_MOVE;
+    if (offset + c->pipe_bytes < message_bytes) flags |= SPLICE_F_MORE;
+    ssize_t sent = stats_sent(splice(c->pipefd[0], NULL, sockfd, NULL, c->pipe_bytes, flags),
+                              c->pipe_bytes);
+    if (sent > 0) c->pipe_bytes -= (size_t)sent;
+    return sent;
+}
+
+/*
+ * begin_message_file: Stamps the frame header before message 'seq'
+ */
+static void begin_message_file(void *state, uint64_t seq) {
+    FileConnection *c = (FileConnection*)state;
+    frame_stamp(&c->header, (uint32_t)message_bytes, seq, monotonic_ns());
+    if (frame_checksum) frame_seal(&c->header, payload_crc);
+}
+
+static void* conn_open_file(int sockfd) {
+    (void)sockfd;
+    FileConnection *c = calloc(1, sizeof(FileConnection));
+    if (!c) {
+        perror("Failed to allocate connection state");
+        return NULL;
+    }
+    c->pipefd[0] = c->pipefd[1] = -1;
+    if (xfer_mode == XFER_SPLICE && pipe(c->pipefd) < 0) {
+        perror("pipe failed");
+        free(c);
+        return NULL;
+    }
+    return c;
+}
+
+static void conn_close_file(int sockfd, void *state) {
+    (void)sockfd;
+    FileConnection *c = (FileConnection*)state;
+    if (c->pipefd[0] >= 0) close(c->pipefd[0]);
+    if (c->pipefd[1] >= 0) close(c->pipefd[1]);
+    free(c);
+}
+
+/*
+ * send_message_file: Stamps and sends one whole message (blocking socket)
+ */
+static int send_message_file(int sockfd, void *state, uint64_t seq, uint64_t send_ns) {
+    FileConnection *c = (FileConnection*)state;
+    frame_stamp(&c->header, (uint32_t)message_bytes, seq, send_ns);
+    if (frame_checksum) frame_seal(&c->header, payload_crc);
+
+    size_t offset = 0;
+    while (offset < message_bytes) {
+        ssize_t sent = send_from_file(sockfd, c, offset);
+        if (sent < 0) {
+            if (errno == EINTR && running) continue;
+            return -1;
+        }
+        offset += (size_t)sent;
+    }
+    return (int)offset;
+}
+
+/* setup_file: Shared payload, created once the message size is known */
+static int setup_file(void) {
+    message_bytes = (size_t)message_size * NUM_FIELDS;
+    payload_fd = create_payload(payload_path, (size_t)message_size);
+    return payload_fd < 0 ? -1 : 0;
+}
+
+static void teardown_file(void) {
+    if (payload_fd >= 0) close(payload_fd);
+    payload_fd = -1;
+}
+
+static const struct option sendfile_server_options[] = {
+    {"xfer",     required_argument, 0, 'x'},
+    {"file",     required_argument, 0, 'f'},
+    {0, 0, 0, 0}
+};
+
+static int parse_sendfile_option(int opt_char, const char *arg) {
+    switch (opt_char) {
+    case 'x':
+        if (strcmp(arg, "sendfile") == 0) {
+            xfer_mode = XFER_SENDFILE;
+        } else if (strcmp(arg, "splice") == 0) {
+            xfer_mode = XFER_SPLICE;
+        } else {
+            fprintf(stderr, "Unknown transfer '%s' (expected sendfile|splice)\n", arg);
+            return -1;
+        }
+        return 0;
+    case 'f':
+        payload_path = arg;
+        return 0;
+    }
+    return -1;
+}
+
+static void describe_sendfile(void) {
+    printf("Transfer: %s from %s\n", xfer_mode == XFER_SPLICE ? "splice via pipe" : "sendfile",
+           payload_path ? payload_path : "memfd");
+}
+
+const ServerTransport sendfile_server = {
+    .name = "sendfile",
+    .part = "A5",
+    .title = "sendfile/splice",
+    .default_port = 8084,
+    .options = sendfile_server_options,
+    .parse_option = parse_sendfile_option,
+    .usage = "[--xfer=sendfile|splice] [--file=PATH]",
+    .setup = setup_file,
+    .teardown = teardown_file,
+    .describe = describe_sendfile,
+    .ops = {
+        .conn_open = conn_open_file,
+        .send_from = send_from_file,
+        .begin_message = begin_message_file,
+        .conn_close = conn_close_file,
+    },
+    .send_message = send_message_file,
+    .send_error = "sendfile/splice error",
+};
+
+const ClientTransport sendfile_client = {
+    .name = "sendfile",
+    .part = "A5",
+    .title = "sendfile/splice",
+    .default_port = 8084,
+    .conn_open = recv_copy_open,
+    .receive_frame = recv_copy_frame,
+    .visit_payload = recv_copy_visit_payload,
+    .conn_close = recv_copy_close,
+};
@@ -0,0 +1,389 @@
+/*
+ * TWO-COPY strategy (--mode=two-copy, formerly Part A1)
+ * Server: send() per field - demonstrates the TWO-COPY model:
+ * Copy 1: User space → Kernel space
+ * Copy 2: Kernel space → NIC
+ * Client: plain recv() into one buffer (MT25190_Transport.c)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <sys/socket.h>
+
+#include "MT25190_Transport.h"
+#include "MT25190_Arena.h"
+#include "MT25190_ServerStats.h"
+
+/* Message structure with 8 dynamically allocated string fields
+ * (--alloc=malloc: nine heap allocations; --alloc=arena: one block) */
+typedef struct {
+    char *field1;  // Each field will be allocated via malloc()
+    char *field2;
+    char *field3;
+    char *field4;
+    char *field5;
+    char *field6;
+    char *field7;
+    char *field8;
+} Message;
+
+/* Where Message headers and fields come from (--alloc) */
+typedef enum {
+    ALLOC_MALLOC = 0,   // One malloc() per field plus one for the header (original)
+    ALLOC_ARENA  = 1    // Header + 8 fields in one cache-line-aligned arena block
+} AllocMode;
+
+static int alloc_mode = ALLOC_MALLOC;   // Message allocator (--alloc=malloc|arena)
+static int alloc_per_send = 0;          // 1: build a fresh Message for every send (--alloc-per-send)
+
+/*
+ * fill_message: Writes the sample payload into every field
+ */
+static void fill_message(Message *msg, int field_size) {
+    // Initialize with sample data
+    memset(msg->field1, 'A', field_size - 1);
+    memset(msg->field2, 'B', field_size - 1);
+    memset(msg->field3, 'C', field_size - 1);
+    memset(msg->field4, 'D', field_size - 1);
+    memset(msg->field5, 'E', field_size - 1);
+    memset(msg->field6, 'F', field_size - 1);
+    memset(msg->field7, 'G', field_size - 1);
+    memset(msg->field8, 'H', field_size - 1);
+    
+    // Null-terminate each field
+    msg->field1[field_size - 1] = '\0';
+    msg->field2[field_size - 1] = '\0';
+    msg->field3[field_size - 1] = '\0';
+    msg->field4[field_size - 1] = '\0';
+    msg->field5[field_size - 1] = '\0';
+    msg->field6[field_size - 1] = '\0';
+    msg->field7[field_size - 1] = '\0';
+    msg->field8[field_size - 1] = '\0';
+}
+
+/* message_block_size: Arena block holding a Message and its 8 fields */
+static size_t message_block_size(int field_size) {
+    return ARENA_ALIGN(sizeof(Message)) + 8 * ARENA_ALIGN((size_t)field_size);
+}
+
+/*
+ * allocate_message_arena: One arena block, header first, then the fields
+ * at cache-line boundaries. The whole message is contiguous, so filling
+ * and sending it walks one region instead of nine heap chunks.
+ */
+static Message* allocate_message_arena(MsgArena *arena, int field_size) {
+    char *block = (char*)arena_alloc(arena);
+    if (!block) {
+        perror("Failed to allocate message block");
+        return NULL;
+    }
+    Message *msg = (Message*)block;
+    char *field = block + ARENA_ALIGN(sizeof(Message));
+    size_t stride = ARENA_ALIGN((size_t)field_size);
+    msg->field1 = field;
+    msg->field2 = field + stride;
+    msg->field3 = field + 2 * stride;
+    msg->field4 = field + 3 * stride;
+    msg->field5 = field + 4 * stride;
+    msg->field6 = field + 5 * stride;
+    msg->field7 = field + 6 * stride;
+    msg->field8 = field + 7 * stride;
+    fill_message(msg, field_size);
+    return msg;
+}
+
+/*
+ * allocate_message: Dynamically allocates message fields
+ * Each field is allocated using malloc() to demonstrate
+ * user-space memory allocation before sending
+ * (from 'arena' instead when it is non-NULL, --alloc=arena)
+ */
+static Message* allocate_message(MsgArena *arena, int field_size) {
+    if (arena) return allocate_message_arena(arena, field_size);
+    
+    Message *msg = (Message*)malloc(sizeof(Message));
+    if (!msg) {
+        perror("Failed to allocate message structure");
+        return NULL;
+    }
+    
+    // Allocate each field separately using malloc()
+    msg->field1 = (char*)malloc(field_size);
+    msg->field2 = (char*)malloc(field_size);
+    msg->field3 = (char*)malloc(field_size);
+    msg->field4 = (char*)malloc(field_size);
+    msg->field5 = (char*)malloc(field_size);
+    msg->field6 = (char*)malloc(field_size);
+    msg->field7 = (char*)malloc(field_size);
+    msg->field8 = (char*)malloc(field_size);
+    
+    // Check if all allocations succeeded
+    if (!msg->field1 || !msg->field2 || !msg->field3 || !msg->field4 ||
+        !msg->field5 || !msg->field6 || !msg->field7 || !msg->field8) {
+        perror("Failed to allocate message fields");
+        // Cleanup any successfully allocated fields
+        free(msg->field1);
+        free(msg->field2);
+        free(msg->field3);
+        free(msg->field4);
+        free(msg->field5);
+        free(msg->field6);
+        free(msg->field7);
+        free(msg->field8);
+        free(msg);
+        return NULL;
+    }
+    
+    fill_message(msg, field_size);
+    return msg;
+}
+
+/*
+ * free_message: Deallocates all message fields
+ * (an arena block goes back onto the arena's free list)
+ */
+static void free_message(MsgArena *arena, Message *msg) {
+    if (arena) {
+        arena_free(arena, msg);
+    } else if (msg) {
+        free(msg->field1);
+        free(msg->field2);
+        free(msg->field3);
+        free(msg->field4);
+        free(msg->field5);
+        free(msg->field6);
+        free(msg->field7);
+        free(msg->field8);
+        free(msg);
+    }
+}
+
+/*
+ * Connection state: the current message plus the arena it is carved
+ * from (--alloc=arena), so --alloc-per-send can rebuild it
+ */
+typedef struct {
+    Message *msg;
+    MsgArena arena;
+    MsgArena *pool;         // &arena with --alloc=arena, NULL for malloc
+    long built;             // Messages allocated on this connection
+    uint32_t crc;           // --checksum: payload CRC32C of 'msg'
+} TwoCopyConn;
+
+/*
+ * seal_message: --checksum computes the payload CRC32C once per built
+ * message (per send with --alloc-per-send, like any freshly built reply)
+ */
+static void seal_message(TwoCopyConn *conn) {
+    if (!frame_checksum) return;
+    Message *msg = conn->msg;
+    char *fields[8] = {msg->field1, msg->field2, msg->field3, msg->field4,
+                       msg->field5, msg->field6, msg->field7, msg->field8};
+    conn->crc = fields_payload_crc(fields, message_size, (size_t)message_size * NUM_FIELDS);
+}
+
+/*
+ * next_message: --alloc-per-send builds a fresh message like a server
+ * answering each request would (the allocator's cost lands in every
+ * send). On allocation failure the old one is resent.
+ */
+static void next_message(TwoCopyConn *conn, uint64_t seq) {
+    if (alloc_per_send && seq > 0) {
+        Message *fresh = allocate_message(conn->pool, message_size);
+        if (fresh) {
+            free_message(conn->pool, conn->msg);
+            conn->msg = fresh;
+            conn->built++;
+            seal_message(conn);
+        }
+    }
+}
+
+/*
+ * send_message_twocopy: Sends message using TWO-COPY model
+ * 
+ * TWO-COPY ARCHITECTURE:
+ * 1. COPY 1: User → Kernel
+ *    - send() copies data from user buffer (msg->field*) to kernel socket buffer
+ *    - Kernel allocates sk_buff structure
+ *    - Data is copied into kernel memory space
+ * 
+ * 2. COPY 2: Kernel → NIC
+ *    - DMA controller copies data from kernel buffer to NIC transmit ring
+ *    - Network card buffers data before transmission
+ */
+static int send_message_twocopy(int sockfd, void *state, uint64_t seq, uint64_t send_ns) {
+    TwoCopyConn *conn = (TwoCopyConn*)state;
+    next_message(conn, seq);
+    Message *msg = conn->msg;
+    int field_size = message_size;
+    frame_stamp(msg->field1, (uint32_t)field_size * NUM_FIELDS, seq, send_ns);
+    if (frame_checksum) frame_seal(msg->field1, conn->crc);
+    
+    ssize_t total_sent = 0;
+    ssize_t bytes_sent;
+    
+    // Send each field separately - each send() triggers COPY 1 (User → Kernel)
+    // Note: Each send() call results in:
+    //   - Syscall transition (user mode → kernel mode)
+    //   - Memory copy from user space to kernel socket buffer
+    //   - Eventual DMA transfer to NIC (COPY 2: Kernel → NIC)
+    // FIX: Send full field_size bytes (not strlen) to match client expectation
+    
+    bytes_sent = stats_sent(send(sockfd, msg->field1, field_size, 0), field_size);  // USER → KERNEL copy
+    if (bytes_sent < 0) return -1;
+    total_sent += bytes_sent;
+    
+    bytes_sent = stats_sent(send(sockfd, msg->field2, field_size, 0), field_size);  // USER → KERNEL copy
+    if (bytes_sent < 0) return -1;
+    total_sent += bytes_sent;
+    
+    bytes_sent = stats_sent(send(sockfd, msg->field3, field_size, 0), field_size);  // USER → KERNEL copy
+    if (bytes_sent < 0) return -1;
+    total_sent += bytes_sent;
+    
+    bytes_sent = stats_sent(send(sockfd, msg->field4, field_size, 0), field_size);  // USER → KERNEL copy
+    if (bytes_sent < 0) return -1;
+    total_sent += bytes_sent;
+    
+    bytes_sent = stats_sent(send(sockfd, msg->field5, field_size, 0), field_size);  // USER → KERNEL copy
+    if (bytes_sent < 0) return -1;
+    total_sent += bytes_sent;
+    
+    bytes_sent = stats_sent(send(sockfd, msg->field6, field_size, 0), field_size);  // USER → KERNEL copy
+    if (bytes_sent < 0) return -1;
+    total_sent += bytes_sent;
+    
+    bytes_sent = stats_sent(send(sockfd, msg->field7, field_size, 0), field_size);  // USER → KERNEL copy
+    if (bytes_sent < 0) return -1;
+    total_sent += bytes_sent;
+    
+    bytes_sent = stats_sent(send(sockfd, msg->field8, field_size, 0), field_size);  // USER → KERNEL copy
+    if (bytes_sent < 0) return -1;
+    total_sent += bytes_sent;
+    
+    return total_sent;
+}
+
+/*
+ * send_from_twocopy: Resumable TWO-COPY send for the epoll engine
+ * Sends the rest of the field that 'offset' falls into with one send(),
+ * so every field still crosses User -> Kernel through its own syscall.
+ */
+static ssize_t send_from_twocopy(int sockfd, void *state, size_t offset) {
+    Message *msg = ((TwoCopyConn*)state)->msg;
+    char *fields[8] = {msg->field1, msg->field2, msg->field3, msg->field4,
+                       msg->field5, msg->field6, msg->field7, msg->field8};
+    size_t idx = offset / message_size;
+    size_t within = offset % message_size;
+    
+    size_t want = message_size - within;
+    return stats_sent(send(sockfd, fields[idx] + within, want, 0), want);  // USER → KERNEL copy
+}
+
+/*
+ * begin_message_twocopy: Stamps the frame header into field1 before the
+ * first byte of message 'seq' is sent (after rebuilding the message
+ * with --alloc-per-send)
+ */
+static void begin_message_twocopy(void *state, uint64_t seq) {
+    TwoCopyConn *conn = (TwoCopyConn*)state;
+    next_message(conn, seq);
+    frame_stamp(conn->msg->field1, (uint32_t)message_size * NUM_FIELDS, seq, monotonic_ns());
+    if (frame_checksum) frame_seal(conn->msg->field1, conn->crc);
+}
+
+static void* conn_open_twocopy(int sockfd) {
+    (void)sockfd;
+    TwoCopyConn *conn = malloc(sizeof(TwoCopyConn));
+    if (!conn) return NULL;
+    // Arena is owned by the connection's thread / worker
+    arena_init(&conn->arena, message_block_size(message_size));
+    conn->pool = alloc_mode == ALLOC_ARENA ? &conn->arena : NULL;
+    conn->msg = allocate_message(conn->pool, message_size);
+    if (!conn->msg) {
+        free(conn);
+        return NULL;
+    }
+    conn->built = 1;
+    seal_message(conn);
+    return conn;
+}
+
+static void conn_close_twocopy(int sockfd, void *state) {
+    (void)sockfd;
+    TwoCopyConn *conn = (TwoCopyConn*)state;
+    free_message(conn->pool, conn->msg);
+    arena_destroy(&conn->arena);
+    free(conn);
+}
+
+static void conn_report_twocopy(void *state) {
+    TwoCopyConn *conn = (TwoCopyConn*)state;
+    if (alloc_per_send) {
+        printf("[Thread %lu] Messages allocated: %ld (%s)\n", pthread_self(),
+               conn->pool ? conn->arena.allocs : conn->built, conn->pool ? "arena" : "malloc");
+    }
+}
+
+static const struct option twocopy_server_options[] = {
+    {"alloc", required_argument, 0, 'A'},
+    {"alloc-per-send", no_argument, 0, 'P'},
+    {0, 0, 0, 0}
+};
+
+static int parse_twocopy_option(int opt_char, const char *arg) {
+    switch (opt_char) {
+    case 'A':
+        if (strcmp(arg, "malloc") == 0) alloc_mode = ALLOC_MALLOC;
+        else if (strcmp(arg, "arena") == 0) alloc_mode = ALLOC_ARENA;
+        else {
+            fprintf(stderr, "Unknown allocator '%s' (expected malloc|arena)\n", arg);
+            return -1;
+        }
+        return 0;
+    case 'P':
+        alloc_per_send = 1;
+        return 0;
+    }
+    return -1;
+}
+
+static void describe_twocopy(void) {
+    printf("Allocator: %s%s\n", alloc_mode == ALLOC_ARENA ? "arena" : "malloc",
+           alloc_per_send ? ", new message per send" : ", one message per connection");
+}
+
+const ServerTransport two_copy_server = {
+    .name = "two-copy",
+    .part = "A1",
+    .title = "Two-Copy",
+    .default_port = 8080,
+    .options = twocopy_server_options,
+    .parse_option = parse_twocopy_option,
+    .usage = "[--alloc=malloc|arena] [--alloc-per-send]",
+    .describe = describe_twocopy,
+    .ops = {
+        .conn_open = conn_open_twocopy,
+        .send_from = send_from_twocopy,
+        .begin_message = begin_message_twocopy,
+        .conn_close = conn_close_twocopy,
+    },
+    .send_message = send_message_twocopy,
+    .send_error = "send error",
+    .conn_report = conn_report_twocopy,
+};
+
+const ClientTransport two_copy_client = {
+    .name = "two-copy",
+    .part = "A1",
+    .title = "Two-Copy",
+    .default_port = 8080,
+    .conn_open = recv_copy_open,
+    .receive_frame = recv_copy_frame,
+    .visit_payload = recv_copy_visit_payload,
+    .conn_close = recv_copy_close,
+};
@@ -0,0 +1,772 @@
+/*
+ * ZERO-COPY strategy (--mode=zero-copy, formerly Part A3)
+ *
+ * ZERO-COPY ARCHITECTURE:
+ * ASCII Diagram:
+ * 
+ *   User Buffer (pinned pages)
+ *        |
+ *        | (no copy - kernel references pages)
+ *        v
+ *   Kernel Socket Layer
+ *        |
+ *        | (DMA descriptor setup)
+ *        v
+ *   NIC DMA Engine ----> Network
+ *   
+ * Page Pinning: mlock() pins pages in RAM
+ * DMA: NIC reads directly from user pages
+ * Completion: MSG_ERRQUEUE notification when NIC completes TX
+ *
+ * Client: recv() copy, or TCP_ZEROCOPY_RECEIVE page mapping (--zc-recv)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <getopt.h>
+#include <errno.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/mman.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <linux/errqueue.h>
+
+#include "MT25190_Transport.h"
+#include "MT25190_BusyPoll.h"
+#include "MT25190_BufferPool.h"
+#include "MT25190_ServerStats.h"
+
+#define DEFAULT_ZC_DEPTH 16 // Default in-flight buffers per connection
+#define ZC_RECV_WINDOW (256 * 1024) // mmap()ed receive window per connection
+
+static int zc_depth = DEFAULT_ZC_DEPTH;    // K: pinned buffers in flight per connection
+static int zc_recv = 0;     // 1: map the receive queue with TCP_ZEROCOPY_RECEIVE (--zc-recv)
+
+/*
+ * In-flight buffer ring for MSG_ZEROCOPY
+ *
+ * The kernel numbers every successful MSG_ZEROCOPY send() on a socket with
+ * a 32-bit sequence id (0, 1, 2, ...). A completion on MSG_ERRQUEUE reports
+ * an inclusive id range [ee_info, ee_data] whose pages it has released.
+ *
+ *   seq_slot[id % seq_map_size] -> slot that id was sent from
+ *   seq_len/seq_ns[...]         -> its bytes and send time (accounting)
+ *   inflight[slot]              -> sends still referencing that slot
+ *
+ *   [slot 0: free][slot 1: 2 in flight][slot 2: free] ... [slot K-1]
+ *        ^ next send rewrites/reuses only a slot with inflight == 0
+ *
+ * The sender blocks (poll on the error queue) only when all K slots are busy.
+ *
+ * A completion whose ee_code has SO_EE_CODE_ZEROCOPY_COPIED set means the
+ * kernel copied the range after all (always the case on loopback, where
+ * the pages would otherwise be handed to the receiving socket). Completed
+ * ids, their bytes and the copied ones are counted per connection, so the
+ * report shows how much really went out zero-copy.
+ */
+typedef struct {
+    uint64_t sends;         // Completed MSG_ZEROCOPY sends (sequence ids)
+    uint64_t bytes;         // ... and the bytes they covered
+    uint64_t copied_sends;  // ... of which the kernel copied (SO_EE_CODE_ZEROCOPY_COPIED)
+    uint64_t copied_bytes;
+    uint64_t latency_ns;    // Sum over sends of send -> completion time
+    uint64_t max_latency_ns;
+} ZeroCopyCounts;
+
+struct ZeroCopyRing {
+    char *pool;             // K * size bytes, page-aligned and mlock()ed (--hugepages: pooled)
+    size_t size;            // Bytes per message (one slot)
+    size_t stride;          // Slot spacing, rounded up to whole pages
+    int depth;              // K
+    int *inflight;          // Per slot: outstanding zerocopy sends
+    int *seq_slot;          // Sequence id -> slot (-1 when unused)
+    size_t *seq_len;        // Sequence id -> bytes of that send
+    uint64_t *seq_ns;       // Sequence id -> send time
+    int seq_map_size;
+    uint32_t next_seq;      // Id the kernel assigns to the next zerocopy send
+    int cur_slot;           // Slot of the message being sent (-1 between messages)
+    int next_slot;          // Round-robin start for the free-slot search
+    uint64_t frame_seq;     // Sequence number stamped into the next frame (epoll engine)
+    int zerocopy;           // SO_ZEROCOPY active: sends generate completions
+    long completions;       // Completion notifications received
+    ZeroCopyCounts counts;  // Completed sends, bytes, copied fallbacks, latency
+    uint32_t crc;           // --checksum: payload CRC32C (every slot holds the same payload)
+};
+
+// Process totals of every closed ring (SERVER_METRICS)
+static ZeroCopyCounts zc_totals;
+static pthread_mutex_t zc_totals_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/*
+ * release_sequence: Maps one completed sequence id back to its slot and
+ * accounts it (completed 'now', copied by the kernel if 'copied')
+ */
+static void release_sequence(ZeroCopyRing *ring, uint32_t seq, uint64_t now, int copied) {
+    int idx = (int)(seq % (uint32_t)ring->seq_map_size);
+    int slot = ring->seq_slot[idx];
+    if (slot < 0) return;   // Already released (duplicate range)
+    ring->seq_slot[idx] = -1;
+    ring->inflight[slot]--;
+
+    ZeroCopyCounts *c = &ring->counts;
+    uint64_t latency = now - ring->seq_ns[idx];
+    c->sends++;
+    c->bytes += ring->seq_len[idx];
+    if (copied) {
+        c->copied_sends++;
+        c->copied_bytes += ring->seq_len[idx];
+    }
+    c->latency_ns += latency;
+    if (latency > c->max_latency_ns) c->max_latency_ns = latency;
+}
+
+static void add_counts(ZeroCopyCounts *sum, const ZeroCopyCounts *c) {
+    sum->sends += c->sends;
+    sum->bytes += c->bytes;
+    sum->copied_sends += c->copied_sends;
+    sum->copied_bytes += c->copied_bytes;
+    sum->latency_ns += c->latency_ns;
+    if (c->max_latency_ns > sum->max_latency_ns) sum->max_latency_ns = c->max_latency_ns;
+}
+
+/* effective_pct: Share of the completed bytes the kernel did not copy */
+static double effective_pct(const ZeroCopyCounts *c) {
+    return c->bytes ? 100.0 * (double)(c->bytes - c->copied_bytes) / (double)c->bytes : 0.0;
+}
+
+/*
+ * drain_zerocopy_completions: Drain MSG_ERRQUEUE for zerocopy completions
+ * This is CRITICAL for correct MSG_ZEROCOPY usage.
+ * After send with MSG_ZEROCOPY, the kernel keeps a reference to the buffer.
+ * Each notification's [ee_info, ee_data] range is mapped back to ring slots,
+ * which become reusable once no send references them.
+ */
+static void drain_zerocopy_completions(int sockfd, ZeroCopyRing *ring) {
+    struct msghdr msg = {0};
+    char control[128];
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    
+    // Non-blocking check for completions
+    while (1) {
+        msg.msg_controllen = sizeof(control);
+        int ret = recvmsg(sockfd, &msg, MSG_ERRQUEUE | MSG_DONTWAIT);
+        if (ret < 0) {
+            // EAGAIN: no more completions pending
+            break;
+        }
+        
+        // Parse completion notification
+        struct cmsghdr *cm = CMSG_FIRSTHDR(&msg);
+        if (cm && cm->cmsg_level == SOL_IP && cm->cmsg_type == IP_RECVERR) {
+            struct sock_extended_err *serr = (struct sock_extended_err *)CMSG_DATA(cm);
+            if (serr->ee_errno == 0 && serr->ee_origin == SO_EE_ORIGIN_ZEROCOPY) {
+                // serr->ee_info = low sequence id, serr->ee_data = high (inclusive)
+                // COPIED: the kernel fell back to copying these sends
+                uint32_t lo = serr->ee_info;
+                uint32_t hi = serr->ee_data;
+                int copied = (serr->ee_code & SO_EE_CODE_ZEROCOPY_COPIED) != 0;
+                uint64_t now = monotonic_ns();
+                for (uint32_t seq = lo; ; seq++) {
+                    release_sequence(ring, seq, now, copied);
+                    if (seq == hi) break;   // Inclusive, wrap-safe
+                }
+                ring->completions++;
+                uint64_t range = (uint64_t)(hi - lo) + 1;
+                stats_zerocopy(range, copied ? range : 0);
+            }
+        }
+    }
+}
+
+/*
+ * zerocopy_enabled: Whether SO_ZEROCOPY is active on the socket
+ * Without it MSG_ZEROCOPY is silently ignored and no completions arrive,
+ * so the ring must not wait for any.
+ */
+static int zerocopy_enabled(int sockfd) {
+    int val = 0;
+    socklen_t len = sizeof(val);
+    if (getsockopt(sockfd, SOL_SOCKET, SO_ZEROCOPY, &val, &len) < 0) return 0;
+    return val != 0;
+}
+
+/*
+ * Allocate the ring of page-pinned buffers for true zero-copy
+ * mlock() ensures pages stay in RAM and DMA-accessible; with --hugepages
+ * the ring comes from 2 MB pages, so a large ring pins a few hugepages
+ * instead of hundreds of 4 KB pages
+ */
+static ZeroCopyRing* allocate_zerocopy_ring(int sockfd, size_t size, int depth) {
+    ZeroCopyRing *ring = calloc(1, sizeof(ZeroCopyRing));
+    if (!ring) {
+        perror("Failed to allocate ZeroCopyRing");
+        return NULL;
+    }
+    ring->size = size;
+    ring->depth = depth;
+    ring->cur_slot = -1;
+    ring->zerocopy = zerocopy_enabled(sockfd);
+    // Room for several partial sends per slot before ids must be recycled
+    ring->seq_map_size = depth * 8;
+    
+    // Allocate page-aligned buffers (one page-aligned stride per slot)
+    ring->stride = (size + 4095) & ~(size_t)4095;
+    ring->pool = pool_alloc(ring->stride * depth, 4096);
+    ring->inflight = calloc(depth, sizeof(int));
+    ring->seq_slot = malloc(ring->seq_map_size * sizeof(int));
+    ring->seq_len = malloc(ring->seq_map_size * sizeof(size_t));
+    ring->seq_ns = malloc(ring->seq_map_size * sizeof(uint64_t));
+    if (!ring->pool || !ring->inflight || !ring->seq_slot || !ring->seq_len || !ring->seq_ns) {
+        perror("Failed to allocate aligned buffers");
+        pool_free(ring->pool, ring->stride * depth, 4096);
+        free(ring->inflight);
+        free(ring->seq_slot);
+        free(ring->seq_len);
+        free(ring->seq_ns);
+        free(ring);
+        return NULL;
+    }
+    for (int i = 0; i < ring->seq_map_size; i++) ring->seq_slot[i] = -1;
+    
+    // Pin pages in memory for DMA (CRITICAL for zero-copy)
+    if (mlock(ring->pool, ring->stride * depth) != 0) {
+        perror("mlock failed - zero-copy may not work");
+    }
+    
+    for (int slot = 0; slot < depth; slot++) {
+        char *buffer = ring->pool + slot * ring->stride;
+        memset(buffer, 'Z', size - 1);
+        buffer[size - 1] = '\0';
+    }
+    if (frame_checksum) ring->crc = fields_payload_crc(&ring->pool, size, size);
+    
+    return ring;
+}
+
+static char* ring_slot(ZeroCopyRing *ring, int slot) {
+    return ring->pool + slot * ring->stride;
+}
+
+/*
+ * free_zerocopy_ring: Waits (bounded) for outstanding completions so the
+ * kernel no longer references the pages, then unpins and frees them.
+ */
+static void free_zerocopy_ring(int sockfd, ZeroCopyRing *ring) {
+    if (!ring) return;
+    
+    for (int waited = 0; ring->zerocopy && waited < 10; waited++) {
+        int busy = 0;
+        for (int i = 0; i < ring->depth; i++) busy += ring->inflight[i];
+        if (!busy) break;
+        struct pollfd pfd = { .fd = sockfd, .events = 0 };
+        poll(&pfd, 1, 100);
+        drain_zerocopy_completions(sockfd, ring);
+    }
+    pthread_mutex_lock(&zc_totals_lock);
+    add_counts(&zc_totals, &ring->counts);
+    pthread_mutex_unlock(&zc_totals_lock);
+    
+    // Pooled rings share hugepages with other connections and stay pinned for reuse
+    if (!buffer_pool_enabled()) munlock(ring->pool, ring->stride * ring->depth);
+    pool_free(ring->pool, ring->stride * ring->depth, 4096);
+    free(ring->inflight);
+    free(ring->seq_slot);
+    free(ring->seq_len);
+    free(ring->seq_ns);
+    free(ring);
+}
+
+/*
+ * acquire_slot: Picks a slot no in-flight send references
+ * Returns the slot index, or -1 if every slot (or every sequence-map entry)
+ * is still in flight.
+ */
+static int acquire_slot(ZeroCopyRing *ring) {
+    if (!ring->zerocopy) return 0;  // Copying fallback: buffer reuse is always safe
+    if (ring->seq_slot[ring->next_seq % (uint32_t)ring->seq_map_size] >= 0) return -1;
+    
+    for (int i = 0; i < ring->depth; i++) {
+        int slot = (ring->next_slot + i) % ring->depth;
+        if (ring->inflight[slot] == 0) {
+            ring->next_slot = (slot + 1) % ring->depth;
+            return slot;
+        }
+    }
+    return -1;
+}
+
+/*
+ * send_ring_slot: One send() of slot bytes [offset, len) with MSG_ZEROCOPY
+ * Records the kernel's sequence id for the send so its completion can be
+ * mapped back to the slot.
+ */
+static ssize_t send_ring_slot(int sockfd, ZeroCopyRing *ring, int slot, size_t offset,
+                              size_t len) {
+    int idx = (int)(ring->next_seq % (uint32_t)ring->seq_map_size);
+    if (ring->zerocopy && ring->seq_slot[idx] >= 0) {
+        errno = ENOBUFS;    // Sequence map full: wait for completions
+        return -1;
+    }
+    
+    ssize_t sent = stats_sent(send(sockfd, ring_slot(ring, slot) + offset, len - offset,
+                                   MSG_ZEROCOPY), len - offset);
+    if (sent > 0 && ring->zerocopy) {
+        // Every successful MSG_ZEROCOPY send consumes exactly one id
+        ring->seq_slot[idx] = slot;
+        ring->seq_len[idx] = (size_t)sent;
+        ring->seq_ns[idx] = monotonic_ns();
+        ring->inflight[slot]++;
+        ring->next_seq++;
+    }
+    return sent;
+}
+
+/*
+ * wait_for_completion: Blocks until the error queue has notifications
+ * (POLLERR) or 100ms pass, then drains it.
+ */
+static void wait_for_completion(int sockfd, ZeroCopyRing *ring) {
+    struct pollfd pfd = { .fd = sockfd, .events = 0 };
+    poll(&pfd, 1, 100);
+    drain_zerocopy_completions(sockfd, ring);
+}
+
+/*
+ * acquire_free_slot: Blocks until a slot is free (or shutdown)
+ * Completions are harvested first so freed slots are visible; the sender
+ * only waits when all K slots are still referenced by the kernel.
+ * Returns the slot, or -1 with errno = EINTR on shutdown.
+ */
+static int acquire_free_slot(int sockfd, ZeroCopyRing *ring) {
+    if (ring->zerocopy) drain_zerocopy_completions(sockfd, ring);
+    
+    int slot;
+    while ((slot = acquire_slot(ring)) < 0) {
+        if (!running) {
+            errno = EINTR;
+            return -1;
+        }
+        wait_for_completion(sockfd, ring);
+    }
+    return slot;
+}
+
+/*
+ * send_zerocopy_slot: Sends the first 'len' bytes of 'slot' with MSG_ZEROCOPY
+ */
+static int send_zerocopy_slot(int sockfd, ZeroCopyRing *ring, int slot, size_t len) {
+    size_t offset = 0;
+    while (offset < len) {
+        ssize_t sent = send_ring_slot(sockfd, ring, slot, offset, len);
+        if (sent < 0) {
+            if (errno == EINTR && running) continue;
+            if (errno == ENOBUFS && running) {
+                wait_for_completion(sockfd, ring);
+                continue;
+            }
+            return -1;
+        }
+        offset += sent;
+    }
+    
+    return (int)offset;
+}
+
+/*
+ * prepare_zerocopy: Reserves a free pinned slot for the next message
+ * before the request arrives (ping-pong) or the send time is taken, so a
+ * full ring never delays the reply or inflates its latency
+ */
+static int prepare_zerocopy(int sockfd, void *state) {
+    ZeroCopyRing *ring = (ZeroCopyRing*)state;
+    if (ring->cur_slot < 0) ring->cur_slot = acquire_free_slot(sockfd, ring);
+    return ring->cur_slot < 0 ? -1 : 0;
+}
+
+/*
+ * Send with MSG_ZEROCOPY flag
+ * Kernel sets up DMA descriptors, NIC reads directly from user buffer
+ * Completion notification via MSG_ERRQUEUE
+ * Each message goes out of a free ring slot; the sender only blocks when
+ * all K slots are still referenced by the kernel.
+ */
+static int send_zerocopy(int sockfd, void *state, uint64_t seq, uint64_t send_ns) {
+    ZeroCopyRing *ring = (ZeroCopyRing*)state;
+    if (prepare_zerocopy(sockfd, ring) < 0) return -1;
+    int slot = ring->cur_slot;
+    ring->cur_slot = -1;
+    // The slot is no longer referenced by the kernel, so rewriting its
+    // header cannot corrupt a transmission still in flight
+    frame_stamp(ring_slot(ring, slot), (uint32_t)ring->size, seq, send_ns);
+    if (frame_checksum) frame_seal(ring_slot(ring, slot), ring->crc);
+    return send_zerocopy_slot(sockfd, ring, slot, ring->size);
+}
+
+/*
+ * send_from_zerocopy: Resumable MSG_ZEROCOPY send for the epoll engine
+ * A new message (offset 0) claims a free ring slot and stamps its frame
+ * header; the rest of a partially sent message continues from the same slot. When no slot is free it
+ * returns ENOBUFS so the event loop parks the socket until the error queue
+ * delivers completions.
+ */
+static ssize_t send_from_zerocopy(int sockfd, void *state, size_t offset) {
+    ZeroCopyRing *ring = (ZeroCopyRing*)state;
+    
+    if (offset == 0 || ring->cur_slot < 0) {
+        ring->cur_slot = acquire_slot(ring);
+        if (ring->cur_slot < 0) {
+            errno = ENOBUFS;
+            return -1;
+        }
+        frame_stamp(ring_slot(ring, ring->cur_slot), (uint32_t)ring->size,
+                    ring->frame_seq++, monotonic_ns());
+        if (frame_checksum) frame_seal(ring_slot(ring, ring->cur_slot), ring->crc);
+    }
+    
+    ssize_t sent = send_ring_slot(sockfd, ring, ring->cur_slot, offset, ring->size);
+    if (sent > 0 && offset + (size_t)sent >= ring->size) {
+        ring->cur_slot = -1;    // Message complete: next send claims a new slot
+    }
+    return sent;
+}
+
+static void* conn_open_zerocopy(int sockfd) {
+    return zc_ring_open(sockfd, (size_t)message_size * NUM_FIELDS, zc_depth);
+}
+
+static void drain_errqueue_zerocopy(int sockfd, void *state) {
+    drain_zerocopy_completions(sockfd, (ZeroCopyRing*)state);
+}
+
+static void conn_close_zerocopy(int sockfd, void *state) {
+    free_zerocopy_ring(sockfd, (ZeroCopyRing*)state);
+}
+
+static void conn_report_zerocopy(void *state) {
+    ZeroCopyRing *ring = (ZeroCopyRing*)state;
+    char summary[256];
+    zc_ring_format(ring, summary, sizeof(summary));
+    printf("[Thread %lu] Ring depth %d, %s\n", pthread_self(), ring->depth, summary);
+}
+
+/*
+ * Ring API for other strategies (see MT25190_Transport.h)
+ */
+ZeroCopyRing* zc_ring_open(int sockfd, size_t size, int depth) {
+    // Enable zero-copy on the connected socket
+    int zerocopy = 1;
+    if (setsockopt(sockfd, SOL_SOCKET, SO_ZEROCOPY, &zerocopy, sizeof(zerocopy)) < 0) {
+        perror("SO_ZEROCOPY not supported on client socket - using fallback");
+    }
+    return allocate_zerocopy_ring(sockfd, size, depth);
+}
+
+char* zc_ring_claim(int sockfd, ZeroCopyRing *ring, int block) {
+    if (ring->cur_slot < 0) {
+        if (block) {
+            if (prepare_zerocopy(sockfd, ring) < 0) return NULL;
+        } else if ((ring->cur_slot = acquire_slot(ring)) < 0) {
+            errno = ENOBUFS;
+            return NULL;
+        }
+    }
+    return ring_slot(ring, ring->cur_slot);
+}
+
+int zc_ring_send(int sockfd, ZeroCopyRing *ring, size_t len) {
+    int slot = ring->cur_slot;
+    ring->cur_slot = -1;
+    return send_zerocopy_slot(sockfd, ring, slot, len);
+}
+
+ssize_t zc_ring_send_from(int sockfd, ZeroCopyRing *ring, size_t offset, size_t len) {
+    ssize_t sent = send_ring_slot(sockfd, ring, ring->cur_slot, offset, len);
+    if (sent > 0 && offset + (size_t)sent >= len) ring->cur_slot = -1;
+    return sent;
+}
+
+void zc_ring_drain(int sockfd, ZeroCopyRing *ring) {
+    drain_zerocopy_completions(sockfd, ring);
+}
+
+void zc_ring_close(int sockfd, ZeroCopyRing *ring) {
+    free_zerocopy_ring(sockfd, ring);
+}
+
+int zc_ring_format(const ZeroCopyRing *ring, char *buf, size_t len) {
+    const ZeroCopyCounts *c = &ring->counts;
+    if (!ring->zerocopy) return snprintf(buf, len, "SO_ZEROCOPY off: every send copied");
+    return snprintf(buf, len,
+                    "completions %ld for %lu sends (%.1f MB), copied %lu (%.1f MB): "
+                    "%.1f%% zero-copy, completion latency avg %.1f us, max %.1f us",
+                    ring->completions, (unsigned long)c->sends, c->bytes / 1e6,
+                    (unsigned long)c->copied_sends, c->copied_bytes / 1e6, effective_pct(c),
+                    c->sends ? c->latency_ns / 1e3 / c->sends : 0.0, c->max_latency_ns / 1e3);
+}
+
+int zc_format_metrics(char *buf, size_t len) {
+    pthread_mutex_lock(&zc_totals_lock);
+    ZeroCopyCounts c = zc_totals;
+    pthread_mutex_unlock(&zc_totals_lock);
+    return snprintf(buf, len,
+                    "zc_sends=%lu zc_copied=%lu zc_bytes=%lu zc_copied_bytes=%lu "
+                    "zc_effective_pct=%.1f zc_completion_us=%.1f zc_completion_max_us=%.1f",
+                    (unsigned long)c.sends, (unsigned long)c.copied_sends,
+                    (unsigned long)c.bytes, (unsigned long)c.copied_bytes, effective_pct(&c),
+                    c.sends ? c.latency_ns / 1e3 / c.sends : 0.0, c.max_latency_ns / 1e3);
+}
+
+void zc_reset_metrics(void) {
+    pthread_mutex_lock(&zc_totals_lock);
+    memset(&zc_totals, 0, sizeof(zc_totals));
+    pthread_mutex_unlock(&zc_totals_lock);
+}
+
+static const struct option zerocopy_server_options[] = {
+    {"depth",   required_argument, 0, 'd'},
+    {"hugepages", optional_argument, 0, 'H'},
+    {0, 0, 0, 0}
+};
+
+static int parse_zerocopy_server_option(int opt_char, const char *arg) {
+    switch (opt_char) {
+    case 'd':
+        zc_depth = atoi(arg);
+        if (zc_depth < 1) zc_depth = 1;
+        return 0;
+    case 'H':
+        return buffer_pool_configure(arg);
+    }
+    return -1;
+}
+
+static void describe_zerocopy_server(void) {
+    printf("Hugepage buffer pool: %s\n", buffer_pool_name());
+    printf("Using MSG_ZEROCOPY with page pinning (%d in-flight buffers per connection)\n",
+           zc_depth);
+}
+
+const ServerTransport zero_copy_server = {
+    .name = "zero-copy",
+    .part = "A3",
+    .title = "Zero-Copy",
+    .default_port = 8082,
+    .options = zerocopy_server_options,
+    .parse_option = parse_zerocopy_server_option,
+    .usage = "[--depth=K] [--hugepages[=huge|thp|off]]",
+    .describe = describe_zerocopy_server,
+    .ops = {
+        .conn_open = conn_open_zerocopy,
+        .send_from = send_from_zerocopy,
+        .drain_errqueue = drain_errqueue_zerocopy,
+        .conn_close = conn_close_zerocopy,
+    },
+    .prepare_message = prepare_zerocopy,
+    .send_message = send_zerocopy,
+    .send_error = "zerocopy send error",
+    .conn_report = conn_report_zerocopy,
+    .format_metrics = zc_format_metrics,
+};
+
+/*
+ * Receive-side zero copy (TCP_ZEROCOPY_RECEIVE)
+ *
+ *   Socket receive queue:  [ page | page | page | tail < page ]
+ *                              |      |      |         |
+ *           getsockopt() remaps    v      v      v         | recv_skip_hint
+ *           the pages into:    [ mmap()ed window    ]      v
+ *                                                      recv() copy into copybuf
+ *
+ * Whole, page-aligned payload pages are mapped into a read-only window
+ * created by mmap() on the socket itself, so the data is never copied to
+ * user space. Whatever the kernel cannot map (sub-page tails, unaligned
+ * skb data) is reported in recv_skip_hint and read with an ordinary copy.
+ * Frames are parsed in place from either source with frame_consume().
+ */
+typedef struct {
+    char *window;           // mmap() of the socket (PROT_READ, MAP_SHARED)
+    char *copybuf;          // Fallback copy destination
+    size_t copybuf_len;
+    const char *pending;    // Unparsed bytes of the last mapping/copy
+    size_t pending_len;
+    int disabled;           // Kernel refused zerocopy receive: copy everything
+    long mapped;
+    long copied;
+} ZeroCopyReceiver;
+
+/*
+ * zc_receiver_open: Maps the receive window; on failure the receiver
+ * falls back to plain recv() copies so the run still completes.
+ * The copy buffer only catches what cannot be mapped.
+ */
+static void* zc_receiver_open(int sockfd, size_t frame_bytes) {
+    if (!zc_recv) return recv_copy_open(sockfd, frame_bytes);
+    
+    ZeroCopyReceiver *zr = calloc(1, sizeof(ZeroCopyReceiver));
+    if (!zr) {
+        perror("Failed to allocate buffer");
+        return NULL;
+    }
+    zr->copybuf = recv_copy_open(sockfd, frame_bytes);
+    if (!zr->copybuf) {
+        free(zr);
+        return NULL;
+    }
+    zr->copybuf_len = frame_bytes;
+    zr->window = mmap(NULL, ZC_RECV_WINDOW, PROT_READ, MAP_SHARED, sockfd, 0);
+    if (zr->window == MAP_FAILED) {
+        perror("mmap of TCP receive queue failed - copying instead");
+        zr->window = NULL;
+        zr->disabled = 1;
+    }
+    return zr;
+}
+
+static void zc_receiver_close(void *state) {
+    if (!zc_recv) {
+        recv_copy_close(state);
+        return;
+    }
+    ZeroCopyReceiver *zr = (ZeroCopyReceiver*)state;
+    if (zr->window) munmap(zr->window, ZC_RECV_WINDOW);
+    recv_copy_close(zr->copybuf);
+    free(zr);
+}
+
+/*
+ * zc_copy: Reads up to 'len' bytes with a normal recv() copy
+ * Returns 1 with the bytes pending, 0 on EOF, -1 on error.
+ */
+static int zc_copy(int sockfd, ZeroCopyReceiver *zr, size_t len, int flags) {
+    if (len > zr->copybuf_len) len = zr->copybuf_len;
+    ssize_t n = recv_spin(sockfd, zr->copybuf, len, flags, busy_poll_usec >= 0);
+    if (n < 0) return (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK) ? 1 : -1;
+    if (n == 0) return 0;
+    zr->pending = zr->copybuf;
+    zr->pending_len = (size_t)n;
+    zr->copied += n;
+    return 1;
+}
+
+/*
+ * zc_refill: Maps as many whole pages of the receive queue as possible,
+ * copies what cannot be mapped, or waits for data.
+ * Returns 1 (possibly with nothing pending yet), 0 on EOF, -1 on error.
+ */
+static int zc_refill(int sockfd, ZeroCopyReceiver *zr) {
+    if (zr->disabled) return zc_copy(sockfd, zr, zr->copybuf_len, 0);
+    
+    // Mapping over the window also unmaps the pages of the previous call
+    struct tcp_zerocopy_receive zc;
+    memset(&zc, 0, sizeof(zc));
+    zc.address = (uint64_t)(uintptr_t)zr->window;
+    zc.length = ZC_RECV_WINDOW;
+    socklen_t zc_len = sizeof(zc);
+    if (getsockopt(sockfd, IPPROTO_TCP, TCP_ZEROCOPY_RECEIVE, &zc, &zc_len) < 0) {
+        if (errno == EINTR || errno == EAGAIN) return 1;
+        perror("TCP_ZEROCOPY_RECEIVE failed - copying instead");
+        zr->disabled = 1;
+        return zc_copy(sockfd, zr, zr->copybuf_len, 0);
+    }
+    
+    if (zc.length > 0) {
+        zr->pending = zr->window;
+        zr->pending_len = zc.length;
+        zr->mapped += zc.length;
+        return 1;
+    }
+    if (zc.recv_skip_hint > 0) return zc_copy(sockfd, zr, zc.recv_skip_hint, 0);
+    
+    // Queue empty: block until readable (busy-poll: just retry), then tell
+    // EOF apart from new data
+    if (busy_poll_usec < 0) {
+        struct pollfd pfd = { .fd = sockfd, .events = POLLIN };
+        if (poll(&pfd, 1, -1) < 0 && errno != EINTR) return -1;
+    } else {
+        cpu_relax();
+    }
+    char probe;
+    ssize_t n = recv(sockfd, &probe, 1, MSG_PEEK | MSG_DONTWAIT);
+    if (n == 0) return 0;
+    if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) return -1;
+    return 1;
+}
+
+/*
+ * receive_frame_zerocopy: Completes one frame from mapped/copied stream bytes
+ * (plain recv() copy without --zc-recv)
+ */
+static ssize_t receive_frame_zerocopy(int sockfd, void *state, FrameAssembler *fa) {
+    if (!zc_recv) return recv_copy_frame(sockfd, state, fa);
+    
+    ZeroCopyReceiver *zr = (ZeroCopyReceiver*)state;
+    while (1) {
+        while (zr->pending_len > 0) {
+            int status;
+            size_t used = frame_consume(fa, zr->pending, zr->pending_len, &status);
+            zr->pending += used;
+            zr->pending_len -= used;
+            if (status == FRAME_COMPLETE) return 1;
+            if (status == FRAME_INVALID) {
+                errno = EPROTO;     // Stream desynchronised (e.g. message_size mismatch)
+                return -1;
+            }
+        }
+        int r = zc_refill(sockfd, zr);
+        if (r <= 0) return r;
+    }
+}
+
+/* zc_rx_counters: Mapped vs copied bytes (without --zc-recv recv() copied it all) */
+static int zc_rx_counters(void *state, long *mapped, long *copied) {
+    if (!zc_recv) return 0;
+    ZeroCopyReceiver *zr = (ZeroCopyReceiver*)state;
+    *mapped = zr->mapped;
+    *copied = zr->copied;
+    return 1;
+}
+
+/*
+ * zc_visit_payload: --zc-recv frames were handed to fa->sink piece by piece
+ * as frame_consume() parsed the mapped pages (they are unmapped by now)
+ */
+static int zc_visit_payload(void *state, const FrameAssembler *fa, PayloadSink sink, void *ctx) {
+    if (!zc_recv) return recv_copy_visit_payload(state, fa, sink, ctx);
+    return 0;
+}
+
+static const struct option zerocopy_client_options[] = {
+    {"zc-recv",  no_argument, 0, 'z'},
+    {0, 0, 0, 0}
+};
+
+static int parse_zerocopy_client_option(int opt_char, const char *arg) {
+    (void)arg;
+    if (opt_char != 'z') return -1;
+    zc_recv = 1;
+    return 0;
+}
+
+static void describe_zerocopy_client(void) {
+    printf("Receive: %s\n", zc_recv ? "TCP_ZEROCOPY_RECEIVE (mmap, copy fallback)" : "recv() copy");
+}
+
+const ClientTransport zero_copy_client = {
+    .name = "zero-copy",
+    .part = "A3",
+    .title = "Zero-Copy",
+    .default_port = 8082,
+    .options = zerocopy_client_options,
+    .parse_option = parse_zerocopy_client_option,
+    .usage = "[--zc-recv]",
+    .describe = describe_zerocopy_client,
+    .conn_open = zc_receiver_open,
+    .receive_frame = receive_frame_zerocopy,
+    .rx_counters = zc_rx_counters,
+    .visit_payload = zc_visit_payload,
+    .conn_close = zc_receiver_close,
+};
@@ -0,0 +1,173 @@
+/*
+ * Minimal io_uring wrapper (raw syscalls). See MT25190_Uring.h.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#include "MT25190_Uring.h"
+
+static int sys_io_uring_setup(unsigned entries, struct io_uring_params *p) {
+    return (int)syscall(__NR_io_uring_setup, entries, p);
+}
+
+static int sys_io_uring_enter(int fd, unsigned to_submit, unsigned min_complete,
+                              unsigned flags) {
+    return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, NULL, 0);
+}
+
+static int sys_io_uring_register(int fd, unsigned opcode, const void *arg, unsigned nr_args) {
+    return (int)syscall(__NR_io_uring_register, fd, opcode, arg, nr_args);
+}
+
+int uring_init(Uring *ring, unsigned entries) {
+    struct io_uring_params params;
+    memset(ring, 0, sizeof(*ring));
+    memset(&params, 0, sizeof(params));
+
+    ring->ring_fd = sys_io_uring_setup(entries, &params);
+    if (ring->ring_fd < 0) return -1;
+
+    // Map SQ and CQ rings (a single mapping when the kernel supports it)
+    ring->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        if (ring->cq_ring_size > ring->sq_ring_size) ring->sq_ring_size = ring->cq_ring_size;
+        ring->cq_ring_size = ring->sq_ring_size;
+    }
+
+    ring->sq_ring_ptr = mmap(NULL, ring->sq_ring_size, PROT_READ | PROT_WRITE,
+                             MAP_SHARED | MAP_POPULATE, ring->ring_fd, IORING_OFF_SQ_RING);
+    if (ring->sq_ring_ptr == MAP_FAILED) goto fail;
+
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        ring->cq_ring_ptr = ring->sq_ring_ptr;
+    } else {
+        ring->cq_ring_ptr = mmap(NULL, ring->cq_ring_size, PROT_READ | PROT_WRITE,
+                                 MAP_SHARED | MAP_POPULATE, ring->ring_fd, IORING_OFF_CQ_RING);
+        if (ring->cq_ring_ptr == MAP_FAILED) goto fail_sq;
+    }
+
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, ring->ring_fd, IORING_OFF_SQES);
+    if (ring->sqes == MAP_FAILED) goto fail_cq;
+
+    char *sq = (char*)ring->sq_ring_ptr;
+    ring->sq_head = (unsigned*)(sq + params.sq_off.head);
+    ring->sq_tail = (unsigned*)(sq + params.sq_off.tail);
+    ring->sq_mask = (unsigned*)(sq + params.sq_off.ring_mask);
+    ring->sq_array = (unsigned*)(sq + params.sq_off.array);
+    ring->sq_entries = params.sq_entries;
+    ring->sqe_tail = *ring->sq_tail;
+
+    char *cq = (char*)ring->cq_ring_ptr;
+    ring->cq_head = (unsigned*)(cq + params.cq_off.head);
+    ring->cq_tail = (unsigned*)(cq + params.cq_off.tail);
+    ring->cq_mask = (unsigned*)(cq + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+    return 0;
+
+fail_cq:
+    if (ring->cq_ring_ptr != ring->sq_ring_ptr) munmap(ring->cq_ring_ptr, ring->cq_ring_size);
+fail_sq:
+    munmap(ring->sq_ring_ptr, ring->sq_ring_size);
+fail:
+    close(ring->ring_fd);
+    return -1;
+}
+
+void uring_exit(Uring *ring) {
+    munmap(ring->sqes, ring->sqes_size);
+    if (ring->cq_ring_ptr != ring->sq_ring_ptr) munmap(ring->cq_ring_ptr, ring->cq_ring_size);
+    munmap(ring->sq_ring_ptr, ring->sq_ring_size);
+    close(ring->ring_fd);
+}
+
+struct io_uring_sqe* uring_get_sqe(Uring *ring) {
+    unsigned head = __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+    if (ring->sqe_tail - head >= ring->sq_entries) return NULL;
+
+    unsigned idx = ring->sqe_tail & *ring->sq_mask;
+    struct io_uring_sqe *sqe = &ring->sqes[idx];
+    ring->sq_array[idx] = idx;
+    ring->sqe_tail++;
+    memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+}
+
+unsigned uring_sq_space(Uring *ring) {
+    unsigned head = __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+    return ring->sq_entries - (ring->sqe_tail - head);
+}
+
+int uring_submit_and_wait(Uring *ring, unsigned wait_nr) {
+    // Everything the kernel has not consumed yet, including SQEs left over
+    // from an earlier interrupted enter
+    unsigned to_submit = ring->sqe_tail - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+
+    // Publish the new tail so the kernel sees every SQE prepared since last time
+    __atomic_store_n(ring->sq_tail, ring->sqe_tail, __ATOMIC_RELEASE);
+
+    // EINTR is returned to the caller so it can observe a shutdown signal
+    unsigned flags = wait_nr ? IORING_ENTER_GETEVENTS : 0;
+    return sys_io_uring_enter(ring->ring_fd, to_submit, wait_nr, flags);
+}
+
+struct io_uring_cqe* uring_peek_cqe(Uring *ring) {
+    unsigned head = *ring->cq_head;
+    unsigned tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+    if (head == tail) return NULL;
+    return &ring->cqes[head & *ring->cq_mask];
+}
+
+void uring_cqe_seen(Uring *ring) {
+    __atomic_store_n(ring->cq_head, *ring->cq_head + 1, __ATOMIC_RELEASE);
+}
+
+int uring_register_buffers(Uring *ring, const struct iovec *iov, unsigned nr) {
+    return sys_io_uring_register(ring->ring_fd, IORING_REGISTER_BUFFERS, iov, nr);
+}
+
+int uring_buf_ring_setup(Uring *ring, UringBufRing *bufs, unsigned entries, unsigned short bgid) {
+    memset(bufs, 0, sizeof(*bufs));
+    size_t size = ((size_t)entries * sizeof(struct io_uring_buf) + 4095) & ~(size_t)4095;
+    bufs->br = aligned_alloc(4096, size);
+    if (!bufs->br) return -1;
+    memset(bufs->br, 0, size);
+    bufs->mask = entries - 1;
+    bufs->bgid = bgid;
+
+    struct io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = (unsigned long)bufs->br;
+    reg.ring_entries = entries;
+    reg.bgid = bgid;
+    if (sys_io_uring_register(ring->ring_fd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+        free(bufs->br);
+        bufs->br = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+void uring_buf_ring_add(UringBufRing *bufs, void *addr, unsigned len, unsigned short bid) {
+    struct io_uring_buf *buf = &bufs->br->bufs[bufs->tail & bufs->mask];
+    buf->addr = (unsigned long)addr;
+    buf->len = len;
+    buf->bid = bid;
+    bufs->tail++;
+}
+
+void uring_buf_ring_publish(UringBufRing *bufs) {
+    __atomic_store_n(&bufs->br->tail, bufs->tail, __ATOMIC_RELEASE);
+}
+
+void uring_buf_ring_free(UringBufRing *bufs) {
+    free(bufs->br);
+    bufs->br = NULL;
+}
@@ -0,0 +1,107 @@
+/*
+ * Minimal io_uring wrapper used by the A4 server and client.
+ *
+ * Talks to the kernel through the raw io_uring_setup/enter/register
+ * syscalls (no liburing dependency), exposing just what A4 needs:
+ * - SQE allocation and batched submission (one io_uring_enter per batch)
+ * - CQE reaping from the shared completion ring
+ * - Registered (fixed) buffers, which the kernel pins once at registration
+ *   instead of per I/O
+ * - Provided buffer rings, from which multishot receives pick their buffers
+ */
+
+#ifndef MT25190_URING_H
+#define MT25190_URING_H
+
+#include <stddef.h>
+#include <linux/io_uring.h>
+#include <sys/uio.h>
+
+typedef struct {
+    int ring_fd;
+
+    /* Submission queue (shared with kernel) */
+    unsigned *sq_head;
+    unsigned *sq_tail;
+    unsigned *sq_mask;
+    unsigned *sq_array;
+    struct io_uring_sqe *sqes;
+    unsigned sq_entries;
+    unsigned sqe_tail;      // Local tail: SQEs prepared but not yet published
+
+    /* Completion queue (shared with kernel) */
+    unsigned *cq_head;
+    unsigned *cq_tail;
+    unsigned *cq_mask;
+    struct io_uring_cqe *cqes;
+
+    /* mmap bookkeeping for teardown */
+    void *sq_ring_ptr;
+    size_t sq_ring_size;
+    void *cq_ring_ptr;
+    size_t cq_ring_size;
+    size_t sqes_size;
+} Uring;
+
+/*
+ * uring_init: Creates a ring with 'entries' SQ slots and maps it.
+ * Returns 0 on success, -1 with errno set on failure.
+ */
+int uring_init(Uring *ring, unsigned entries);
+
+void uring_exit(Uring *ring);
+
+/*
+ * uring_get_sqe: Returns a zeroed SQE to fill in, or NULL if the SQ is full
+ */
+struct io_uring_sqe* uring_get_sqe(Uring *ring);
+
+/* uring_sq_space: SQEs uring_get_sqe() can still hand out before a submit */
+unsigned uring_sq_space(Uring *ring);
+
+/*
+ * uring_submit_and_wait: Publishes all prepared SQEs and submits them with a
+ * single io_uring_enter(), waiting for at least 'wait_nr' completions.
+ * Returns the number of SQEs consumed, or -1 with errno set (EINTR when a
+ * signal interrupted the wait).
+ */
+int uring_submit_and_wait(Uring *ring, unsigned wait_nr);
+
+/*
+ * uring_peek_cqe: Returns the next completion or NULL if none is pending.
+ * uring_cqe_seen() must be called once the CQE has been processed.
+ */
+struct io_uring_cqe* uring_peek_cqe(Uring *ring);
+void uring_cqe_seen(Uring *ring);
+
+/*
+ * uring_register_buffers: Registers 'nr' buffers as fixed buffers 0..nr-1.
+ * Returns 0 on success, -1 with errno set.
+ */
+int uring_register_buffers(Uring *ring, const struct iovec *iov, unsigned nr);
+
+/*
+ * Provided buffer ring (IORING_REGISTER_PBUF_RING): the application adds
+ * buffers at the tail, and a receive with IOSQE_BUFFER_SELECT takes the
+ * next one; its CQE carries the buffer id (flags >> IORING_CQE_BUFFER_SHIFT).
+ */
+typedef struct {
+    struct io_uring_buf_ring *br;
+    unsigned mask;
+    unsigned short tail;    // Local tail: buffers added but not yet published
+    unsigned short bgid;
+} UringBufRing;
+
+/*
+ * uring_buf_ring_setup: Allocates and registers an empty ring of 'entries'
+ * (a power of two) buffer slots as buffer group 'bgid'.
+ * Returns 0 on success, -1 with errno set. Free it after uring_exit().
+ */
+int uring_buf_ring_setup(Uring *ring, UringBufRing *bufs, unsigned entries, unsigned short bgid);
+
+/* uring_buf_ring_add: Queues a buffer; the kernel sees it after publish */
+void uring_buf_ring_add(UringBufRing *bufs, void *addr, unsigned len, unsigned short bid);
+void uring_buf_ring_publish(UringBufRing *bufs);
+void uring_buf_ring_free(UringBufRing *bufs);
+
+#endif /* MT25190_URING_H */